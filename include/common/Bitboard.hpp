@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "common/CommonTypes.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace game {
+
+    // Portable bit helpers
+    namespace bits {
+
+        inline int popcount(std::uint64_t word) {
+#if defined(_MSC_VER) && defined(_M_X64)
+            return static_cast<int>(__popcnt64(word));
+#elif defined(__GNUC__) || defined(__clang__)
+            return __builtin_popcountll(word);
+#else
+            int count = 0;
+            for (; word != 0; word &= word - 1) ++count;
+            return count;
+#endif
+        }
+
+        // Index of the lowest set bit; word must be non-zero
+        inline int ctz(std::uint64_t word) {
+#if defined(_MSC_VER) && defined(_M_X64)
+            unsigned long index;
+            _BitScanForward64(&index, word);
+            return static_cast<int>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+            return __builtin_ctzll(word);
+#else
+            int index = 0;
+            while ((word & 1u) == 0) { word >>= 1; ++index; }
+            return index;
+#endif
+        }
+
+        // Bits [from, to) of a 64-bit word, 0 <= from <= to <= 64
+        inline std::uint64_t range(int from, int to) {
+            const std::uint64_t high = (to >= 64) ? ~std::uint64_t{0} : ((std::uint64_t{1} << to) - 1);
+            const std::uint64_t low = (std::uint64_t{1} << from) - 1;
+            return high & ~low;
+        }
+
+    }
+
+    // One bit per tile, each row padded to whole 64-bit words:
+    // bit (x & 63) of word [y * wordsPerRow() + (x >> 6)].
+    // Counts, rectangle queries and iteration work a word at a time.
+    class TileBitboard {
+    public:
+        void assign(int width, int height) {
+            w = (width > 0 && height > 0) ? width : 0;
+            h = (width > 0 && height > 0) ? height : 0;
+            stride = (w + 63) / 64;
+            words.assign(static_cast<std::size_t>(stride) * static_cast<std::size_t>(h), 0);
+        }
+
+        // Set every tile of the grid whose code equals `code`
+        void build(const MapGrid& grid, std::uint8_t code) {
+            assign(grid.width(), grid.height());
+            for (int y = 0; y < h; ++y) {
+                const std::uint8_t* cells = grid.row(y);
+                std::uint64_t* row = rowWords(y);
+                for (int x = 0; x < w; ++x) {
+                    row[x >> 6] |= std::uint64_t{cells[x] == code} << (x & 63);
+                }
+            }
+        }
+
+        int width() const { return w; }
+        int height() const { return h; }
+        int wordsPerRow() const { return stride; }
+
+        // Unchecked; callers test the grid bounds first
+        bool test(int x, int y) const { return (words[wordIndex(x, y)] >> (x & 63)) & 1u; }
+        void set(int x, int y) { words[wordIndex(x, y)] |= std::uint64_t{1} << (x & 63); }
+        void clear(int x, int y) { words[wordIndex(x, y)] &= ~(std::uint64_t{1} << (x & 63)); }
+
+        int count() const {
+            int total = 0;
+            for (std::uint64_t word : words) total += bits::popcount(word);
+            return total;
+        }
+
+        bool any() const {
+            for (std::uint64_t word : words) {
+                if (word != 0) return true;
+            }
+            return false;
+        }
+
+        // Set tiles inside the inclusive rectangle [x0, x1] x [y0, y1], clipped to the board
+        int countInRect(int x0, int y0, int x1, int y1) const {
+            int total = 0;
+            scanRect(x0, y0, x1, y1, [&](std::uint64_t bitsInWord) {
+                total += bits::popcount(bitsInWord);
+                return true;
+            });
+            return total;
+        }
+
+        bool anyInRect(int x0, int y0, int x1, int y1) const {
+            bool found = false;
+            scanRect(x0, y0, x1, y1, [&](std::uint64_t bitsInWord) {
+                found = bitsInWord != 0;
+                return !found;
+            });
+            return found;
+        }
+
+        // Call fn(x, y) for every set tile in row-major order
+        template <typename Fn>
+        void forEach(Fn&& fn) const {
+            for (int y = 0; y < h; ++y) {
+                const std::uint64_t* row = rowWords(y);
+                for (int i = 0; i < stride; ++i) {
+                    for (std::uint64_t word = row[i]; word != 0; word &= word - 1) {
+                        fn((i << 6) + bits::ctz(word), y);
+                    }
+                }
+            }
+        }
+
+        const std::uint64_t* rowWords(int y) const { return words.data() + static_cast<std::size_t>(y) * stride; }
+        std::uint64_t* rowWords(int y) { return words.data() + static_cast<std::size_t>(y) * stride; }
+
+    private:
+        std::size_t wordIndex(int x, int y) const { return static_cast<std::size_t>(y) * stride + (x >> 6); }
+
+        // Feed the masked words covering a rectangle to fn; fn returns false to stop
+        template <typename Fn>
+        void scanRect(int x0, int y0, int x1, int y1, Fn&& fn) const {
+            if (x0 < 0) x0 = 0;
+            if (y0 < 0) y0 = 0;
+            if (x1 >= w) x1 = w - 1;
+            if (y1 >= h) y1 = h - 1;
+            if (x0 > x1 || y0 > y1) return;
+
+            const int firstWord = x0 >> 6;
+            const int lastWord = x1 >> 6;
+            for (int y = y0; y <= y1; ++y) {
+                const std::uint64_t* row = rowWords(y);
+                for (int i = firstWord; i <= lastWord; ++i) {
+                    const int from = (i == firstWord) ? (x0 & 63) : 0;
+                    const int to = (i == lastWord) ? (x1 & 63) + 1 : 64;
+                    if (!fn(row[i] & bits::range(from, to))) return;
+                }
+            }
+        }
+
+        int w = 0;
+        int h = 0;
+        int stride = 0;
+        std::vector<std::uint64_t> words;
+    };
+
+    // Bitboards for the tile kinds the game queries as sets
+    struct TileLayers {
+        TileBitboard walls;
+        TileBitboard dots;
+        TileBitboard pellets;
+        TileBitboard house;
+        TileBitboard doors;
+
+        // Rebuild every layer from the grid in one pass
+        void build(const MapGrid& grid) {
+            const int width = grid.width();
+            const int height = grid.height();
+            walls.assign(width, height);
+            dots.assign(width, height);
+            pellets.assign(width, height);
+            house.assign(width, height);
+            doors.assign(width, height);
+            for (int y = 0; y < height; ++y) {
+                const std::uint8_t* cells = grid.row(y);
+                for (int x = 0; x < width; ++x) {
+                    switch (cells[x]) {
+                        case tile::Wall: walls.set(x, y); break;
+                        case tile::Dot: dots.set(x, y); break;
+                        case tile::Pellet: pellets.set(x, y); break;
+                        case tile::House: house.set(x, y); break;
+                        case tile::Door: doors.set(x, y); break;
+                        default: break;
+                    }
+                }
+            }
+        }
+    };
+
+}
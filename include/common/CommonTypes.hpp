@@ -1,15 +1,73 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace game {
 
     // Shared enums
     enum class Direction { Right, Up, Left, Down, None };
-    
+
+    // Tile codes stored in a MapGrid cell
+    namespace tile {
+        constexpr std::uint8_t Path   = 0;  // walkable path
+        constexpr std::uint8_t Wall   = 1;
+        constexpr std::uint8_t House  = 2;  // monster room
+        constexpr std::uint8_t Dot    = 3;
+        constexpr std::uint8_t Pellet = 4;  // power pellet
+        constexpr std::uint8_t Door   = 5;  // ghost door
+    }
+
     // Shared types
-    using MapGrid = std::vector<std::vector<int>>; // 0 = path, 1 = wall, 2 = monster room, 3 = dot, 4 = power pellet
-    
+    // Row-major byte grid: cell (x, y) lives at data()[y * stride() + x].
+    // One contiguous block so tile reads in movement / BFS loops stay in cache.
+    class MapGrid {
+    public:
+        MapGrid() = default;
+        MapGrid(int width, int height, std::uint8_t fill = tile::Path) { assign(width, height, fill); }
+
+        void assign(int width, int height, std::uint8_t fill = tile::Path) {
+            w = (width > 0 && height > 0) ? width : 0;
+            h = (width > 0 && height > 0) ? height : 0;
+            cells.assign(static_cast<std::size_t>(w) * static_cast<std::size_t>(h), fill);
+        }
+
+        int width() const { return w; }
+        int height() const { return h; }
+        int stride() const { return w; }
+        std::size_t size() const { return cells.size(); }
+        bool empty() const { return cells.empty(); }
+
+        bool inBounds(int x, int y) const {
+            return static_cast<unsigned>(x) < static_cast<unsigned>(w) &&
+                   static_cast<unsigned>(y) < static_cast<unsigned>(h);
+        }
+        int index(int x, int y) const { return y * w + x; }
+
+        // Unchecked access; callers test inBounds() first
+        std::uint8_t at(int x, int y) const { return cells[index(x, y)]; }
+        std::uint8_t& at(int x, int y) { return cells[index(x, y)]; }
+
+        // Checked read: out-of-bounds cells read as `outside` (wall by default)
+        std::uint8_t get(int x, int y, std::uint8_t outside = tile::Wall) const {
+            return inBounds(x, y) ? cells[index(x, y)] : outside;
+        }
+        void set(int x, int y, std::uint8_t value) {
+            if (inBounds(x, y)) cells[index(x, y)] = value;
+        }
+
+        const std::uint8_t* data() const { return cells.data(); }
+        std::uint8_t* data() { return cells.data(); }
+        const std::uint8_t* row(int y) const { return cells.data() + static_cast<std::size_t>(y) * w; }
+        std::uint8_t* row(int y) { return cells.data() + static_cast<std::size_t>(y) * w; }
+
+    private:
+        int w = 0;
+        int h = 0;
+        std::vector<std::uint8_t> cells;
+    };
+
     // Tile position structure
     struct Tile {
         int x = 0;
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+namespace game {
+
+    // Fixed-step clock for the simulation. Real time goes in once per
+    // rendered frame; whole ticks come out, each tickSeconds() long, with the
+    // remainder carried to the next frame. The same inputs per tick therefore
+    // give the same game at any frame rate, and rendering never changes dt.
+    class SimulationClock {
+    public:
+        // `tickRate` ticks per simulated second
+        explicit SimulationClock(double tickRate = 60.0);
+
+        void setTickRate(double ticksPerSecond);
+        double tickRate() const { return rate; }
+        double tickSeconds() const { return step; }
+
+        // Catch-up limit: real time per frame above this is dropped rather
+        // than simulated (e.g. after a stall or a dragged window), so a slow
+        // frame can't snowball into ever longer ones
+        void setMaxFrameTime(double seconds);
+        double maxFrameTime() const { return maxFrame; }
+
+        // Fast-forward: simulated seconds per real second (1 = real time)
+        void setSpeed(double speedMultiplier);
+        double speed() const { return multiplier; }
+
+        // Add `realSeconds` of wall time; returns how many ticks to run now
+        int advance(double realSeconds);
+
+        // Fraction of a tick left over after the last advance(), in [0, 1);
+        // for drawing between the last two simulated states
+        double alpha() const { return accumulator / step; }
+
+        std::uint64_t ticks() const { return tickCount; }
+        double droppedSeconds() const { return dropped; }
+
+        // Forget carried time and counters
+        void reset();
+
+    private:
+        double rate = 60.0;
+        double step = 1.0 / 60.0;
+        double maxFrame = 0.25;
+        double multiplier = 1.0;
+        double accumulator = 0.0;   // simulated time not yet ticked, < step
+        double dropped = 0.0;       // real time cut by the catch-up limit
+        std::uint64_t tickCount = 0;
+    };
+
+}
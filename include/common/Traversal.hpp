@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "common/CommonTypes.hpp"
+
+namespace game {
+
+    // Who is moving. Each class has its own walkability rule:
+    //   Player        path, dot and power pellet tiles
+    //   GhostOutside  anything but walls and ghost doors
+    //   GhostInside   anything but walls (a door can be entered from the house)
+    //   Ghost         GhostInside on ghost-house tiles, GhostOutside elsewhere;
+    //                 the rule MonsterSystem moves and searches with
+    enum class Traversal { Player, GhostOutside, GhostInside, Ghost };
+
+    // Exit mask: bit static_cast<int>(dir) is set when a step from the tile in
+    // that direction is allowed (Right = 1, Up = 2, Left = 4, Down = 8)
+    inline std::uint8_t exitBit(Direction d) {
+        return d == Direction::None ? 0 : static_cast<std::uint8_t>(1u << static_cast<int>(d));
+    }
+
+    inline bool hasExit(std::uint8_t mask, Direction d) {
+        return (mask & exitBit(d)) != 0;
+    }
+
+    inline int exitCount(std::uint8_t mask) {
+        static constexpr std::uint8_t counts[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+        return counts[mask & 0x0F];
+    }
+
+    // Per-tile 4-bit exit masks for every Traversal class, computed once per
+    // level so movement, junction tests and search expansion are one lookup.
+    // Masks depend only on the layout (walls, house, doors): picking up dots
+    // and pellets never changes them, so rebuild only when the level changes.
+    class TraversalMasks {
+    public:
+        void build(const MapGrid& grid) {
+            w = grid.width();
+            h = grid.height();
+            const std::size_t count = grid.size();
+            for (auto& table : tables) {
+                table.assign(count, 0);
+            }
+
+            for (int y = 0; y < h; ++y) {
+                for (int x = 0; x < w; ++x) {
+                    computeTile(grid, x, y);
+                }
+            }
+        }
+
+        // Tile (x, y) of the grid changed: refresh it and its four neighbours
+        void update(const MapGrid& grid, int x, int y) {
+            if (grid.width() != w || grid.height() != h) {
+                build(grid);
+                return;
+            }
+            const int dx[5] = { 0, 1, 0, -1, 0 };
+            const int dy[5] = { 0, 0, -1, 0, 1 };
+            for (int i = 0; i < 5; ++i) {
+                if (grid.inBounds(x + dx[i], y + dy[i])) {
+                    computeTile(grid, x + dx[i], y + dy[i]);
+                }
+            }
+        }
+
+        // True if swapping tile code a for b changes no actor's rule, e.g.
+        // a dot being eaten; such changes never need update()
+        static bool sameRules(std::uint8_t a, std::uint8_t b) {
+            auto playerWalks = [](std::uint8_t c) { return c == tile::Path || c == tile::Dot || c == tile::Pellet; };
+            return playerWalks(a) == playerWalks(b) &&
+                   (a == tile::Wall) == (b == tile::Wall) &&
+                   (a == tile::Door) == (b == tile::Door) &&
+                   (a == tile::House) == (b == tile::House);
+        }
+
+        int width() const { return w; }
+        int height() const { return h; }
+
+        // Exit mask of tile (x, y); 0 outside the map
+        std::uint8_t exits(Traversal who, int x, int y) const {
+            if (static_cast<unsigned>(x) >= static_cast<unsigned>(w) ||
+                static_cast<unsigned>(y) >= static_cast<unsigned>(h)) {
+                return 0;
+            }
+            return tables[static_cast<int>(who)][static_cast<std::size_t>(y) * w + x];
+        }
+
+        bool canStep(Traversal who, int x, int y, Direction d) const {
+            return hasExit(exits(who, x, y), d);
+        }
+
+        // Raw row-major table, e.g. for search loops that already hold an index
+        const std::uint8_t* data(Traversal who) const { return tables[static_cast<int>(who)].data(); }
+
+    private:
+        void computeTile(const MapGrid& grid, int x, int y) {
+            const int dx[4] = { 1, 0, -1, 0 };   // Right, Up, Left, Down
+            const int dy[4] = { 0, -1, 0, 1 };
+            const std::size_t i = static_cast<std::size_t>(grid.index(x, y));
+            const bool inHouse = grid.at(x, y) == tile::House;
+            std::uint8_t player = 0, outside = 0, inside = 0;
+            for (int d = 0; d < 4; ++d) {
+                const std::uint8_t cell = grid.get(x + dx[d], y + dy[d]);
+                const std::uint8_t bit = static_cast<std::uint8_t>(1u << d);
+                if (cell == tile::Path || cell == tile::Dot || cell == tile::Pellet) player |= bit;
+                if (cell != tile::Wall) inside |= bit;
+                if (cell != tile::Wall && cell != tile::Door) outside |= bit;
+            }
+            tables[static_cast<int>(Traversal::Player)][i] = player;
+            tables[static_cast<int>(Traversal::GhostOutside)][i] = outside;
+            tables[static_cast<int>(Traversal::GhostInside)][i] = inside;
+            tables[static_cast<int>(Traversal::Ghost)][i] = inHouse ? inside : outside;
+        }
+
+        int w = 0;
+        int h = 0;
+        std::array<std::vector<std::uint8_t>, 4> tables;
+    };
+
+}
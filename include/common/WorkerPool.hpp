@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace game {
+
+    // Fixed set of threads for data-parallel loops. The calling thread takes
+    // part in every loop, so a pool of size 1 starts no threads and runs
+    // everything inline.
+    class WorkerPool {
+    public:
+        // fn(begin, end, worker): one chunk of [0, count); worker is 0 for the
+        // calling thread, 1..size()-1 for pool threads
+        using ChunkFn = std::function<void(std::size_t begin, std::size_t end, unsigned worker)>;
+
+        // `count` threads including the caller; 0 and 1 start none
+        explicit WorkerPool(unsigned count);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        unsigned size() const { return static_cast<unsigned>(threads.size()) + 1; }
+
+        // Runs fn over [0, count) in chunks of `grain` items and returns once
+        // every chunk is done. Chunks go to whichever thread is free, so fn
+        // must give the same result for an item whatever `worker` runs it.
+        void parallelFor(std::size_t count, std::size_t grain, const ChunkFn& fn);
+
+    private:
+        void threadLoop(unsigned worker);
+        void runChunks(unsigned worker);
+
+        std::vector<std::thread> threads;
+        std::mutex lock;
+        std::condition_variable wake;       // a job was posted, or stopping
+        std::condition_variable finished;   // the last pool thread left the job
+
+        // Current job; written under `lock` before the generation bump
+        const ChunkFn* job = nullptr;
+        std::size_t jobCount = 0;
+        std::size_t jobGrain = 1;
+        std::atomic<std::size_t> nextItem{ 0 };
+        unsigned running = 0;               // pool threads still inside the job
+        std::uint64_t generation = 0;
+        bool stopping = false;
+    };
+
+}
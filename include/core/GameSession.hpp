@@ -0,0 +1,64 @@
+#pragma once
+
+#include "map/MapSystem.h"
+#include "entities/PlayerController.hpp"
+#include "entities/MonsterSystem.hpp"
+
+namespace game {
+
+    // One game in progress on MapSystem's live map: the player, the ghosts
+    // and the rules that join them (pickups, collisions, deaths, level
+    // changes). The windowed game and headless_sim both advance it one
+    // fixed tick at a time through step().
+    class GameSession {
+    public:
+        enum class Status { Playing, GameOver, Won };
+
+        // Wall time per phase of step(), summed while profiling
+        struct PhaseTimes {
+            double player = 0.0;
+            double monsters = 0.0;
+            double rules = 0.0;     // events, pickups and collisions
+            double levelLoad = 0.0;
+        };
+
+        // The map must already hold level `level`, in Dense storage (a
+        // Chunked level is refused: the session starts as GameOver);
+        // mapSystem must outlive the session
+        GameSession(MapSystem& mapSystem, int level);
+        ~GameSession();
+
+        GameSession(const GameSession&) = delete;
+        GameSession& operator=(const GameSession&) = delete;
+
+        // One tick of play; does nothing once the game is over
+        Status step(double dt, const PlayerInput& input);
+
+        Status status() const { return state; }
+        int level() const { return currentLevel; }
+
+        PlayerController& player() { return playerController; }
+        const PlayerController& player() const { return playerController; }
+        MonsterSystem& monsters() { return monsterSystem; }
+        const MonsterSystem& monsters() const { return monsterSystem; }
+
+        // Print level changes and the win to stdout (on by default)
+        void setVerbose(bool enabled) { verbose = enabled; }
+
+        // Add each step()'s phase times to *times; nullptr stops
+        void setProfile(PhaseTimes* times) { profile = times; }
+
+    private:
+        void startNextLevel();
+
+        MapSystem& maps;
+        PlayerController playerController;
+        MonsterSystem monsterSystem;
+        int currentLevel;
+        Status state = Status::Playing;
+        bool verbose = true;
+        PhaseTimes* profile = nullptr;
+        int journalListener = -1;
+    };
+
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "common/CommonTypes.hpp"
+#include "common/Traversal.hpp"
+#include "entities/PathEngine.hpp"
+
+namespace game {
+
+    // Maze abstraction for one Traversal class, built once per level.
+    //
+    // Nodes are the tiles where a choice can be made or the passage is
+    // one-way: junctions, dead ends, corners of open areas, ghost doors.
+    // Every other walkable tile sits in a corridor (exactly two exits, both
+    // two-way) and corridors become edges between nodes, with their length
+    // and tile run. A query starting or ending inside a corridor enters the
+    // graph at the corridor's two ends, so searches cost O(nodes), not
+    // O(tiles).
+    //
+    // Large graphs also get one HPA*-style level on top: nodes are grouped
+    // into square clusters of tiles, nodes with an edge leaving their
+    // cluster become border nodes, and the shortest in-cluster distances
+    // between border nodes are precomputed. A query searches its start and
+    // goal clusters locally and the rest of the way on border nodes only,
+    // then refines the in-cluster legs. Distances stay exact.
+    class CorridorGraph {
+    public:
+        static constexpr int DefaultClusterSize = 32;    // tiles per cluster side
+        static constexpr int HierarchyThreshold = 4096;  // nodes before clustering
+
+        // clusterSize <= 0 never builds the cluster level
+        void build(const TraversalMasks& masks, Traversal who, int clusterSize = DefaultClusterSize);
+        void clear();
+
+        bool ready() const { return !nodeTiles.empty(); }
+        int nodeCount() const { return static_cast<int>(nodeTiles.size()); }
+        int edgeCount() const { return static_cast<int>(edges.size()); }
+        bool hierarchical() const { return !borderNodes.empty(); }
+        int borderNodeCount() const { return static_cast<int>(borderNodes.size()); }
+
+        bool isNode(const Tile& t) const { return inside(t) && nodeOf[indexOf(t)] >= 0; }
+
+        // Every directed edge as fn(from, to, run), `run` being the tiles
+        // after `from` up to and including `to` (its size is the length);
+        // for debug views and checks, not per-frame use
+        template <typename Fn>
+        void forEachEdge(Fn&& fn) const {
+            std::vector<Tile> run;
+            for (const auto& edge : edges) {
+                run.clear();
+                for (int k = 0; k < edge.length; ++k) {
+                    const int t = runTiles[static_cast<std::size_t>(edge.run + k)];
+                    run.push_back(Tile{ t % w, t / w });
+                }
+                const int from = nodeTiles[static_cast<std::size_t>(edge.from)];
+                fn(Tile{ from % w, from / w }, run.back(), static_cast<const std::vector<Tile>&>(run));
+            }
+        }
+
+        // False for tiles the graph cannot route from or to (a tile that can
+        // be left but not entered, a corridor loop with no node on it); use
+        // a grid search for those
+        bool covers(const Tile& t) const;
+
+        // Query scratch and counters. The graph itself is read-only during
+        // searches, so threads can search it at once, one Workspace each.
+        class Workspace;
+
+        // Same contract as PathEngine::search(): length of a shortest path
+        // of at most maxLength steps or -1; `path` (if given) gets the tiles
+        // after start up to and including goal. Requires covers() on both.
+        int search(const Tile& start, const Tile& goal, int maxLength,
+                   std::vector<Tile>* path, Workspace& ws) const;
+
+    private:
+        struct Edge {
+            int from;
+            int to;
+            int length;     // steps from `from` to `to`
+            int run;        // offset of the tiles after `from` up to `to` in runTiles
+            int reverse;    // same corridor walked the other way, -1 if none
+        };
+
+        // Where a query joins the graph: `cost` steps along a slice of an
+        // edge's run between the query tile and `node`
+        struct Portal {
+            int node;
+            int cost;
+            int edge;       // -1 when the query tile is the node itself
+            int first;      // slice of runTiles[edge.run ...]
+            int count;
+        };
+
+        struct AbsEdge {
+            int from;       // border node indices
+            int to;
+            int cost;
+            int edge;       // corridor edge for links between clusters, -1 inside one
+        };
+
+        // Stamped Dijkstra / A* state over n items
+        struct Scratch {
+            struct Entry { int f; int g; int item; };
+            std::vector<std::uint32_t> seen;
+            std::vector<int> cost;
+            std::vector<int> via;       // edge (or abstract edge) used to reach the item
+            std::vector<int> origin;    // portal the search started from
+            std::vector<Entry> heap;
+            std::uint32_t stamp = 0;
+
+            void begin(std::size_t n);
+            bool reached(int i) const { return seen[static_cast<std::size_t>(i)] == stamp; }
+            bool improve(int i, int g, int f, int through, int from);
+            bool pop(Entry& out);
+        };
+
+    public:
+        class Workspace {
+        public:
+            const PathStats& stats() const { return counters; }
+
+        private:
+            friend class CorridorGraph;
+            Scratch forward;
+            Scratch backward;
+            Scratch top;
+            Scratch local;
+            std::vector<Portal> entries;
+            std::vector<Portal> exits;
+            std::vector<int> chain;
+            std::vector<int> legs;
+            PathStats counters;
+        };
+
+    private:
+
+        bool inside(const Tile& t) const {
+            return static_cast<unsigned>(t.x) < static_cast<unsigned>(w) &&
+                   static_cast<unsigned>(t.y) < static_cast<unsigned>(h);
+        }
+        std::size_t indexOf(const Tile& t) const { return static_cast<std::size_t>(t.y) * w + t.x; }
+        int distanceTo(int node, const Tile& t) const;
+
+        void entryPortals(const Tile& start, std::vector<Portal>& out) const;
+        void exitPortals(const Tile& goal, std::vector<Portal>& out) const;
+        bool directPortal(const Tile& start, const Tile& goal, Portal& out) const;
+        void buildClusters(int clusterSize);
+        void appendSlice(int edge, int first, int count, std::vector<Tile>& path) const;
+        void appendNodeChain(const Scratch& s, int node, std::vector<int>& chain) const;
+        void appendEdges(const std::vector<int>& chain, std::vector<Tile>& path) const;
+
+        int searchFlat(const Tile& start, const Tile& goal, int maxLength,
+                       std::vector<Tile>* path, Workspace& ws) const;
+        int searchClustered(const Tile& start, const Tile& goal, int maxLength,
+                            std::vector<Tile>* path, Workspace& ws) const;
+
+        int w = 0;
+        int h = 0;
+
+        std::vector<int> nodeOf;        // tile -> node, -1 otherwise
+        std::vector<int> nodeTiles;     // node -> tile index
+        std::vector<int> edgeStart;     // node -> first out edge (CSR, nodeCount + 1)
+        std::vector<Edge> edges;
+        std::vector<int> inStart;       // node -> first entry of inEdges (CSR)
+        std::vector<int> inEdges;       // edge ids grouped by target node
+        std::vector<int> runTiles;
+        std::vector<int> corridorEdge;  // corridor tile -> an edge whose run holds it, -1 otherwise
+        std::vector<int> corridorPos;   // position of the tile in that run
+        std::vector<std::uint8_t> walkable;  // 2 can be entered, 1 can only be left, 0 no move
+
+        // Cluster level (empty unless hierarchical)
+        std::vector<int> clusterOf;     // node -> cluster
+        std::vector<int> borderOf;      // node -> border index, -1 otherwise
+        std::vector<int> borderNodes;   // border index -> node
+        std::vector<int> absStart;      // border index -> first AbsEdge (CSR)
+        std::vector<AbsEdge> absEdges;
+    };
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "common/CommonTypes.hpp"
+#include "common/Traversal.hpp"
+#include "entities/PathEngine.hpp"
+
+namespace game {
+
+    // Incremental shortest-path planner (D* Lite) for one chaser.
+    //
+    // The search runs backwards from the goal, so the values it keeps are
+    // distances *to* the goal. As long as the goal stays on the same tile,
+    // the chaser moving is almost free (the heuristic offset km absorbs it)
+    // and a layout edit only repairs the tiles whose distance changed. A new
+    // goal tile restarts the search; initialising it is O(1) thanks to
+    // generation stamps.
+    class DStarLite {
+    public:
+        // Plan over `masks` for `who`; forgets any previous search. The masks
+        // must outlive the planner.
+        void reset(const TraversalMasks& masks, Traversal who);
+
+        // Shortest path from start to goal (start exclusive, goal inclusive)
+        // into `path`. Returns its length, 0 if start == goal, -1 if there
+        // is no path (path is then empty).
+        int plan(const Tile& start, const Tile& goal, std::vector<Tile>& path);
+
+        // The masks were updated around tile (x, y); repaired on the next plan()
+        void tileChanged(int x, int y);
+
+        const PathStats& stats() const { return counters; }
+
+    private:
+        struct Key {
+            int k1;
+            int k2;
+            bool operator<(const Key& o) const { return k1 != o.k1 ? k1 < o.k1 : k2 < o.k2; }
+            bool operator==(const Key& o) const { return k1 == o.k1 && k2 == o.k2; }
+        };
+        struct Entry {
+            Key key;
+            int index;
+        };
+
+        int g(int i) const { return seen[static_cast<std::size_t>(i)] == stamp ? gValue[static_cast<std::size_t>(i)] : Infinity; }
+        int rhs(int i) const { return seen[static_cast<std::size_t>(i)] == stamp ? rhsValue[static_cast<std::size_t>(i)] : Infinity; }
+        void touch(int i);
+        int heuristic(int a, int b) const;
+        Key keyOf(int i) const;
+        void updateVertex(int i);
+        void repair();
+        void restart(int goal, int start);
+
+        static constexpr int Infinity = 1 << 29;
+
+        const TraversalMasks* masks = nullptr;
+        Traversal who = Traversal::Ghost;
+        int w = 0;
+        int h = 0;
+
+        int goalIndex = -1;
+        int startIndex = -1;
+        int lastStart = -1;
+        int km = 0;
+
+        // Per-tile values, valid where seen[i] == stamp
+        std::vector<std::uint32_t> seen;
+        std::vector<int> gValue;
+        std::vector<int> rhsValue;
+        std::vector<Key> openKey;           // key of the tile's live open entry
+        std::vector<std::uint8_t> inOpen;   // only meaningful where seen[i] == stamp
+        std::uint32_t stamp = 0;
+
+        std::vector<Entry> open;            // binary heap; stale entries skipped on pop
+        PathStats counters;
+    };
+
+}
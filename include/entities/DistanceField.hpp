@@ -0,0 +1,160 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "common/CommonTypes.hpp"
+#include "common/Traversal.hpp"
+
+namespace game {
+
+    // Path length from every tile to one target tile, filled by a single
+    // reverse BFS (stepping backwards along legal moves, so one-way tiles
+    // such as ghost doors are respected). Any number of actors chasing the
+    // same target read their distance and their next step from it instead
+    // of each searching; it only needs rebuilding when the target moves to
+    // another tile or the layout changes.
+    class DistanceField {
+    public:
+        // Fill the field for `who` moving towards `target`. The masks must
+        // outlive the field (nextStep() reads them).
+        void build(const TraversalMasks& masks, Traversal who, const Tile& target) {
+            begin(masks, who, target);
+            advance(queue.size());
+        }
+
+        // Same fill in slices: begin() seeds the target, each advance()
+        // settles up to `maxTiles` more tiles in BFS order. Tiles reached so
+        // far already have their final distance, so distance() and
+        // nextStep() are right for them before the field is complete.
+        // Reached marks are generation stamps, so after the first fill on a
+        // map size begin() is O(1).
+        void begin(const TraversalMasks& masks, Traversal who, const Tile& target) {
+            exits = masks.data(who);
+            w = masks.width();
+            h = masks.height();
+            source = target;
+            const std::size_t cells = static_cast<std::size_t>(w) * static_cast<std::size_t>(h);
+            if (stamp.size() != cells) {
+                stamp.assign(cells, 0);
+                dist.assign(cells, 0);
+                queue.assign(cells, 0);
+                current = 0;
+            }
+            if (++current == 0) {
+                // Stamp wrapped: old marks could alias, clear them once
+                std::fill(stamp.begin(), stamp.end(), 0u);
+                current = 1;
+            }
+            filled = true;
+            head = tail = 0;
+            if (static_cast<unsigned>(target.x) >= static_cast<unsigned>(w) ||
+                static_cast<unsigned>(target.y) >= static_cast<unsigned>(h)) {
+                return;
+            }
+            const int start = target.y * w + target.x;
+            reach(start, 0);
+            queue[tail++] = start;
+        }
+
+        // Returns true once every reachable tile is in
+        bool advance(std::size_t maxTiles) {
+            for (std::size_t n = 0; n < maxTiles && head < tail; ++n) {
+                const int cur = queue[head++];
+                const int d = dist[static_cast<std::size_t>(cur)];
+                const int cx = cur % w;
+                const int cy = cur / w;
+                // Predecessors: tiles with a legal step into cur
+                for (const auto& step : steps) {
+                    const int px = cx - step.dx;
+                    const int py = cy - step.dy;
+                    if (static_cast<unsigned>(px) >= static_cast<unsigned>(w) ||
+                        static_cast<unsigned>(py) >= static_cast<unsigned>(h)) {
+                        continue;
+                    }
+                    const int prev = py * w + px;
+                    if (reached(prev) || !hasExit(exits[prev], step.dir)) {
+                        continue;
+                    }
+                    reach(prev, d + 1);
+                    queue[tail++] = prev;
+                }
+            }
+            return complete();
+        }
+
+        bool complete() const { return head == tail; }
+
+        // Every tile within this many steps of the target is already in
+        // (so one that is not is farther away); INT_MAX once complete
+        int settledRange() const {
+            return complete() ? std::numeric_limits<int>::max() : dist[static_cast<std::size_t>(queue[head])];
+        }
+
+        // Forget the field, e.g. after a layout edit
+        void invalidate() {
+            filled = false;
+            head = tail = 0;
+        }
+
+        bool valid() const { return filled; }
+        const Tile& target() const { return source; }
+
+        // Steps from (x, y) to the target, -1 if unreachable or off the map
+        int distance(const Tile& from) const {
+            if (!valid() ||
+                static_cast<unsigned>(from.x) >= static_cast<unsigned>(w) ||
+                static_cast<unsigned>(from.y) >= static_cast<unsigned>(h)) {
+                return -1;
+            }
+            const int index = from.y * w + from.x;
+            return reached(index) ? dist[static_cast<std::size_t>(index)] : -1;
+        }
+
+        // A step one tile closer to the target (right, left, down, up
+        // preference on ties); None at the target or if it is unreachable
+        Direction nextStep(const Tile& from) const {
+            const int d = distance(from);
+            if (d <= 0) return Direction::None;
+            const int cur = from.y * w + from.x;
+            for (const auto& step : steps) {
+                const int next = cur + step.dy * w + step.dx;
+                if (hasExit(exits[cur], step.dir) && reached(next) &&
+                    dist[static_cast<std::size_t>(next)] == d - 1) {
+                    return step.dir;
+                }
+            }
+            return Direction::None;
+        }
+
+    private:
+        struct Step { Direction dir; int dx; int dy; };
+        static constexpr Step steps[4] = {
+            { Direction::Right,  1,  0 },
+            { Direction::Left,  -1,  0 },
+            { Direction::Down,   0,  1 },
+            { Direction::Up,     0, -1 },
+        };
+
+        bool reached(int index) const { return stamp[static_cast<std::size_t>(index)] == current; }
+        void reach(int index, int distance) {
+            stamp[static_cast<std::size_t>(index)] = current;
+            dist[static_cast<std::size_t>(index)] = distance;
+        }
+
+        const std::uint8_t* exits = nullptr;
+        int w = 0;
+        int h = 0;
+        Tile source{ -1, -1 };
+        bool filled = false;
+        std::vector<std::uint32_t> stamp;   // == current: tile reached in this fill
+        std::uint32_t current = 0;
+        std::vector<int> dist;      // valid for reached tiles only
+        std::vector<int> queue;     // BFS queue, kept between builds
+        std::size_t head = 0;       // next tile to expand
+        std::size_t tail = 0;       // end of the queue
+    };
+
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "common/CommonTypes.hpp"
+#include "common/Traversal.hpp"
+#include "entities/SearchWorkspace.hpp"
+
+namespace game {
+
+    // All-pairs shortest-path table for one Traversal class, built once per
+    // level. For every ordered pair of walkable tiles it stores the path
+    // length (16 bits) and the first step to take (one byte), so "how far"
+    // and "which way" are single lookups instead of a BFS.
+    //
+    // Size grows with the square of the walkable tile count (3 bytes per
+    // pair, about 270 KB for 300 tiles). build() refuses levels whose table
+    // would exceed the byte budget and leaves the table disabled; callers
+    // then fall back to searching.
+    class DistanceTable {
+    public:
+        static constexpr std::uint16_t Unreachable = 0xFFFF;
+        static constexpr std::size_t DefaultBudget = std::size_t(4) << 20;   // bytes
+
+        // 0 disables the table. Takes effect on the next build().
+        void setBudget(std::size_t bytes) { budgetBytes = bytes; }
+        std::size_t budget() const { return budgetBytes; }
+
+        // Tables for `who` over the masks' map. Ties between equally short
+        // paths are broken like a BFS from the source expanding right, left,
+        // down, up, so the first step matches MonsterSystem's own search.
+        // Returns false, leaving the table disabled, when over budget.
+        bool build(const TraversalMasks& masks, Traversal who, SearchWorkspace& search) {
+            clear();
+            w = masks.width();
+            const int h = masks.height();
+            const std::size_t cells = static_cast<std::size_t>(w) * static_cast<std::size_t>(h);
+            if (cells == 0) return false;
+
+            // Nodes: tiles that can be left or entered under `who`
+            const std::uint8_t* exits = masks.data(who);
+            nodeOf.assign(cells, -1);
+            std::vector<char> isNode(cells, 0);
+            for (std::size_t i = 0; i < cells; ++i) {
+                if (exits[i] == 0) continue;
+                isNode[i] = 1;
+                for (const auto& step : steps) {
+                    if (hasExit(exits[i], step.dir)) {
+                        isNode[i + step.dy * w + step.dx] = 1;
+                    }
+                }
+            }
+            for (std::size_t i = 0; i < cells; ++i) {
+                if (isNode[i]) {
+                    nodeOf[i] = static_cast<int>(tileOf.size());
+                    tileOf.push_back(static_cast<int>(i));
+                }
+            }
+
+            const std::size_t n = tileOf.size();
+            if (n == 0 || n >= Unreachable || n * n * bytesPerPair > budgetBytes) {
+                clear();
+                return false;
+            }
+
+            dist.assign(n * n, Unreachable);
+            hop.assign(n * n, static_cast<std::uint8_t>(Direction::None));
+
+            // One BFS per source; each reached tile inherits its parent's first step
+            for (std::size_t s = 0; s < n; ++s) {
+                std::uint16_t* distRow = &dist[s * n];
+                std::uint8_t* hopRow = &hop[s * n];
+                const int source = tileOf[s];
+
+                search.begin(cells);
+                search.visit(source, -1, 0);
+                search.push(source);
+                distRow[s] = 0;
+
+                while (!search.empty()) {
+                    const int cur = search.pop();
+                    const int d = search.distanceOf(cur);
+                    const std::size_t curNode = static_cast<std::size_t>(nodeOf[cur]);
+                    for (const auto& step : steps) {
+                        if (!hasExit(exits[cur], step.dir)) continue;
+                        const int nxt = cur + step.dy * w + step.dx;
+                        if (search.visited(nxt)) continue;
+                        search.visit(nxt, cur, d + 1);
+                        search.push(nxt);
+
+                        const std::size_t nxtNode = static_cast<std::size_t>(nodeOf[nxt]);
+                        distRow[nxtNode] = static_cast<std::uint16_t>(d + 1);
+                        hopRow[nxtNode] = (cur == source) ? static_cast<std::uint8_t>(step.dir)
+                                                          : hopRow[curNode];
+                    }
+                }
+            }
+            return true;
+        }
+
+        void clear() {
+            w = 0;
+            nodeOf.clear();
+            tileOf.clear();
+            dist.clear();
+            hop.clear();
+        }
+
+        bool ready() const { return !dist.empty(); }
+        int nodeCount() const { return static_cast<int>(tileOf.size()); }
+        std::size_t memoryBytes() const {
+            return dist.capacity() * sizeof(std::uint16_t) + hop.capacity() +
+                   (nodeOf.capacity() + tileOf.capacity()) * sizeof(int);
+        }
+
+        // Path length between two tiles, -1 if unreachable or either is not
+        // walkable. Only valid when ready().
+        int distance(const Tile& from, const Tile& to) const {
+            const std::size_t at = pairOf(from, to);
+            if (at == npos || dist[at] == Unreachable) return -1;
+            return dist[at];
+        }
+
+        // First step of a shortest path; None if there is none or from == to
+        Direction firstStep(const Tile& from, const Tile& to) const {
+            const std::size_t at = pairOf(from, to);
+            return at == npos ? Direction::None : static_cast<Direction>(hop[at]);
+        }
+
+    private:
+        struct Step { Direction dir; int dx; int dy; };
+        static constexpr Step steps[4] = {
+            { Direction::Right,  1,  0 },
+            { Direction::Left,  -1,  0 },
+            { Direction::Down,   0,  1 },
+            { Direction::Up,     0, -1 },
+        };
+
+        static constexpr std::size_t bytesPerPair = sizeof(std::uint16_t) + sizeof(std::uint8_t);
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        std::size_t pairOf(const Tile& from, const Tile& to) const {
+            const std::size_t h = w > 0 ? nodeOf.size() / static_cast<std::size_t>(w) : 0;
+            if (static_cast<unsigned>(from.x) >= static_cast<unsigned>(w) || static_cast<std::size_t>(from.y) >= h ||
+                static_cast<unsigned>(to.x) >= static_cast<unsigned>(w) || static_cast<std::size_t>(to.y) >= h) {
+                return npos;
+            }
+            const int a = nodeOf[static_cast<std::size_t>(from.y) * w + from.x];
+            const int b = nodeOf[static_cast<std::size_t>(to.y) * w + to.x];
+            if (a < 0 || b < 0) return npos;
+            return static_cast<std::size_t>(a) * tileOf.size() + static_cast<std::size_t>(b);
+        }
+
+        std::size_t budgetBytes = DefaultBudget;
+        int w = 0;
+        std::vector<int> nodeOf;             // tile index -> node, -1 if not walkable
+        std::vector<int> tileOf;             // node -> tile index
+        std::vector<std::uint16_t> dist;     // [from node * n + to node]
+        std::vector<std::uint8_t> hop;       // Direction of the first step, same layout
+    };
+
+}
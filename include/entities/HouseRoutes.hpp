@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "common/CommonTypes.hpp"
+
+namespace game {
+
+    // Stored way out of the ghost house: for each house tile, the path
+    // (tile exclusive, exit inclusive) through the door to the first tile
+    // that is neither house nor door. Filled once per level; leaving the
+    // house is then a copy, no search.
+    class HouseRoutes {
+    public:
+        // Forget every route and size the tile index for a width x height map
+        void reset(int width, int height) {
+            w = width;
+            h = height;
+            routeOf.assign(static_cast<std::size_t>(w) * static_cast<std::size_t>(h), -1);
+            offsets.assign(1, 0);
+            tiles.clear();
+        }
+
+        // Route out of house tile `from`; a later add() for the tile wins
+        void add(const Tile& from, const std::vector<Tile>& route) {
+            if (!inside(from) || route.empty()) return;
+            routeOf[indexOf(from)] = static_cast<int>(offsets.size()) - 1;
+            tiles.insert(tiles.end(), route.begin(), route.end());
+            offsets.push_back(static_cast<int>(tiles.size()));
+        }
+
+        bool has(const Tile& from) const { return inside(from) && routeOf[indexOf(from)] >= 0; }
+
+        // Copy the route from `from` into path; false (path untouched) if
+        // the tile has none
+        bool route(const Tile& from, std::vector<Tile>& path) const {
+            if (!has(from)) return false;
+            const std::size_t r = static_cast<std::size_t>(routeOf[indexOf(from)]);
+            path.assign(tiles.begin() + offsets[r], tiles.begin() + offsets[r + 1]);
+            return true;
+        }
+
+        std::size_t routeCount() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+    private:
+        bool inside(const Tile& t) const {
+            return static_cast<unsigned>(t.x) < static_cast<unsigned>(w) &&
+                   static_cast<unsigned>(t.y) < static_cast<unsigned>(h);
+        }
+        std::size_t indexOf(const Tile& t) const { return static_cast<std::size_t>(t.y) * w + t.x; }
+
+        int w = 0;
+        int h = 0;
+        std::vector<int> routeOf;       // tile -> route, -1 if none
+        std::vector<int> offsets;       // route -> first tile in `tiles` (routeCount + 1)
+        std::vector<Tile> tiles;
+    };
+
+}
@@ -1,8 +1,21 @@
 #pragma once
 
+#include <algorithm>
+#include <functional>
+#include <queue>
 #include <vector>
 #include <cstddef>
 #include "common/CommonTypes.hpp"
+#include "common/Traversal.hpp"
+#include "common/WorkerPool.hpp"
+#include "entities/CorridorGraph.hpp"
+#include "entities/DistanceField.hpp"
+#include "entities/DStarLite.hpp"
+#include "entities/DistanceTable.hpp"
+#include "entities/HouseRoutes.hpp"
+#include "entities/OccupancyIndex.hpp"
+#include "entities/PathEngine.hpp"
+#include "entities/SearchWorkspace.hpp"
 
 namespace game {
 
@@ -28,36 +41,116 @@ namespace game {
         GhostType type = GhostType::Blue;
     };
 
+    // What happened between the ghosts and the player in one update();
+    // every contact is decided inside MonsterSystem, the game only applies it
     struct MonsterEvents {
         bool playerHit = false;
-        void reset() { playerHit = false; }
+        int hits = 0;           // ghosts that caught the player
+        int ghostsEaten = 0;    // ghosts a powered player sent back to spawn
+        void reset() { *this = MonsterEvents{}; }
     };
 
 
-    // Internal Ghost structure
-    struct Ghost {
-        Tile pos;
-        Tile prevPos; //Previous frame position
-        Tile spawnPos;
-        Direction dir = Direction::Right;
-        GhostState state = GhostState::Patrol;
-        GhostType type = GhostType::Blue;
-
-        double stunTimer = 0.0;
-        double perceptionRange = 8.0;  // Perception range (reduced from 12.0)
-        double spawnDelay = 0.0;  // Delay before monster can start chasing
+    // Position of each tile in a patrol loop (its first visit), stored over
+    // the loop's bounding box so membership is one lookup. Built on demand:
+    // a new loop only marks it stale.
+    struct PatrolLookup {
+        Tile origin{ 0, 0 };
+        int w = 0;
+        int h = 0;
+        std::vector<int> first;     // -1 for tiles off the loop
+        bool built = false;         // assign() ran for the current loop
+
+        void invalidate() { built = false; }
+
+        void assign(const std::vector<Tile>& loop) {
+            built = true;
+            first.clear();
+            w = h = 0;
+            if (loop.empty()) return;
+            Tile lo = loop.front();
+            Tile hi = loop.front();
+            for (const auto& t : loop) {
+                lo = Tile{ std::min(lo.x, t.x), std::min(lo.y, t.y) };
+                hi = Tile{ std::max(hi.x, t.x), std::max(hi.y, t.y) };
+            }
+            origin = lo;
+            w = hi.x - lo.x + 1;
+            h = hi.y - lo.y + 1;
+            first.assign(static_cast<std::size_t>(w) * static_cast<std::size_t>(h), -1);
+            for (std::size_t i = loop.size(); i-- > 0; ) {
+                first[static_cast<std::size_t>(loop[i].y - lo.y) * w + (loop[i].x - lo.x)] = static_cast<int>(i);
+            }
+        }
+
+        // Index of t's first visit in the loop, -1 if it is not on it
+        int indexOf(const Tile& t) const {
+            const int x = t.x - origin.x;
+            const int y = t.y - origin.y;
+            if (static_cast<unsigned>(x) >= static_cast<unsigned>(w) ||
+                static_cast<unsigned>(y) >= static_cast<unsigned>(h)) {
+                return -1;
+            }
+            return first[static_cast<std::size_t>(y) * w + x];
+        }
+    };
 
+    // Per-ghost patrol loop and current path; touched when a ghost follows
+    // or replans a route
+    struct GhostRoute {
         std::vector<Tile> patrolPath;   // loop
+        mutable PatrolLookup patrolLookup;  // membership in patrolPath, see patrolLookupOf()
         std::size_t patrolIndex = 0;
 
         std::vector<Tile> path;     // current path（CHASE / RETURN）
         std::size_t pathIndex = 0;
 
-        int stepCounter = 0;    // Simple UI animation
-        double animTimer = 0.0;  // Animation timer to slow down frame changes
-        double moveTimer = 0.0;  // Timer to slow down monster movement
+        // Chase path inputs; the path is reused until one of them changes
+        bool pathPlanned = false;       // path came from a chase plan
+        Tile plannedFrom{ -1, -1 };
+        Tile plannedTarget{ -1, -1 };
+        std::uint64_t plannedEpoch = 0;
+
+        // Budgeted planning: the target asked for this frame, and whether
+        // the ghost already waits in the planning queue
+        Tile planTarget{ -1, -1 };
+        bool planWanted = false;
+        bool planQueued = false;
+    };
 
-        int hitFreezeSteps = 0;  //Avoid overlap between monsters and players
+    // All ghosts as a structure of arrays: ghost i is entry i of every
+    // column. The per-frame passes walk the small hot columns; routes and
+    // rarely read fields are kept apart so crowds of ghosts stay cache
+    // friendly.
+    struct GhostStore {
+        // Hot: read or written for every ghost every frame
+        std::vector<Tile> pos;
+        std::vector<Tile> prevPos;          // previous frame position
+        std::vector<Direction> dir;
+        std::vector<GhostState> state;
+        std::vector<double> spawnDelay;     // delay before the ghost can leave / chase
+        std::vector<double> animTimer;      // animation frame timer, wraps at 10 s
+        std::vector<double> moveTimer;      // time since the last step
+        std::vector<int> hitFreezeSteps;    // updates to sit out (no move, no contact) after a hit
+        std::vector<Direction> fleeDir;     // step away from a powered player, None if boxed in
+
+        // Cold
+        std::vector<Tile> spawnPos;
+        std::vector<GhostType> type;
+        std::vector<double> perceptionRange;
+        std::vector<double> stunTimer;
+        std::vector<int> stepCounter;       // simple UI animation
+        std::vector<GhostRoute> routes;
+
+        std::size_t size() const { return pos.size(); }
+        void clear();
+        void reserve(std::size_t count);
+
+        // Append a patrolling ghost standing on `spawn`; returns its index
+        std::size_t add(const Tile& spawn, GhostType ghostType, double delay);
+
+        // Spawn delay and animation timer of every ghost, one branch-free loop each
+        void tickTimers(double dt);
     };
 
     // Monster System Black Box
@@ -77,22 +170,138 @@ namespace game {
         // Rendering information
         std::vector<GhostRenderInfo> getRenderInfo() const;
 
+        // Ghosts by tile, kept current as they move; actor ids are the
+        // indices of getRenderInfo()
+        const OccupancyIndex& getOccupancy() const { return occupancy; }
+
         MonsterEvents pollEvents();
 
         void resetAllGhosts();
 
+        // Start a new level on the same (already reloaded) map: rebuilds the
+        // exit masks and all ghosts from the new spawn list without
+        // reconstructing the system.
+        void startLevel(const std::vector<Tile>& spawns);
+
+        // The layout of tile (x, y) changed in place (e.g. a wall edit):
+        // refresh the exit masks around it
+        void onTileChanged(int x, int y);
+
+        // Byte budget for the per-level all-pairs distance table (0 turns it
+        // off). Levels whose table would be larger fall back to BFS.
+        // Rebuilds the table for the current map.
+        void setDistanceTableBudget(std::size_t bytes);
+        bool hasDistanceTable() const { return distances.ready(); }
+
+        // Levels without a distance table get a corridor graph instead; it
+        // answers the queries the player field does not
+        bool hasCorridorGraph() const { return corridors.ready(); }
+        PathStats getCorridorStats() const;
+
+        // Stored way out of each ghost-house tile, rebuilt with the table /
+        // graph and on setPathAlgorithm()
+        const HouseRoutes& getHouseRoutes() const { return houseRoutes; }
+
+        // Search used for tiles the corridor graph does not cover (BFS by
+        // default). Can be switched at any time, e.g. per map.
+        void setPathAlgorithm(PathAlgorithm algorithm);
+        PathAlgorithm getPathAlgorithm() const { return pathAlgorithm; }
+        PathStats getPathStats() const;
+
+        // Plan chase paths with one incremental D* Lite planner per ghost
+        // instead of the table / field / engine. Off by default.
+        void setIncrementalChase(bool enabled);
+        bool getIncrementalChase() const { return incrementalChase; }
+        PathStats getChasePlannerStats() const;
+
+        // Threads for the ghost decide phase, the caller included (1 = no
+        // pool, the default). Results are the same for any count.
+        void setWorkerThreads(unsigned threads);
+        unsigned getWorkerThreads() const { return static_cast<unsigned>(searchContexts.size()); }
+
+        // Wall-clock time per update() for chase planning, in microseconds.
+        // 0 (the default) plans each ghost inline as soon as it needs a path.
+        // Otherwise requests queue up, nearest and longest-waiting first, and
+        // searches that run out of time resume next update(); ghosts follow
+        // their old path until the new one is ready, then step greedily
+        // towards the target. Timing makes budgeted runs machine dependent.
+        void setPlanningBudget(int microseconds);
+        int getPlanningBudget() const { return planBudgetMicros; }
+        std::size_t getPendingPlans() const { return planQueue.size(); }
+        bool isPlanPending(std::size_t ghost) const { return ghosts.routes[ghost].planQueued; }
+
+        // Clock the budget is measured on, in microseconds; steady_clock
+        // when empty. A stub clock makes budgeted runs repeatable.
+        using PlanningClock = std::function<long long()>;
+        void setPlanningClock(PlanningClock clock) { planClock = std::move(clock); }
+
     private:
+        // Scratch for one thread's path queries
+        struct SearchContext {
+            std::unique_ptr<PathEngine> engine;
+            CorridorGraph::Workspace corridor;
+        };
+
+        static constexpr std::size_t ParallelMinGhosts = 64;   // fewer are decided inline
+        static constexpr std::size_t DecideGrain = 16;         // ghosts per pool chunk
+        static constexpr std::size_t PlanSlice = 256;          // field tiles between clock checks
+        static constexpr long long PlanAgeWeight = 4;          // tiles of distance one frame of waiting is worth
+        static constexpr long long PlanNoPathBonus = 64;       // head start for ghosts with nothing to follow
+        static constexpr int HitFreezeUpdates = 1;             // updates a ghost sits out after catching the player
+
+        // Queued chase plan; lower key first, then lower ghost index
+        struct PlanRequest {
+            long long key;
+            std::size_t ghost;
+            bool operator<(const PlanRequest& o) const {
+                return key != o.key ? key > o.key : ghost > o.ghost;
+            }
+        };
+
         const MapGrid& map;
+        TraversalMasks traversal;   // exit masks of `map`, rebuilt in startLevel()
+        SearchWorkspace search;     // scratch for distance table builds
+        DistanceTable distances;    // Ghost-rule all-pairs table; empty when over budget
+        bool distancesStale = false;     // layout edited since the table / graph was built
+        DistanceField playerField;  // distances to the player's tile when there is no table
+        CorridorGraph corridors;    // Ghost-rule graph when there is no table
+        HouseRoutes houseRoutes;    // way out of each house tile, rebuilt with the table / graph
+        PathAlgorithm pathAlgorithm = PathAlgorithm::BFS;
+        std::vector<SearchContext> searchContexts;  // [0] for the calling thread, then one per pool thread
+        std::unique_ptr<WorkerPool> workers;        // null when single-threaded
+        bool incrementalChase = false;
+        std::vector<DStarLite> chasePlanners;   // per ghost, when incrementalChase
+        std::uint64_t planEpoch = 1;     // bumped when cached chase paths may be stale
         MonsterPlayerState player{};
         Tile prevPlayerTile{}; //Record the player's previous frame
-        std::vector<Ghost> ghosts;
+        GhostStore ghosts;
+        OccupancyIndex occupancy;   // ghost positions by tile
+        int redGhost = -1;          // first Red ghost (Yellow aims off it), -1 if none
         MonsterEvents events;
 
+        int planBudgetMicros = 0;
+        PlanningClock planClock;            // empty: steady_clock
+        std::priority_queue<PlanRequest> planQueue;
+        DistanceField planField;            // reverse BFS from the target being planned, built in slices
+        std::uint64_t planFieldEpoch = 0;   // planEpoch the field was started in
+        long long planFrame = 0;            // update() count, ages queued requests
+        int perceptionReach = 0;            // longest ghost perception range, in steps
+
+        void resetChasePlanners();
+        void clearPlanQueue();
+        void runPlanner();
+        bool followingPlan(std::size_t i) const;
+        long long planningNow() const;
+        Direction stepTowards(const Tile& from, Direction facing, const Tile& target) const;
+        void buildLayoutTables();
+        void buildHouseRoutes();
+
         // helper
         bool inBounds(int x, int y) const;
         bool isWalkable(int x, int y) const;
         bool isInGhostHouse(int x, int y) const;
         bool isGhostDoor(int x, int y) const;
+        std::uint8_t ghostExits(const Tile& t) const;
 
         Tile dirToDelta(Direction d) const;
         Direction deltaToDir(const Tile& delta) const;
@@ -103,24 +312,42 @@ namespace game {
 
         std::vector<Tile> generatePatrolLoop(const Tile& start) const;
 
-        std::vector<Tile> computeShortestPath(const Tile& start,
-                                              const Tile& goal) const;
+        // Shortest path from start (exclusive) to goal (inclusive), written into
+        // `path` (cleared first, capacity reused). False if unreachable or
+        // start == goal.
+        bool computeShortestPath(const Tile& start,
+                                 const Tile& goal,
+                                 std::vector<Tile>& path,
+                                 SearchContext& ctx) const;
 
         int shortestPathDistance(const Tile& start,
                                  const Tile& goal,
-                                 int maxRange) const;
+                                 int maxRange,
+                                 SearchContext& ctx) const;
 
         bool isIntersection(const Tile& t) const;
         bool isDeadEnd(const Tile& t, Direction dir) const;
 
-        bool onPatrolPath(const Ghost& g) const;
-        Tile nearestPatrolNode(const Ghost& g) const;
-
-        const Ghost* findRedGhost() const;
-        Tile computeChaseTarget(const Ghost& g, const Tile& playerTile) const;
-
-        void updateGhostAI(Ghost& g, double dt);
-        void moveGhost(Ghost& g, double dt);
+        // Patrol-loop queries. Nothing in update() calls them at the moment
+        // (patrol loops stay inside the ghost house, which the Ghost rule
+        // cannot re-enter from outside), so the lookup behind them is only
+        // built the first time one is asked.
+        bool onPatrolPath(std::size_t i) const;
+        Tile nearestPatrolNode(std::size_t i, SearchContext& ctx) const;
+        const PatrolLookup& patrolLookupOf(std::size_t i) const;
+
+        Tile computeChaseTarget(std::size_t i, const Tile& playerTile) const;
+
+        void scoreFleeDirections();
+        void updateGhostAI(std::size_t i, double dt, SearchContext& ctx);
+        void moveGhost(std::size_t i, double dt);
+
+        // Ghost/player contact, decided only here: the ghosts the occupancy
+        // index has on the player's tile, either just Red (right after its
+        // move) or all the others, so each ghost is resolved once per update
+        void resolvePlayerCollisions(bool leaderOnly);
+        void collideWithPlayer(std::size_t i);
+        void respawnGhost(std::size_t i);
     };
 
 }
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "common/CommonTypes.hpp"
+
+namespace game {
+
+    // Which actors stand on each tile: one list head per tile, linked through
+    // per-actor next / prev slots. Moving an actor is O(1), and asking who is
+    // on (or next to) a tile walks only the actors there. Four bytes per tile,
+    // so a dense grid stays cheap even on generated 1000x1000 maps.
+    class OccupancyIndex {
+    public:
+        static constexpr int None = -1;
+
+        // Empty width x height grid for actors 0..actors-1, none placed
+        void reset(int width, int height, std::size_t actors) {
+            w = width;
+            h = height;
+            head.assign(static_cast<std::size_t>(w) * static_cast<std::size_t>(h), None);
+            next.assign(actors, None);
+            prev.assign(actors, None);
+            tileOf.assign(actors, None);
+        }
+
+        // Put `actor` on tile t; a tile off the grid just removes it
+        void place(int actor, const Tile& t) {
+            const int to = inside(t) ? indexOf(t) : None;
+            if (tileOf[actor] == to) return;
+            unlink(actor);
+            if (to == None) return;
+            next[actor] = head[to];
+            if (head[to] != None) prev[head[to]] = actor;
+            head[to] = actor;
+            tileOf[actor] = to;
+        }
+
+        void remove(int actor) { unlink(actor); }
+
+        // First actor on t and the one after `actor` on its tile; None ends
+        // the list. Order within a tile is unspecified.
+        int firstOn(const Tile& t) const { return inside(t) ? head[indexOf(t)] : None; }
+        int nextOn(int actor) const { return next[actor]; }
+
+        bool occupied(const Tile& t) const { return firstOn(t) != None; }
+
+        std::size_t countOn(const Tile& t) const {
+            std::size_t n = 0;
+            for (int a = firstOn(t); a != None; a = next[a]) ++n;
+            return n;
+        }
+
+        // fn(actor) for every actor on t
+        template <typename Fn>
+        void forEachOn(const Tile& t, Fn&& fn) const {
+            for (int a = firstOn(t); a != None;) {
+                const int after = next[a];     // fn may move `a`
+                fn(a);
+                a = after;
+            }
+        }
+
+        // fn(actor, tile) for every actor on t or one of its four neighbours
+        template <typename Fn>
+        void forEachAround(const Tile& t, Fn&& fn) const {
+            static constexpr int dx[5] = { 0, 1, 0, -1, 0 };
+            static constexpr int dy[5] = { 0, 0, -1, 0, 1 };
+            for (int k = 0; k < 5; ++k) {
+                const Tile n{ t.x + dx[k], t.y + dy[k] };
+                forEachOn(n, [&](int a) { fn(a, n); });
+            }
+        }
+
+        std::size_t actorCount() const { return tileOf.size(); }
+
+    private:
+        bool inside(const Tile& t) const {
+            return static_cast<unsigned>(t.x) < static_cast<unsigned>(w) &&
+                   static_cast<unsigned>(t.y) < static_cast<unsigned>(h);
+        }
+        int indexOf(const Tile& t) const { return t.y * w + t.x; }
+
+        void unlink(int actor) {
+            const int at = tileOf[actor];
+            if (at == None) return;
+            if (prev[actor] != None) next[prev[actor]] = next[actor];
+            else head[at] = next[actor];
+            if (next[actor] != None) prev[next[actor]] = prev[actor];
+            next[actor] = prev[actor] = tileOf[actor] = None;
+        }
+
+        int w = 0;
+        int h = 0;
+        std::vector<int> head;      // tile -> first actor, None if empty
+        std::vector<int> next;      // actor -> next actor on the same tile
+        std::vector<int> prev;      // actor -> previous actor on the same tile
+        std::vector<int> tileOf;    // actor -> tile index, None if not placed
+    };
+
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "common/CommonTypes.hpp"
+#include "common/Traversal.hpp"
+#include "entities/SearchWorkspace.hpp"
+
+namespace game {
+
+    enum class PathAlgorithm {
+        BFS,        // uninformed, right/left/down/up order; the original ghost search
+        AStar,      // Manhattan heuristic, binary heap
+        JumpPoint   // A* over jump points; skips the interior of open rooms
+    };
+
+    const char* pathAlgorithmName(PathAlgorithm algorithm);
+
+    // Counters for comparing engines on a map
+    struct PathStats {
+        std::uint64_t queries = 0;
+        std::uint64_t expanded = 0;     // nodes taken off the open list, all queries
+        int lastExpanded = 0;           // same, most recent query
+        // Tiles read: each expanded tile plus each tile a jump scan steps
+        // onto, so JumpPoint's long scans are not free. Equal to expanded
+        // for the other grid searches; the corridor graph leaves it 0.
+        std::uint64_t scanned = 0;
+        int lastScanned = 0;
+    };
+
+    // Grid shortest-path search over the exit masks of one Traversal class.
+    // All engines return the same path length; paths of equal length may
+    // differ between engines.
+    class PathEngine {
+    public:
+        virtual ~PathEngine() = default;
+
+        virtual PathAlgorithm algorithm() const = 0;
+
+        // Length of a shortest path from start to goal that is at most
+        // maxLength steps, or -1 if there is none (0 when start == goal).
+        // If `path` is given it receives the tiles after start up to and
+        // including goal (cleared when there is no path).
+        virtual int search(const TraversalMasks& masks, Traversal who,
+                           const Tile& start, const Tile& goal,
+                           int maxLength, std::vector<Tile>* path) = 0;
+
+        // Multi-goal BFS: distance to the nearest tile t other than start
+        // with rank(t) >= 0, at most maxLength steps, or -1 if there is none.
+        // Among goals at that distance the lowest rank wins and is written
+        // to `found`. Same for every engine.
+        template <typename Rank>
+        int searchNearest(const TraversalMasks& masks, Traversal who,
+                          const Tile& start, int maxLength, Rank rank, Tile* found);
+
+        const PathStats& stats() const { return counters; }
+        void resetStats() { counters = PathStats{}; }
+
+    protected:
+        void countQuery(int expanded) { countQuery(expanded, expanded); }
+        void countQuery(int expanded, int scanned) {
+            ++counters.queries;
+            counters.expanded += static_cast<std::uint64_t>(expanded);
+            counters.lastExpanded = expanded;
+            counters.scanned += static_cast<std::uint64_t>(scanned);
+            counters.lastScanned = scanned;
+        }
+
+        SearchWorkspace work;
+
+    private:
+        PathStats counters;
+    };
+
+    std::unique_ptr<PathEngine> makePathEngine(PathAlgorithm algorithm);
+
+    template <typename Rank>
+    int PathEngine::searchNearest(const TraversalMasks& masks, Traversal who,
+                                  const Tile& start, int maxLength, Rank rank, Tile* found)
+    {
+        const int w = masks.width();
+        const int h = masks.height();
+        if (static_cast<unsigned>(start.x) >= static_cast<unsigned>(w) ||
+            static_cast<unsigned>(start.y) >= static_cast<unsigned>(h)) {
+            return -1;
+        }
+        const std::uint8_t* exits = masks.data(who);
+        const Direction dirs[4] = { Direction::Right, Direction::Left, Direction::Down, Direction::Up };
+        const int offsets[4] = { 1, -1, w, -w };
+
+        work.begin(static_cast<std::size_t>(w) * static_cast<std::size_t>(h));
+        const int s = start.y * w + start.x;
+        work.visit(s, -1, 0);
+        work.push(s);
+
+        int bestDist = -1;
+        int bestRank = 0;
+        int bestIndex = -1;
+        int expanded = 0;
+        while (!work.empty()) {
+            const int cur = work.pop();
+            const int d = work.distanceOf(cur);
+            // Everything left is at least as far as the goal already found
+            if (d >= maxLength || (bestDist >= 0 && d >= bestDist)) break;
+            ++expanded;
+            for (int k = 0; k < 4; ++k) {
+                if (!hasExit(exits[cur], dirs[k])) continue;
+                const int n = cur + offsets[k];
+                if (work.visited(n)) continue;
+                work.visit(n, cur, d + 1);
+                work.push(n);
+                const int r = rank(Tile{ n % w, n / w });
+                if (r >= 0 && (bestDist < 0 || r < bestRank)) {
+                    bestDist = d + 1;
+                    bestRank = r;
+                    bestIndex = n;
+                }
+            }
+        }
+        countQuery(expanded);
+
+        if (bestIndex >= 0 && found) {
+            *found = Tile{ bestIndex % w, bestIndex / w };
+        }
+        return bestDist;
+    }
+
+}
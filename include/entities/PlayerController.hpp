@@ -3,6 +3,7 @@
 #include <vector>
 #include <cstddef>
 #include "common/CommonTypes.hpp"
+#include "common/Traversal.hpp"
 
 namespace game {
 
@@ -59,12 +60,23 @@ namespace game {
     // Main Player Controller Class
     class PlayerController {
     public:
-        // Constructor: takes map reference and starting position
-        PlayerController(const MapGrid& mapGrid, const Tile& startPos);
+        // Constructor: takes map reference and starting position.
+        // totalCollectibles (dots + power pellets) skips the map scan when the
+        // level source already knows it, e.g. MapSystem's baked counts.
+        PlayerController(const MapGrid& mapGrid, const Tile& startPos, int totalCollectibles = -1);
 
         // Reset player to initial state (for new game or respawn)
         void reset(const Tile& startPos);
 
+        // Start a new level on the same (already reloaded) map.
+        // Rebuilds the exit masks and recounts collectibles unless
+        // totalCollectibles is given; score and lives carry over.
+        void startLevel(const Tile& startPos, int totalCollectibles = -1);
+
+        // The layout of tile (x, y) changed in place (e.g. a wall edit):
+        // refresh the exit masks around it
+        void onTileChanged(int x, int y);
+
         // Update player state each frame
         void update(double dt, const PlayerInput& input);
 
@@ -96,6 +108,7 @@ namespace game {
     private:
         // Map reference
         const MapGrid& map;
+        TraversalMasks traversal;  // exit masks of `map`, rebuilt per level
 
         // Player position and movement
         Tile position;
@@ -140,7 +153,6 @@ namespace game {
         static constexpr int MONSTER_BASE_SCORE = 200;
 
         // Helper functions - Movement
-        bool isWalkable(int x, int y) const;
         bool canMove(Direction dir) const;
         bool canTurn(Direction dir) const;
         bool isAtTileCenter() const;
@@ -148,6 +160,7 @@ namespace game {
         Direction getOppositeDirection(Direction dir) const;
         
         // Helper functions - Item collection
+        void countCollectibles(int totalCollectibles);
         void checkItemCollection();
         void collectDot();
         void collectPowerPellet();
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace game {
+
+    // Reusable scratch memory for grid searches over tile indices (y * width + x).
+    //
+    // Visited marks are generation stamps: begin() bumps the stamp instead of
+    // clearing, so starting a search is O(1). The queue is a ring buffer sized
+    // to the grid. After the first search on a map size nothing is allocated.
+    class SearchWorkspace {
+    public:
+        // Start a new search over `cellCount` tiles
+        void begin(std::size_t cellCount) {
+            if (stamp.size() != cellCount) {
+                stamp.assign(cellCount, 0);
+                parent.assign(cellCount, -1);
+                dist.assign(cellCount, 0);
+                ring.assign(cellCount > 0 ? cellCount : 1, 0);
+                current = 0;
+            }
+            if (++current == 0) {
+                // Stamp wrapped: old marks could alias, clear them once
+                std::fill(stamp.begin(), stamp.end(), 0u);
+                current = 1;
+            }
+            head = 0;
+            count = 0;
+        }
+
+        bool visited(int index) const { return stamp[static_cast<std::size_t>(index)] == current; }
+
+        void visit(int index, int from, int distance) {
+            const std::size_t i = static_cast<std::size_t>(index);
+            stamp[i] = current;
+            parent[i] = from;
+            dist[i] = distance;
+        }
+
+        // Valid only for tiles visited in the current search
+        int parentOf(int index) const { return parent[static_cast<std::size_t>(index)]; }
+        int distanceOf(int index) const { return dist[static_cast<std::size_t>(index)]; }
+
+        // FIFO of tile indices; a search that visits each tile once never overflows it
+        bool empty() const { return count == 0; }
+        void push(int index) {
+            ring[(head + count) % ring.size()] = index;
+            ++count;
+        }
+        int pop() {
+            const int index = ring[head];
+            head = (head + 1) % ring.size();
+            --count;
+            return index;
+        }
+
+    private:
+        std::vector<std::uint32_t> stamp;
+        std::vector<int> parent;
+        std::vector<int> dist;
+        std::vector<int> ring;
+        std::size_t head = 0;
+        std::size_t count = 0;
+        std::uint32_t current = 0;
+    };
+
+}
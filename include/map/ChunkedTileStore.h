@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "common/CommonTypes.hpp"
+
+// Sparse tile storage for very large levels, in 32x32-tile chunks.
+//
+// The pristine level is split into chunks and identical chunks are stored
+// once: every all-wall or all-path chunk shares one flyweight, and any other
+// repeated chunk is shared too. Memory therefore grows with the playable
+// area instead of width * height. Writes (collectible pickups) copy the
+// touched chunk on first write; reset() drops just those working copies, so
+// it costs O(dirty chunks) and reuses the copies' storage on the next level
+// run. Cells outside the map inside an edge chunk read as wall.
+class ChunkedTileStore {
+public:
+    static constexpr int CHUNK_SHIFT = 5;
+    static constexpr int CHUNK_SIZE = 1 << CHUNK_SHIFT;         // tiles per side
+    static constexpr int CHUNK_CELLS = CHUNK_SIZE * CHUNK_SIZE;
+
+    // Build the pristine chunks from a row-major tile array
+    void build(const std::uint8_t* cells, int width, int height);
+    void build(const game::MapGrid& grid) { build(grid.data(), grid.width(), grid.height()); }
+    void clear();
+
+    int width() const { return w; }
+    int height() const { return h; }
+    bool empty() const { return w == 0; }
+    int chunksX() const { return cw; }
+    int chunksY() const { return ch; }
+
+    bool inBounds(int x, int y) const {
+        return static_cast<unsigned>(x) < static_cast<unsigned>(w) &&
+               static_cast<unsigned>(y) < static_cast<unsigned>(h);
+    }
+
+    // Unchecked reads of the live and the pristine level
+    std::uint8_t at(int x, int y) const { return liveChunk(slotOf(x, y)).cells[cellOf(x, y)]; }
+    std::uint8_t pristineAt(int x, int y) const { return pristine[pristineSlots[slotOf(x, y)]].cells[cellOf(x, y)]; }
+
+    // Checked read: out-of-bounds cells read as `outside`
+    std::uint8_t get(int x, int y, std::uint8_t outside = game::tile::Wall) const {
+        return inBounds(x, y) ? at(x, y) : outside;
+    }
+
+    // Write one live cell, copying its chunk first if it is still shared
+    void set(int x, int y, std::uint8_t value);
+
+    // Live cells of the chunk covering (x, y) differ from the pristine level
+    bool isChunkDirty(int x, int y) const { return (liveSlots[slotOf(x, y)] & DIRTY_BIT) != 0; }
+    int dirtyChunkCount() const { return static_cast<int>(dirtySlots.size()); }
+
+    // Drop every working copy: the live level equals the pristine one again
+    void reset();
+
+    // Call fn(x, y, live, pristine) for every cell that differs from the
+    // pristine level; visits only dirty chunks
+    template <typename Fn>
+    void forEachChange(Fn&& fn) const {
+        for (std::uint32_t slot : dirtySlots) {
+            const Chunk& live = working[liveSlots[slot] & ~DIRTY_BIT];
+            const Chunk& base = pristine[pristineSlots[slot]];
+            const int x0 = static_cast<int>(slot % static_cast<std::uint32_t>(cw)) << CHUNK_SHIFT;
+            const int y0 = static_cast<int>(slot / static_cast<std::uint32_t>(cw)) << CHUNK_SHIFT;
+            for (int i = 0; i < CHUNK_CELLS; ++i) {
+                if (live.cells[i] != base.cells[i]) {
+                    fn(x0 + (i & (CHUNK_SIZE - 1)), y0 + (i >> CHUNK_SHIFT), live.cells[i], base.cells[i]);
+                }
+            }
+        }
+    }
+
+    // Live tiles equal to `code` in the whole map / the inclusive rectangle
+    int count(std::uint8_t code) const;
+    int countInRect(int x0, int y0, int x1, int y1, std::uint8_t code) const;
+
+    // Copy the live level into a dense grid
+    void copyTo(game::MapGrid& out) const;
+
+    // Footprint: distinct pristine chunks, working copies, and total bytes held
+    std::size_t uniqueChunkCount() const { return pristine.size(); }
+    std::size_t workingChunkCount() const { return working.size(); }
+    std::size_t memoryBytes() const;
+
+private:
+    struct Chunk {
+        std::array<std::uint8_t, CHUNK_CELLS> cells;
+    };
+
+    static constexpr std::uint32_t DIRTY_BIT = 0x80000000u;
+    static constexpr std::uint32_t WALL_CHUNK = 0;   // flyweights, always present
+    static constexpr std::uint32_t PATH_CHUNK = 1;
+
+    std::size_t slotOf(int x, int y) const {
+        return static_cast<std::size_t>(y >> CHUNK_SHIFT) * cw + static_cast<std::size_t>(x >> CHUNK_SHIFT);
+    }
+    static int cellOf(int x, int y) {
+        return ((y & (CHUNK_SIZE - 1)) << CHUNK_SHIFT) | (x & (CHUNK_SIZE - 1));
+    }
+    const Chunk& liveChunk(std::size_t slot) const {
+        const std::uint32_t ref = liveSlots[slot];
+        return (ref & DIRTY_BIT) ? working[ref & ~DIRTY_BIT] : pristine[ref];
+    }
+
+    int w = 0;
+    int h = 0;
+    int cw = 0;   // chunks per row
+    int ch = 0;   // chunk rows
+    std::vector<Chunk> pristine;                 // distinct chunks of the loaded level
+    std::vector<std::uint32_t> pristineSlots;    // chunk slot -> pristine index
+    std::vector<std::uint32_t> liveSlots;        // pristine index, or DIRTY_BIT | working index
+    std::vector<Chunk> working;                  // copy-on-write copies (kept for reuse)
+    std::vector<std::uint32_t> freeWorking;      // working copies not in use
+    std::vector<std::uint32_t> dirtySlots;       // slots currently pointing at a working copy
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "common/CommonTypes.hpp"
+
+// Level file format (.lvl), plain text:
+//
+//     <width> <height>
+//     ###################
+//     #........P........#
+//     ...                      (exactly <height> rows of <width> characters)
+//
+// Characters: '#' wall, ' ' path, '.' energy dot, 'O' power pellet,
+// 'G' ghost house, 'D' ghost door, 'P' player start (one), 'M' monster start.
+// Lines starting with ';' before the size header are comments.
+// Rows may end in "\n" or "\r\n".
+
+// A parsed level, ready to hand to MapSystem::loadLevel(const LevelData&)
+struct LevelData {
+    std::string name;
+    game::MapGrid tiles;                    // TileType per byte
+    game::Tile playerStart;
+    std::vector<game::Tile> monsterStarts;
+    std::vector<game::Tile> ghostHouse;     // every 'G' tile, row-major order
+    std::vector<game::Tile> ghostDoors;     // every 'D' tile, row-major order
+    int energyDots = 0;
+    int powerPellets = 0;
+};
+
+// Read-only memory mapping of a whole file. The view stays valid until
+// close() or destruction.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return view != nullptr; }
+    const char* data() const { return static_cast<const char*>(view); }
+    std::size_t size() const { return length; }
+
+private:
+    void* view = nullptr;
+    std::size_t length = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+namespace LevelLoader {
+
+    // Largest accepted side length; keeps width * height well inside int range
+    constexpr int MAX_LEVEL_SIDE = 16384;
+
+    // Parse the .lvl text format in a single pass straight into out.tiles.
+    // On failure returns false and, if error is given, describes the problem.
+    bool parseLevelText(const char* text, std::size_t length, LevelData& out,
+                        std::string* error = nullptr);
+
+    // Parse `height` rows of `width` characters (e.g. compiled-in maps)
+    bool parseLevelRows(const char* const* rows, int width, int height, LevelData& out,
+                        std::string* error = nullptr);
+
+    // Memory-map and parse one level file
+    bool loadLevelFile(const std::string& path, LevelData& out, std::string* error = nullptr);
+
+    // Load every *.lvl file in a directory, ordered by file name.
+    // Files that fail to parse are skipped and reported through errors.
+    std::vector<LevelData> loadLevelDirectory(const std::string& directory,
+                                              std::vector<std::string>* errors = nullptr);
+
+    // Serialize a level back to the .lvl text format
+    std::string toLevelText(const LevelData& level);
+
+    // Write a level to disk in the .lvl text format
+    bool saveLevelFile(const std::string& path, const LevelData& level);
+
+}
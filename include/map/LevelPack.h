@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "common/CommonTypes.hpp"
+#include "map/LevelLoader.h"
+
+// Precompiled binary level pack (.pack), produced offline by levelpack_compiler.
+//
+// Layout (little-endian, every section 8-byte aligned):
+//
+//     PackHeader
+//     PackIndexEntry[levelCount]          // where each level record lives
+//     per level:
+//         LevelRecord                     // sizes, player start, section offsets
+//         tiles       width * height bytes, row-major tile codes (tile::Path..Door)
+//         spawns      int32 x, y pairs:  monsters, ghost house tiles, ghost doors
+//
+// All offsets inside a LevelRecord are relative to the start of that record.
+// Loading a level is a bounds-checked memcpy of the tile section, or a direct
+// pointer into the mapped file through LevelPackView, plus the baked item
+// counts and spawn lists. open() checks the structure only, O(levels); the
+// tile bytes of a level are checked once, by verify() on its first load.
+// Walkability is not baked: TraversalMasks derives it from the tiles.
+namespace levelpack {
+
+    constexpr char MAGIC[4] = { 'P', 'M', 'L', 'P' };
+    constexpr std::uint32_t VERSION = 3;
+    constexpr std::uint32_t ENDIAN_TAG = 0x01020304u;
+    constexpr std::size_t NAME_SIZE = 32;
+
+    struct PackHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t endianTag;
+        std::uint32_t levelCount;
+    };
+
+    struct PackIndexEntry {
+        std::uint64_t offset;  // from start of file
+        std::uint64_t size;
+    };
+
+    struct LevelRecord {
+        char name[NAME_SIZE];
+        std::uint32_t width;
+        std::uint32_t height;
+        std::int32_t playerX;
+        std::int32_t playerY;
+        std::uint32_t monsterCount;
+        std::uint32_t houseCount;
+        std::uint32_t doorCount;
+        std::uint32_t energyDots;      // item counts of the tiles, baked by write()
+        std::uint32_t powerPellets;
+        std::uint64_t tilesOffset;
+        std::uint64_t monstersOffset;
+        std::uint64_t houseOffset;
+        std::uint64_t doorOffset;
+    };
+
+    struct PackedTile {
+        std::int32_t x;
+        std::int32_t y;
+    };
+
+}
+
+// Zero-copy view of one level inside a mapped pack; valid while the pack is open
+struct LevelPackView {
+    std::string name;
+    int width = 0;
+    int height = 0;
+    int energyDots = 0;                                  // baked counts
+    int powerPellets = 0;
+    game::Tile playerStart;
+    const std::uint8_t* tiles = nullptr;                 // width * height
+    const levelpack::PackedTile* monsterStarts = nullptr;
+    int monsterCount = 0;
+    const levelpack::PackedTile* ghostHouse = nullptr;
+    int houseCount = 0;
+    const levelpack::PackedTile* ghostDoors = nullptr;
+    int doorCount = 0;
+};
+
+class LevelPack {
+public:
+    // Map a pack file and validate every level record against the file size:
+    // offsets, spawn bounds and baked counts (no larger than the level).
+    // Tile bytes are not read here; see verify().
+    bool open(const std::string& path, std::string* error = nullptr);
+    void close();
+
+    bool isOpen() const { return file.isOpen(); }
+    int levelCount() const { return static_cast<int>(views.size()); }
+
+    // index is 0-based
+    const LevelPackView& level(int index) const { return views[index]; }
+
+    // Check one level's tile bytes: known tile codes only, and dots / pellets
+    // matching the baked counts. Scans the level the first time it is asked,
+    // then answers from memory.
+    bool verify(int index, std::string* error = nullptr);
+
+    // Copy one verified level out of the pack into a LevelData
+    bool extract(int index, LevelData& out, std::string* error = nullptr);
+
+    // Compile parsed levels into a pack file
+    static bool write(const std::string& path, const std::vector<LevelData>& levels,
+                      std::string* error = nullptr);
+
+private:
+    MappedFile file;
+    std::vector<LevelPackView> views;
+    std::vector<bool> verified;  // per level: verify() passed
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// One modified tile of the live map
+struct TileChange {
+    int x;
+    int y;
+    std::uint8_t before;  // TileType values
+    std::uint8_t after;
+
+    // Listeners get x = y = -1 when a new level replaced the whole map
+    bool wholeMap() const { return x < 0; }
+};
+
+// Append-only record of live-map edits kept by MapSystem: pickups, resets and
+// setTile() edits. Consumers either subscribe (called synchronously on every
+// change) or keep a Cursor and drain what happened since, e.g. once per tick,
+// then update their caches incrementally instead of rescanning the grid.
+//
+// Only the latest `retain` changes are kept. A cursor that fell further
+// behind, or that predates the current level, cannot be drained; drain()
+// then returns false and the consumer rebuilds from the full map.
+class MapJournal {
+public:
+    struct Cursor {
+        std::uint64_t generation = 0;  // level the cursor belongs to
+        std::uint64_t sequence = 0;    // changes seen so far in that level
+    };
+    using Listener = std::function<void(const TileChange& change)>;
+
+    explicit MapJournal(std::size_t retain = 4096) : retainCount(retain > 0 ? retain : 1) {
+        entries.reserve(retainCount * 2);
+    }
+
+    // Log one change (no-op when before == after) and notify listeners
+    void record(int x, int y, std::uint8_t before, std::uint8_t after) {
+        if (before == after) {
+            return;
+        }
+        if (entries.size() >= retainCount * 2) {
+            // Keep the newest half; amortised O(1) per change, no reallocation
+            const std::size_t drop = entries.size() - retainCount;
+            entries.erase(entries.begin(), entries.begin() + static_cast<std::ptrdiff_t>(drop));
+            firstSequence += drop;
+        }
+        const TileChange change{ x, y, before, after };
+        entries.push_back(change);
+        for (const auto& listener : listeners) {
+            listener.second(change);
+        }
+    }
+
+    // A new level replaced every tile: old cursors become stale
+    void restart() {
+        ++currentGeneration;
+        firstSequence = 0;
+        entries.clear();
+        const TileChange whole{ -1, -1, 0, 0 };
+        for (const auto& listener : listeners) {
+            listener.second(whole);
+        }
+    }
+
+    // Position just after the newest change
+    Cursor cursor() const { return Cursor{ currentGeneration, firstSequence + entries.size() }; }
+
+    // Call fn(change) for every change after `from`, oldest first, and move
+    // `from` to the end. Returns false (calling nothing) if some of those
+    // changes are gone; `from` still moves to the end.
+    template <typename Fn>
+    bool drain(Cursor& from, Fn&& fn) const {
+        const Cursor end = cursor();
+        if (from.generation != currentGeneration || from.sequence < firstSequence) {
+            from = end;
+            return false;
+        }
+        for (std::size_t i = static_cast<std::size_t>(from.sequence - firstSequence); i < entries.size(); ++i) {
+            fn(entries[i]);
+        }
+        from = end;
+        return true;
+    }
+
+    bool drain(Cursor& from, std::vector<TileChange>& out) const {
+        out.clear();
+        return drain(from, [&](const TileChange& change) { out.push_back(change); });
+    }
+
+    // Returns an id for unsubscribe()
+    int subscribe(Listener listener) {
+        listeners.emplace_back(++lastListenerId, std::move(listener));
+        return lastListenerId;
+    }
+
+    void unsubscribe(int id) {
+        for (auto it = listeners.begin(); it != listeners.end(); ++it) {
+            if (it->first == id) {
+                listeners.erase(it);
+                return;
+            }
+        }
+    }
+
+    std::uint64_t generation() const { return currentGeneration; }
+
+private:
+    std::size_t retainCount;
+    std::vector<TileChange> entries;
+    std::uint64_t firstSequence = 0;      // sequence number of entries[0]
+    std::uint64_t currentGeneration = 0;
+    std::vector<std::pair<int, Listener>> listeners;
+    int lastListenerId = 0;
+};
@@ -1,6 +1,15 @@
 #pragma once
 
+#include <cassert>
+#include <cstdint>
+#include <string>
 #include <vector>
+#include "common/Bitboard.hpp"
+#include "common/CommonTypes.hpp"
+#include "map/ChunkedTileStore.h"
+#include "map/LevelLoader.h"
+#include "map/LevelPack.h"
+#include "map/MapJournal.h"
 
 enum TileType {
     EMPTY = 0,         // Walkable empty path
@@ -16,14 +25,48 @@ struct Position {
     int y;
 };
 
+// How MapSystem holds the live level
+enum class MapStorage {
+    Dense,    // one byte per tile; getMapGrid() / getTileLayers() available
+    Chunked   // ChunkedTileStore: memory scales with the playable area, resets
+              // touch only dirty chunks. A MapSystem-only mode: there is no
+              // dense grid (hasMapGrid() is false, getMapGrid() asserts), so
+              // GameSession and the actors refuse it; query tiles through
+              // MapSystem or getChunkedTiles().
+};
+
 class MapSystem {
 public:
     MapSystem();
     ~MapSystem();
 
-    // Load a level (1, 2, or 3)
+    // Load a level by number (1..getLevelCount()). Uses the open level pack,
+    // else the levels registered with loadLevelDirectory(), else the three
+    // built-in maps.
     bool loadLevel(int levelId);
 
+    // Install an already parsed level of any size
+    bool loadLevel(const LevelData& level);
+
+    // Install a precompiled level straight from a mapped pack: one memcpy of
+    // the tiles, baked counts and spawn lists, no parsing. The view must have
+    // passed LevelPack::verify(); loadLevel(int) does that on first use.
+    bool loadLevel(const LevelPackView& level);
+
+    // Load a single .lvl file (see LevelLoader.h for the format)
+    bool loadLevelFile(const std::string& path);
+
+    // Register every .lvl file in a directory as levels 1..N (ordered by file name).
+    // Returns the number of levels registered; on 0 the built-in maps stay active.
+    int loadLevelDirectory(const std::string& directory);
+
+    // Map a precompiled .pack file (see LevelPack.h) and use its levels as 1..N.
+    // Returns the number of levels; on 0 the previous level source stays active.
+    int loadLevelPack(const std::string& path);
+
+    // Number of levels reachable through loadLevel(int)
+    int getLevelCount() const;
+
     // Get tile type at position
     TileType getTileAt(int x, int y) const;
 
@@ -33,6 +76,14 @@ public:
     // Remove collectible at position
     void removeCollectible(int x, int y);
 
+    // True if the collectible that started the level at (x, y) has been picked up
+    bool isCollected(int x, int y) const;
+
+    // Edit one tile of the live level (e.g. open or close a wall). Counts,
+    // bitboards and the ghost house / door lists follow; resetMapState()
+    // restores the level as loaded. Returns false out of bounds.
+    bool setTile(int x, int y, TileType type);
+
     // Get map dimensions
     int getWidth() const { return mapWidth; }
     int getHeight() const { return mapHeight; }
@@ -41,6 +92,8 @@ public:
     // Get initial positions
     Position getPlayerStart() const { return playerStartPos; }
     std::vector<Position> getMonsterStarts() const { return monsterStartPositions; }
+    const std::vector<Position>& getGhostHouseTiles() const { return ghostHouseTiles; }
+    const std::vector<Position>& getGhostDoorTiles() const { return ghostDoorTiles; }
 
     // Game state
     int getRemainingDots() const { return remainingEnergyDots; }
@@ -48,23 +101,94 @@ public:
     bool isLevelComplete() const;
     int getCurrentLevel() const { return currentLevelId; }
 
-    // Reset map state (restore all collectibles)
+    // Dots + power pellets left inside the inclusive rectangle [x0, x1] x [y0, y1]
+    int countItemsInRect(int x0, int y0, int x1, int y1) const;
+    bool anyItemsInRect(int x0, int y0, int x1, int y1) const;
+
+    // Reset map state (restore all collectibles). Restores only the tiles picked
+    // up since the level was loaded from the pristine snapshot: no reload, no
+    // I/O and no allocation.
     void resetMapState();
 
-    // Get the map grid in the format expected by game components
-    // Returns a 2D vector where: 0=path, 1=wall, 2=monster room, 3=dot, 4=power pellet
-    std::vector<std::vector<int>> getMapGrid() const;
+    // Print a summary to stdout whenever a level is installed (on by default)
+    void setVerbose(bool enabled) { verbose = enabled; }
+
+    // Storage for levels loaded from now on (Dense by default); the level
+    // already loaded keeps its storage until the next load
+    void setStorage(MapStorage storage) { requestedStorage = storage; }
+    // Storage of the loaded level
+    MapStorage getStorage() const { return storageMode; }
+
+    // Live chunks in Chunked mode (empty in Dense mode)
+    const ChunkedTileStore& getChunkedTiles() const { return chunks; }
+
+    // Every change to the live map: pickups, resets and setTile() edits, plus
+    // a whole-map restart on each level load. Subscribe, or drain it once per
+    // tick, to update caches incrementally (see MapJournal.h).
+    MapJournal& getJournal() { return journal; }
+    const MapJournal& getJournal() const { return journal; }
+
+    // Read-only view of the live map, in the format expected by game components.
+    // Cells hold TileType values: 0=path, 1=wall, 2=monster room, 3=dot, 4=power pellet, 5=door.
+    // The reference stays valid for the lifetime of the MapSystem, across loadLevel() and
+    // removeCollectible(), so consumers can hold it instead of copying the grid.
+    // Dense storage only: Chunked mode keeps no contiguous grid, so this and the
+    // two accessors below assert there; check hasMapGrid() and read tiles through
+    // getTileAt() / getChunkedTiles() instead.
+    const game::MapGrid& getMapGrid() const {
+        assert(hasMapGrid() && "getMapGrid(): no dense grid in Chunked storage");
+        return tileMap;
+    }
+    bool hasMapGrid() const { return storageMode == MapStorage::Dense; }
+
+    // The level exactly as loaded, before any pickups
+    const game::MapGrid& getPristineMap() const {
+        assert(hasMapGrid() && "getPristineMap(): no dense grid in Chunked storage");
+        return pristineMap;
+    }
+
+    // Per-row bitmasks of walls, dots, pellets, ghost house and doors, kept in
+    // step with the live map. Same lifetime guarantee as getMapGrid().
+    const game::TileLayers& getTileLayers() const {
+        assert(hasMapGrid() && "getTileLayers(): no bitboards in Chunked storage");
+        return layers;
+    }
 
 private:
-    TileType parseTileType(char c);
+    // Unchecked live tile read for either storage
+    std::uint8_t tileAt(int x, int y) const {
+        return storageMode == MapStorage::Chunked ? chunks.at(x, y) : tileMap.at(x, y);
+    }
+    void writeTile(int x, int y, std::uint8_t before, std::uint8_t after);
+    void moveLayerBit(int x, int y, std::uint8_t before, std::uint8_t after);
+    void restoreHouseLists();
+    void takeSnapshot(int energyDots = -1, int powerPellets = -1);
+    void logLevelLoaded(const std::string& name) const;
 
     int tileSize;
     int currentLevelId;
+    std::vector<LevelData> levelLibrary; // levels registered by loadLevelDirectory()
+    LevelPack levelPack;                 // levels from loadLevelPack()
     int mapWidth;
     int mapHeight;
-    std::vector<std::vector<TileType>> tileMap;
+    MapStorage storageMode;       // storage of the loaded level
+    MapStorage requestedStorage;  // applied by the next load
+    game::MapGrid tileMap;  // row-major, one TileType per byte (Dense mode)
+    ChunkedTileStore chunks;                   // live + pristine level (Chunked mode)
+    game::TileLayers layers;                   // bitboards mirroring tileMap
+    game::MapGrid pristineMap;                 // immutable copy taken at load
+    std::vector<std::uint64_t> collectedMask;  // 1 bit per tile: picked up since load
+    std::vector<std::uint64_t> changedMask;    // 1 bit per tile: listed in collectedTiles
+    std::vector<int> collectedTiles;           // tile indices changed since load (pickups, edits), each once
+    MapJournal journal;
+    bool houseListsEdited;                     // setTile() touched a house / door tile
+    int levelEnergyDots;
+    int levelPowerPellets;
+    bool verbose;
     Position playerStartPos;
     std::vector<Position> monsterStartPositions;
+    std::vector<Position> ghostHouseTiles;
+    std::vector<Position> ghostDoorTiles;
     int remainingEnergyDots;
     int remainingPowerPellets;
 };
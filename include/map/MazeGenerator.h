@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "map/LevelLoader.h"
+
+// Settings for MazeGenerator::generate(). The same config (seed included)
+// always yields the same level, on every platform.
+struct MazeConfig {
+    int width = 64;                 // tiles, 15..LevelLoader::MAX_LEVEL_SIDE
+    int height = 64;
+    std::uint64_t seed = 1;
+    double loopDensity = 0.15;      // chance to knock out each wall between two corridors (0..1)
+    bool removeDeadEnds = true;     // braid every remaining dead end into a loop
+    int ghostHouses = 1;            // the first one is centred, the rest placed at random
+    int monstersPerHouse = 3;       // 0..3, on the middle row of each house
+    double dotDensity = 1.0;        // chance for each corridor tile to hold a dot (0..1)
+    int powerPellets = 4;           // placed near the corners first, then at random
+    std::string name;               // defaults to "maze_<w>x<h>_<seed>"
+};
+
+// Seeded maze generator producing levels in the same form as the .lvl loader.
+//
+// Corridors are carved on the odd rows / columns with an iterative
+// backtracker, then opened up into loops. Each ghost house copies the
+// built-in layout: a row of doors over "GMMMG" / "GGGGG", ringed by a
+// corridor that joins the maze. Even widths or heights leave a double outer
+// wall on the right / bottom edge.
+namespace MazeGenerator {
+
+    // On failure (size out of range, houses do not fit) returns false and,
+    // if error is given, describes the problem.
+    bool generate(const MazeConfig& config, LevelData& out, std::string* error = nullptr);
+
+}
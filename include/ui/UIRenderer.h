@@ -5,6 +5,7 @@
 #include <unordered_map>
 #include <vector>
 #include "external/fssimplewindow.h"
+#include "common/Bitboard.hpp"
 #include "entities/MonsterSystem.hpp"
 
 namespace game {
@@ -76,6 +77,20 @@ public:
     UIAssetsConfig assets;
     bool debugOverlay = false;
 
+    // Bind the live map (e.g. MapSystem::getMapGrid()); the renderer keeps the
+    // reference and reads it every frame, so pickups and level loads show up
+    // without handing it a new grid.
+    void setMap(const MapGrid& map);
+
+    // Optionally bind dot / pellet bitboards that mirror the map (e.g. from
+    // MapSystem::getTileLayers()). The items layer then visits only set bits
+    // instead of testing every tile; without them it falls back to a grid scan.
+    void setItemLayers(const TileBitboard& dots, const TileBitboard& pellets);
+
+    void drawFrame(GameScreenState state,
+                   const PlayerRenderInfo& player,
+                   const std::vector<GhostRenderInfo>& ghosts);
+
     void drawFrame(GameScreenState state,
                    const PlayerRenderInfo& player,
                    const std::vector<GhostRenderInfo>& ghosts,
@@ -104,6 +119,8 @@ private:
     void drawBackground();
     void drawMapLayer(const MapGrid& map);
     void drawItemsLayer(const MapGrid& map);
+    void drawDot(int x, int y, const TextureHandle& texture);
+    void drawPellet(int x, int y, const TextureHandle& texture, double now);
     void drawPlayerSprite(const PlayerRenderInfo& player);
     void drawMonsters(const std::vector<GhostRenderInfo>& ghosts);
     void drawHUD(const PlayerRenderInfo& player);
@@ -130,6 +147,9 @@ private:
                   unsigned char a = 255);
 
     TextureManager& textures;
+    const MapGrid* boundMap = nullptr;
+    const TileBitboard* boundDots = nullptr;
+    const TileBitboard* boundPellets = nullptr;
     MapGeometry mapGeom;
     int viewportWidth = 0;
     int viewportHeight = 0;
@@ -1,8 +1,9 @@
 #include "external/fssimplewindow.h"
 #include "map/MapSystem.h"
-#include "entities/PlayerController.hpp"
-#include "entities/MonsterSystem.hpp"
+#include "core/GameSession.hpp"
 #include "ui/UIRenderer.h"
+#include "common/SimulationClock.hpp"
+#include <algorithm>
 #include <iostream>
 #include <chrono>
 #include <filesystem>
@@ -28,43 +29,47 @@ int main() {
     const int windowHeight = 768;
     FsOpenWindow(0, 0, windowWidth, windowHeight, 1, "The Wandering Earth - Pacman");
     
-    // Initialize MapSystem
+    // Initialize MapSystem: precompiled level pack, else assets/levels/*.lvl, else built-in maps
     MapSystem mapSystem;
+    if (mapSystem.loadLevelPack("assets/levels/levels.pack") == 0) {
+        mapSystem.loadLevelDirectory("assets/levels");
+    }
     int currentLevel = 1;
     if (!mapSystem.loadLevel(currentLevel)) {
         std::cerr << "Failed to load level " << currentLevel << std::endl;
         return 1;
     }
     
-    // Get map grid for game components (store as shared reference)
-    MapGrid mapGrid = mapSystem.getMapGrid();
-    
-    // Initialize PlayerController (takes const reference, so it will see updates to mapGrid)
-    Position playerStart = mapSystem.getPlayerStart();
-    Tile playerStartTile{playerStart.x, playerStart.y};
-    PlayerController playerController(mapGrid, playerStartTile);
+    // Shared read-only view of the live map; MapSystem owns the only copy
+    const MapGrid& mapGrid = mapSystem.getMapGrid();
     
-    // Initialize MonsterSystem (also takes const reference)
-    std::vector<Position> monsterStarts = mapSystem.getMonsterStarts();
-    std::vector<Tile> monsterSpawnTiles;
-    for (const auto& pos : monsterStarts) {
-        monsterSpawnTiles.push_back(Tile{pos.x, pos.y});
-    }
-    MonsterSystem monsterSystem(mapGrid, monsterSpawnTiles);
+    // Player, ghosts and the rules between them; the session reads the
+    // shared map and follows its level loads and edits
+    GameSession session(mapSystem, currentLevel);
     
     // Initialize UIRenderer
     TextureManager textureManager;
     UIRenderer renderer(textureManager);
     renderer.setViewport(windowWidth, windowHeight);
     renderer.setTileSize(32);
+    renderer.setMap(mapGrid);
+    renderer.setItemLayers(mapSystem.getTileLayers().dots, mapSystem.getTileLayers().pellets);
     
     // Game state
     GameScreenState gameState = GameScreenState::Menu;
     bool running = true;
-    double lastTime = 0.0;
+    // Frame time and pacing both come from steady_clock; FsPassedTime()
+    // returns time since its previous call, not an absolute time
+    using FrameClock = std::chrono::steady_clock;
+    FrameClock::time_point lastTime = FrameClock::now();
     const double targetFPS = 60.0;
     const double frameTime = 1.0 / targetFPS;
     
+    // The simulation runs in fixed 1/60 s ticks whatever the frame rate;
+    // each frame runs however many ticks its wall time covers
+    SimulationClock simClock(60.0);
+    const double fastForwardSpeed = 4.0;
+    
     // Input state
     PlayerInput playerInput;
     
@@ -72,20 +77,17 @@ int main() {
     std::cout << "Controls:" << std::endl;
     std::cout << "  Arrow Keys - Move player" << std::endl;
     std::cout << "  P - Pause/Resume" << std::endl;
+    std::cout << "  F - Fast-forward on/off" << std::endl;
     std::cout << "  ESC - Exit" << std::endl;
     std::cout << "  ENTER - Start game (from menu)" << std::endl;
     std::cout << "===================" << std::endl;
     
     // Main game loop
     while (running && FsCheckWindowOpen()) {
-        // Calculate delta time
-        long long currentTime = FsPassedTime();
-        double currentTimeSeconds = currentTime / 1000.0;
-        double dt = currentTimeSeconds - lastTime;
-        if (dt <= 0.0 || dt > 0.1) {
-            dt = frameTime; // Cap delta time to prevent large jumps
-        }
-        lastTime = currentTimeSeconds;
+        // Wall time since the last frame; the clock turns it into ticks
+        FrameClock::time_point frameStart = FrameClock::now();
+        double frameSeconds = std::chrono::duration<double>(frameStart - lastTime).count();
+        lastTime = frameStart;
         
         // Poll input
         FsPollDevice();
@@ -100,6 +102,8 @@ int main() {
             gameState = GameScreenState::Play;
         } else if (key == FSKEY_ENTER && gameState == GameScreenState::Menu) {
             gameState = GameScreenState::Play;
+        } else if (key == FSKEY_F) {
+            simClock.setSpeed(simClock.speed() > 1.0 ? 1.0 : fastForwardSpeed);
         }
         
         // Handle player input (only when playing)
@@ -115,118 +119,21 @@ int main() {
             playerInput.rightPressed = false;
         }
         
-        // Update game systems (only when playing)
+        // Update game systems (only when playing), one fixed tick at a time;
+        // time spent paused or in menus is not simulated later
+        int ticks = 0;
         if (gameState == GameScreenState::Play) {
-            // Update player
-            playerController.update(dt, playerInput);
-            
-            // Update player state for monster system (only if player is alive and not dying/respawning)
-            auto playerState = playerController.getState();
-            if (playerState == PlayerState::Normal || playerState == PlayerState::Powered) {
-                auto playerPos = playerController.getPosition();
-                auto playerDir = playerController.getDirection();
-                bool playerPowered = playerController.isPowered();
-                
-                // Create MonsterSystem's MonsterPlayerState struct
-                MonsterPlayerState msPlayerState;
-                msPlayerState.gridX = playerPos.x;
-                msPlayerState.gridY = playerPos.y;
-                msPlayerState.dir = playerDir;
-                msPlayerState.isPowered = playerPowered;
-                monsterSystem.setPlayerState(msPlayerState);
-            }
-            // If player is dying/respawning, don't update player state for monsters
-            // This prevents monsters from chasing a dead player
-            
-            // Update monsters
-            monsterSystem.update(dt);
-            
-            // Check player events
-            PlayerEvents playerEvents = playerController.pollEvents();
-            
-            // Handle player death - respawn is automatic, but check if game should end
-            if (playerEvents.playerDied) {
-                // When the player loses a life, also reset all ghosts so they return to their spawn positions and don't camp the respawn point.
-                monsterSystem.resetAllGhosts();
-                if (playerController.getLives() <= 0) {
-                    gameState = GameScreenState::GameOver;
-                }
-                // Player will automatically respawn via update() if lives > 0
-            }
-            
-            // Handle item collection - update map
-            if (playerEvents.dotCollected || playerEvents.powerPelletCollected) {
-                Tile playerPos = playerController.getPosition();
-                mapSystem.removeCollectible(playerPos.x, playerPos.y);
-                // Update map grid for rendering (remove collectible from grid)
-                if (playerPos.y >= 0 && playerPos.y < static_cast<int>(mapGrid.size()) &&
-                    playerPos.x >= 0 && playerPos.x < static_cast<int>(mapGrid[0].size())) {
-                    mapGrid[playerPos.y][playerPos.x] = 0; // Set to empty path
-                }
-            }
-            
-            // Check monster collisions
-            std::vector<GhostRenderInfo> ghostInfos = monsterSystem.getRenderInfo();
-            for (const auto& ghost : ghostInfos) {
-                Tile ghostPos{ghost.gridX, ghost.gridY};
-                if (playerController.checkMonsterCollision(ghostPos)) {
-                    // Player hit by monster
-                    monsterSystem.resetAllGhosts();
-                    if (playerController.getLives() <= 0) {
-                        gameState = GameScreenState::GameOver;
-                    }
-                }
-            }
-            
-            // Check monster events
-            MonsterEvents monsterEvents = monsterSystem.pollEvents();
-            if (monsterEvents.playerHit) {
-                if (playerController.getLives() <= 0) {
-                    gameState = GameScreenState::GameOver;
-                }
-            }
-            
-            // Check level completion
-            if (playerEvents.levelComplete || mapSystem.isLevelComplete()) {
-                // Advance to next level
-                currentLevel++;
-                if (currentLevel <= 3) {
-                    mapSystem.loadLevel(currentLevel);
-                    // Update mapGrid in place (resize and copy new data)
-                    MapGrid newMapGrid = mapSystem.getMapGrid();
-                    mapGrid = newMapGrid; // This creates a new vector, so we need to recreate controllers
-                    
-                    // Preserve player score and lives
-                    int savedScore = playerController.getScore();
-                    int savedLives = playerController.getLives();
-                    
-                    // Reset player with new map
-                    Position newPlayerStart = mapSystem.getPlayerStart();
-                    Tile newPlayerTile{newPlayerStart.x, newPlayerStart.y};
-                    playerController.reset(newPlayerTile);
-                    playerController.addScore(savedScore);
-                    playerController.setLives(savedLives);
-                    
-                    // Reconstruct monster system with new map
-                    std::vector<Position> newMonsterStarts = mapSystem.getMonsterStarts();
-                    std::vector<Tile> newMonsterSpawnTiles;
-                    for (const auto& pos : newMonsterStarts) {
-                        newMonsterSpawnTiles.push_back(Tile{pos.x, pos.y});
-                    }
-                    monsterSystem.~MonsterSystem();
-                    new (&monsterSystem) MonsterSystem(mapGrid, newMonsterSpawnTiles);
-                    
-                    std::cout << "Level " << currentLevel << " started!" << std::endl;
-                } else {
-                    // All levels completed - game won
-                    gameState = GameScreenState::GameOver;
-                    std::cout << "All levels completed! Game won!" << std::endl;
-                }
+            ticks = simClock.advance(frameSeconds);
+        }
+        const double dt = simClock.tickSeconds();
+        for (int tick = 0; tick < ticks && gameState == GameScreenState::Play; ++tick) {
+            if (session.step(dt, playerInput) != GameSession::Status::Playing) {
+                gameState = GameScreenState::GameOver;
             }
         }
         
         // Get render info - convert from PlayerController's PlayerControllerRenderInfo to UIRenderer's PlayerRenderInfo
-        auto playerInfo = playerController.getRenderInfo();
+        auto playerInfo = session.player().getRenderInfo();
         PlayerRenderInfo playerRenderInfo; // UIRenderer's version
         playerRenderInfo.gridX = playerInfo.gridX;
         playerRenderInfo.gridY = playerInfo.gridY;
@@ -237,8 +144,8 @@ int main() {
         playerRenderInfo.isPowered = playerInfo.isPowered;
         playerRenderInfo.pixelX = playerInfo.pixelX;
         playerRenderInfo.pixelY = playerInfo.pixelY;
-        playerRenderInfo.level = currentLevel;
-        std::vector<GhostRenderInfo> ghostRenderInfos = monsterSystem.getRenderInfo();
+        playerRenderInfo.level = session.level();
+        std::vector<GhostRenderInfo> ghostRenderInfos = session.monsters().getRenderInfo();
         
         // Handle window resize
         int w, h;
@@ -249,10 +156,13 @@ int main() {
         glClearColor(0.0f, 0.0f, 0.05f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         
-        renderer.drawFrame(gameState, playerRenderInfo, ghostRenderInfos, mapGrid);
+        renderer.drawFrame(gameState, playerRenderInfo, ghostRenderInfos);
         
         FsSwapBuffers();
-        FsSleep(16); // ~60 FPS
+        
+        // Pace rendering to ~60 FPS; the simulation catches up through the clock
+        double frameSpent = std::chrono::duration<double>(FrameClock::now() - frameStart).count();
+        FsSleep(std::max(0, static_cast<int>((frameTime - frameSpent) * 1000.0)));
     }
     
     FsCloseWindow();
@@ -0,0 +1,57 @@
+#include "common/SimulationClock.hpp"
+
+namespace game {
+
+    SimulationClock::SimulationClock(double tickRate) {
+        setTickRate(tickRate);
+    }
+
+    void SimulationClock::setTickRate(double ticksPerSecond) {
+        if (ticksPerSecond <= 0.0) {
+            return;
+        }
+        // Keep the carried time as the same fraction of a tick
+        const double fraction = accumulator / step;
+        rate = ticksPerSecond;
+        step = 1.0 / rate;
+        accumulator = fraction * step;
+    }
+
+    void SimulationClock::setMaxFrameTime(double seconds) {
+        if (seconds > 0.0) {
+            maxFrame = seconds;
+        }
+    }
+
+    void SimulationClock::setSpeed(double speedMultiplier) {
+        if (speedMultiplier > 0.0) {
+            multiplier = speedMultiplier;
+        }
+    }
+
+    int SimulationClock::advance(double realSeconds) {
+        if (realSeconds <= 0.0) {
+            return 0;
+        }
+        if (realSeconds > maxFrame) {
+            dropped += realSeconds - maxFrame;
+            realSeconds = maxFrame;
+        }
+
+        accumulator += realSeconds * multiplier;
+        int due = 0;
+        while (accumulator >= step) {
+            accumulator -= step;
+            ++due;
+        }
+        tickCount += static_cast<std::uint64_t>(due);
+        return due;
+    }
+
+    void SimulationClock::reset() {
+        accumulator = 0.0;
+        dropped = 0.0;
+        tickCount = 0;
+    }
+
+}
@@ -0,0 +1,84 @@
+#include "common/WorkerPool.hpp"
+
+#include <algorithm>
+
+namespace game {
+
+    WorkerPool::WorkerPool(unsigned count) {
+        for (unsigned worker = 1; worker < count; ++worker) {
+            threads.emplace_back(&WorkerPool::threadLoop, this, worker);
+        }
+    }
+
+    WorkerPool::~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    void WorkerPool::parallelFor(std::size_t count, std::size_t grain, const ChunkFn& fn) {
+        if (count == 0) {
+            return;
+        }
+        grain = std::max<std::size_t>(grain, 1);
+        if (threads.empty() || count <= grain) {
+            fn(0, count, 0);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            job = &fn;
+            jobCount = count;
+            jobGrain = grain;
+            nextItem.store(0, std::memory_order_relaxed);
+            running = static_cast<unsigned>(threads.size());
+            ++generation;
+        }
+        wake.notify_all();
+
+        runChunks(0);
+
+        // Every pool thread leaves the job before the next one is posted
+        std::unique_lock<std::mutex> guard(lock);
+        finished.wait(guard, [this] { return running == 0; });
+        job = nullptr;
+    }
+
+    void WorkerPool::threadLoop(unsigned worker) {
+        std::uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                wake.wait(guard, [&] { return stopping || generation != seen; });
+                if (stopping) {
+                    return;
+                }
+                seen = generation;
+            }
+            runChunks(worker);
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                if (--running == 0) {
+                    finished.notify_one();
+                }
+            }
+        }
+    }
+
+    void WorkerPool::runChunks(unsigned worker) {
+        for (;;) {
+            const std::size_t begin = nextItem.fetch_add(jobGrain, std::memory_order_relaxed);
+            if (begin >= jobCount) {
+                return;
+            }
+            (*job)(begin, std::min(begin + jobGrain, jobCount), worker);
+        }
+    }
+
+}
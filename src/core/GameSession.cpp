@@ -0,0 +1,174 @@
+#include "core/GameSession.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace game {
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        // Chunked storage has no dense grid for the actors; the session then
+        // binds them to an empty one and refuses to play (see GameSession())
+        const MapGrid& liveGridOf(const MapSystem& mapSystem) {
+            static const MapGrid none;
+            return mapSystem.hasMapGrid() ? mapSystem.getMapGrid() : none;
+        }
+
+        Tile playerStartOf(const MapSystem& mapSystem) {
+            Position start = mapSystem.getPlayerStart();
+            return Tile{ start.x, start.y };
+        }
+
+        std::vector<Tile> monsterSpawnsOf(const MapSystem& mapSystem) {
+            std::vector<Tile> spawns;
+            if (!mapSystem.hasMapGrid()) return spawns;
+            for (const auto& pos : mapSystem.getMonsterStarts()) {
+                spawns.push_back(Tile{ pos.x, pos.y });
+            }
+            return spawns;
+        }
+
+        int collectiblesOf(const MapSystem& mapSystem) {
+            return mapSystem.getRemainingDots() + mapSystem.getRemainingPellets();
+        }
+
+        // Adds the time since `start` to *total when profiling, and restarts
+        void lap(double* total, Clock::time_point& start) {
+            if (!total) return;
+            const Clock::time_point now = Clock::now();
+            *total += std::chrono::duration<double>(now - start).count();
+            start = now;
+        }
+    }
+
+    GameSession::GameSession(MapSystem& mapSystem, int level)
+        : maps(mapSystem),
+          playerController(liveGridOf(mapSystem), playerStartOf(mapSystem), collectiblesOf(mapSystem)),
+          monsterSystem(liveGridOf(mapSystem), monsterSpawnsOf(mapSystem)),
+          currentLevel(level)
+    {
+        if (!maps.hasMapGrid()) {
+            std::cout << "Error: GameSession needs Dense map storage; Chunked levels are MapSystem-only" << std::endl;
+            state = Status::GameOver;
+            return;
+        }
+
+        // Layout edits (setTile) refresh the actors' exit masks around the tile;
+        // pickups never change walkability, and level loads go through startLevel()
+        journalListener = maps.getJournal().subscribe([this](const TileChange& change) {
+            if (change.wholeMap() || TraversalMasks::sameRules(change.before, change.after)) {
+                return;
+            }
+            playerController.onTileChanged(change.x, change.y);
+            monsterSystem.onTileChanged(change.x, change.y);
+        });
+    }
+
+    GameSession::~GameSession() {
+        maps.getJournal().unsubscribe(journalListener);
+    }
+
+    GameSession::Status GameSession::step(double dt, const PlayerInput& input) {
+        if (state != Status::Playing) {
+            return state;
+        }
+        Clock::time_point start;
+        if (profile) start = Clock::now();
+
+        // Update player
+        playerController.update(dt, input);
+
+        // Update player state for monster system (only if player is alive and not dying/respawning)
+        PlayerState playerState = playerController.getState();
+        if (playerState == PlayerState::Normal || playerState == PlayerState::Powered) {
+            MonsterPlayerState msPlayerState;
+            msPlayerState.gridX = playerController.getPosition().x;
+            msPlayerState.gridY = playerController.getPosition().y;
+            msPlayerState.dir = playerController.getDirection();
+            msPlayerState.isPowered = playerController.isPowered();
+            monsterSystem.setPlayerState(msPlayerState);
+        }
+        // If player is dying/respawning, don't update player state for monsters
+        // This prevents monsters from chasing a dead player
+        lap(profile ? &profile->player : nullptr, start);
+
+        monsterSystem.update(dt);
+        lap(profile ? &profile->monsters : nullptr, start);
+
+        PlayerEvents playerEvents = playerController.pollEvents();
+
+        // Handle player death - respawn is automatic, but check if game should end
+        if (playerEvents.playerDied) {
+            // When the player loses a life, also reset all ghosts so they return to their spawn positions and don't camp the respawn point.
+            monsterSystem.resetAllGhosts();
+            if (playerController.getLives() <= 0) {
+                state = Status::GameOver;
+            }
+        }
+
+        // Handle item collection - update map
+        if (playerEvents.dotCollected || playerEvents.powerPelletCollected) {
+            Tile playerPos = playerController.getPosition();
+            maps.removeCollectible(playerPos.x, playerPos.y);
+        }
+
+        // Monster collisions: MonsterSystem decides every contact on the
+        // player's tile; apply each one to the player
+        Tile playerTile = playerController.getPosition();
+        MonsterEvents monsterEvents = monsterSystem.pollEvents();
+        const int contacts = monsterEvents.hits + monsterEvents.ghostsEaten;
+        for (int k = 0; k < contacts; ++k) {
+            if (playerController.checkMonsterCollision(playerTile)) {
+                // Player hit by monster
+                monsterSystem.resetAllGhosts();
+                if (playerController.getLives() <= 0) {
+                    state = Status::GameOver;
+                }
+            }
+        }
+        if (monsterEvents.playerHit && playerController.getLives() <= 0) {
+            state = Status::GameOver;
+        }
+        lap(profile ? &profile->rules : nullptr, start);
+
+        // Check level completion
+        if (playerEvents.levelComplete || maps.isLevelComplete()) {
+            startNextLevel();
+            lap(profile ? &profile->levelLoad : nullptr, start);
+        }
+        return state;
+    }
+
+    void GameSession::startNextLevel() {
+        currentLevel++;
+        if (currentLevel > maps.getLevelCount()) {
+            // All levels completed - game won
+            state = Status::Won;
+            if (verbose) {
+                std::cout << "All levels completed! Game won!" << std::endl;
+            }
+            return;
+        }
+
+        // Reloads the shared grid in place; every holder of the grid sees the new level
+        maps.loadLevel(currentLevel);
+        if (!maps.hasMapGrid()) {
+            std::cout << "Error: level " << currentLevel << " was loaded with Chunked storage; GameSession needs Dense" << std::endl;
+            state = Status::GameOver;
+            return;
+        }
+
+        // Restart player on the new map (score and lives carry over)
+        playerController.startLevel(playerStartOf(maps), collectiblesOf(maps));
+
+        // Respawn monsters at the new level's spawns
+        monsterSystem.startLevel(monsterSpawnsOf(maps));
+
+        if (verbose) {
+            std::cout << "Level " << currentLevel << " started!" << std::endl;
+        }
+    }
+
+}
@@ -0,0 +1,623 @@
+#include "entities/CorridorGraph.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+namespace game {
+
+    namespace {
+        // Same neighbour order as the path engines: right, left, down, up
+        struct Step { Direction dir; int dx; int dy; };
+        const Step kSteps[4] = {
+            { Direction::Right,  1,  0 },
+            { Direction::Left,  -1,  0 },
+            { Direction::Down,   0,  1 },
+            { Direction::Up,     0, -1 },
+        };
+
+        constexpr int Infinity = std::numeric_limits<int>::max() / 4;
+
+        Direction reverseOf(Direction d) {
+            switch (d) {
+                case Direction::Right: return Direction::Left;
+                case Direction::Left:  return Direction::Right;
+                case Direction::Down:  return Direction::Up;
+                case Direction::Up:    return Direction::Down;
+                default:               return Direction::None;
+            }
+        }
+
+        // Smallest f first; on ties the deeper entry
+        struct EntryAfter {
+            template <typename E>
+            bool operator()(const E& a, const E& b) const {
+                return a.f != b.f ? a.f > b.f : a.g < b.g;
+            }
+        };
+    }
+
+    // Scratch
+
+    void CorridorGraph::Scratch::begin(std::size_t n) {
+        if (seen.size() != n) {
+            seen.assign(n, 0);
+            cost.resize(n);
+            via.resize(n);
+            origin.resize(n);
+            stamp = 0;
+        }
+        if (++stamp == 0) {
+            std::fill(seen.begin(), seen.end(), 0u);
+            stamp = 1;
+        }
+        heap.clear();
+    }
+
+    bool CorridorGraph::Scratch::improve(int i, int g, int f, int through, int from) {
+        const std::size_t at = static_cast<std::size_t>(i);
+        if (seen[at] == stamp && cost[at] <= g) {
+            return false;
+        }
+        seen[at] = stamp;
+        cost[at] = g;
+        via[at] = through;
+        origin[at] = from;
+        heap.push_back(Entry{ f, g, i });
+        std::push_heap(heap.begin(), heap.end(), EntryAfter{});
+        return true;
+    }
+
+    // Next live entry; entries superseded by a cheaper improve() are skipped
+    bool CorridorGraph::Scratch::pop(Entry& out) {
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), EntryAfter{});
+            out = heap.back();
+            heap.pop_back();
+            if (out.g == cost[static_cast<std::size_t>(out.item)]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Build
+
+    void CorridorGraph::clear() {
+        w = h = 0;
+        nodeOf.clear();
+        nodeTiles.clear();
+        edgeStart.clear();
+        edges.clear();
+        inStart.clear();
+        inEdges.clear();
+        runTiles.clear();
+        corridorEdge.clear();
+        corridorPos.clear();
+        walkable.clear();
+        clusterOf.clear();
+        borderOf.clear();
+        borderNodes.clear();
+        absStart.clear();
+        absEdges.clear();
+    }
+
+    void CorridorGraph::build(const TraversalMasks& masks, Traversal who, int clusterSize) {
+        clear();
+        w = masks.width();
+        h = masks.height();
+        const std::size_t cells = static_cast<std::size_t>(w) * static_cast<std::size_t>(h);
+        if (cells == 0) {
+            return;
+        }
+        const std::uint8_t* exits = masks.data(who);
+
+        // Corridor tile: two exits, and exactly those two neighbours step
+        // back into it. Any other tile that can be entered is a node; tiles
+        // that can only be left (walls next to a corridor) stay out, and do
+        // not count as stepping in either, or every tile along a wall would
+        // look like a junction.
+        auto stepsIn = [&](int x, int y, bool enterableOnly) {
+            std::uint8_t in = 0;
+            for (const auto& step : kSteps) {
+                const int nx = x + step.dx;
+                const int ny = y + step.dy;
+                if (static_cast<unsigned>(nx) < static_cast<unsigned>(w) &&
+                    static_cast<unsigned>(ny) < static_cast<unsigned>(h) &&
+                    hasExit(exits[static_cast<std::size_t>(ny) * w + nx], reverseOf(step.dir)) &&
+                    (!enterableOnly || walkable[static_cast<std::size_t>(ny) * w + nx] == 2)) {
+                    in |= exitBit(step.dir);
+                }
+            }
+            return in;
+        };
+        nodeOf.assign(cells, -1);
+        walkable.assign(cells, 0);
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                const std::size_t i = static_cast<std::size_t>(y) * w + x;
+                if (stepsIn(x, y, false) != 0) {
+                    walkable[i] = 2;    // can be entered
+                } else if (exits[i] != 0) {
+                    walkable[i] = 1;    // can only be left
+                }
+            }
+        }
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                const std::size_t i = static_cast<std::size_t>(y) * w + x;
+                if (walkable[i] != 2) continue;
+                const std::uint8_t in = stepsIn(x, y, true);
+                if (exitCount(exits[i]) != 2 || in != exits[i]) {
+                    nodeOf[i] = static_cast<int>(nodeTiles.size());
+                    nodeTiles.push_back(static_cast<int>(i));
+                }
+            }
+        }
+
+        // Walk every corridor from both of its ends
+        const int nodes = nodeCount();
+        corridorEdge.assign(cells, -1);
+        corridorPos.assign(cells, 0);
+        edgeStart.assign(static_cast<std::size_t>(nodes) + 1, 0);
+        for (int a = 0; a < nodes; ++a) {
+            edgeStart[static_cast<std::size_t>(a)] = static_cast<int>(edges.size());
+            const int from = nodeTiles[static_cast<std::size_t>(a)];
+            for (const auto& step : kSteps) {
+                if (!hasExit(exits[from], step.dir)) continue;
+
+                Edge edge{ a, -1, 0, static_cast<int>(runTiles.size()), -1 };
+                int prev = from;
+                int cur = from + step.dy * w + step.dx;
+                for (;;) {
+                    runTiles.push_back(cur);
+                    ++edge.length;
+                    if (nodeOf[static_cast<std::size_t>(cur)] >= 0) break;
+                    // Leave by the exit that does not lead back
+                    int next = cur;
+                    for (const auto& on : kSteps) {
+                        if (!hasExit(exits[cur], on.dir)) continue;
+                        const int n = cur + on.dy * w + on.dx;
+                        if (n != prev) { next = n; break; }
+                    }
+                    prev = cur;
+                    cur = next;
+                }
+                edge.to = nodeOf[static_cast<std::size_t>(cur)];
+
+                const int id = static_cast<int>(edges.size());
+                for (int k = 0; k + 1 < edge.length; ++k) {
+                    const std::size_t t = static_cast<std::size_t>(runTiles[static_cast<std::size_t>(edge.run + k)]);
+                    if (corridorEdge[t] < 0) {
+                        corridorEdge[t] = id;
+                        corridorPos[t] = k;
+                    }
+                }
+                edges.push_back(edge);
+            }
+        }
+        edgeStart[static_cast<std::size_t>(nodes)] = static_cast<int>(edges.size());
+
+        // Pair each corridor with its walk in the other direction
+        for (auto& edge : edges) {
+            if (edge.length < 2) continue;
+            const int last = runTiles[static_cast<std::size_t>(edge.run + edge.length - 2)];
+            for (int r = edgeStart[static_cast<std::size_t>(edge.to)]; r < edgeStart[static_cast<std::size_t>(edge.to) + 1]; ++r) {
+                if (runTiles[static_cast<std::size_t>(edges[static_cast<std::size_t>(r)].run)] == last) {
+                    edge.reverse = r;
+                    break;
+                }
+            }
+        }
+
+        // Incoming edges, for searches that run back from the goal
+        inStart.assign(static_cast<std::size_t>(nodes) + 1, 0);
+        for (const auto& edge : edges) {
+            ++inStart[static_cast<std::size_t>(edge.to) + 1];
+        }
+        for (int n = 0; n < nodes; ++n) {
+            inStart[static_cast<std::size_t>(n) + 1] += inStart[static_cast<std::size_t>(n)];
+        }
+        inEdges.assign(edges.size(), 0);
+        std::vector<int> fill(inStart.begin(), inStart.end() - 1);
+        for (int e = 0; e < edgeCount(); ++e) {
+            inEdges[static_cast<std::size_t>(fill[static_cast<std::size_t>(edges[static_cast<std::size_t>(e)].to)]++)] = e;
+        }
+
+        if (clusterSize > 0 && nodes > HierarchyThreshold) {
+            buildClusters(clusterSize);
+        }
+    }
+
+    void CorridorGraph::buildClusters(int clusterSize) {
+        const int nodes = nodeCount();
+        const int clustersX = (w + clusterSize - 1) / clusterSize;
+        clusterOf.resize(static_cast<std::size_t>(nodes));
+        for (int n = 0; n < nodes; ++n) {
+            const int tile = nodeTiles[static_cast<std::size_t>(n)];
+            clusterOf[static_cast<std::size_t>(n)] = (tile / w / clusterSize) * clustersX + (tile % w) / clusterSize;
+        }
+
+        // Border nodes: an end of an edge between two clusters
+        borderOf.assign(static_cast<std::size_t>(nodes), -1);
+        for (const auto& edge : edges) {
+            if (clusterOf[static_cast<std::size_t>(edge.from)] != clusterOf[static_cast<std::size_t>(edge.to)]) {
+                borderOf[static_cast<std::size_t>(edge.from)] = 0;
+                borderOf[static_cast<std::size_t>(edge.to)] = 0;
+            }
+        }
+        for (int n = 0; n < nodes; ++n) {
+            if (borderOf[static_cast<std::size_t>(n)] == 0) {
+                borderOf[static_cast<std::size_t>(n)] = static_cast<int>(borderNodes.size());
+                borderNodes.push_back(n);
+            }
+        }
+        if (borderNodes.empty()) {
+            clusterOf.clear();
+            borderOf.clear();
+            return;
+        }
+
+        // Abstract edges: shortest in-cluster distances between border
+        // nodes, plus the edges that cross clusters
+        absStart.assign(borderNodes.size() + 1, 0);
+        Scratch local;
+        Scratch::Entry item;
+        for (std::size_t b = 0; b < borderNodes.size(); ++b) {
+            absStart[b] = static_cast<int>(absEdges.size());
+            const int node = borderNodes[b];
+            const int cluster = clusterOf[static_cast<std::size_t>(node)];
+
+            local.begin(static_cast<std::size_t>(nodes));
+            local.improve(node, 0, 0, -1, -1);
+            while (local.pop(item)) {
+                if (item.item != node && borderOf[static_cast<std::size_t>(item.item)] >= 0) {
+                    absEdges.push_back(AbsEdge{ static_cast<int>(b), borderOf[static_cast<std::size_t>(item.item)], item.g, -1 });
+                }
+                for (int e = edgeStart[static_cast<std::size_t>(item.item)]; e < edgeStart[static_cast<std::size_t>(item.item) + 1]; ++e) {
+                    const Edge& edge = edges[static_cast<std::size_t>(e)];
+                    if (clusterOf[static_cast<std::size_t>(edge.to)] != cluster) continue;
+                    local.improve(edge.to, item.g + edge.length, item.g + edge.length, e, -1);
+                }
+            }
+            for (int e = edgeStart[static_cast<std::size_t>(node)]; e < edgeStart[static_cast<std::size_t>(node) + 1]; ++e) {
+                const Edge& edge = edges[static_cast<std::size_t>(e)];
+                if (clusterOf[static_cast<std::size_t>(edge.to)] != cluster) {
+                    absEdges.push_back(AbsEdge{ static_cast<int>(b), borderOf[static_cast<std::size_t>(edge.to)], edge.length, e });
+                }
+            }
+        }
+        absStart[borderNodes.size()] = static_cast<int>(absEdges.size());
+    }
+
+    // Queries
+
+    bool CorridorGraph::covers(const Tile& t) const {
+        if (!inside(t)) return false;
+        const std::size_t i = indexOf(t);
+        return !walkable[i] || nodeOf[i] >= 0 || corridorEdge[i] >= 0;
+    }
+
+    int CorridorGraph::distanceTo(int node, const Tile& t) const {
+        const int tile = nodeTiles[static_cast<std::size_t>(node)];
+        return std::abs(tile % w - t.x) + std::abs(tile / w - t.y);
+    }
+
+    void CorridorGraph::entryPortals(const Tile& start, std::vector<Portal>& out) const {
+        out.clear();
+        const std::size_t i = indexOf(start);
+        if (nodeOf[i] >= 0) {
+            out.push_back(Portal{ nodeOf[i], 0, -1, 0, 0 });
+            return;
+        }
+        const int e = corridorEdge[i];
+        if (e < 0) return;
+        const Edge& edge = edges[static_cast<std::size_t>(e)];
+        const int k = corridorPos[i];
+        const int L = edge.length;
+        out.push_back(Portal{ edge.to, L - 1 - k, e, k + 1, L - 1 - k });
+        if (edge.reverse >= 0) {
+            out.push_back(Portal{ edge.from, k + 1, edge.reverse, L - 1 - k, k + 1 });
+        }
+    }
+
+    void CorridorGraph::exitPortals(const Tile& goal, std::vector<Portal>& out) const {
+        out.clear();
+        const std::size_t i = indexOf(goal);
+        if (nodeOf[i] >= 0) {
+            out.push_back(Portal{ nodeOf[i], 0, -1, 0, 0 });
+            return;
+        }
+        const int e = corridorEdge[i];
+        if (e < 0) return;
+        const Edge& edge = edges[static_cast<std::size_t>(e)];
+        const int k = corridorPos[i];
+        const int L = edge.length;
+        out.push_back(Portal{ edge.from, k + 1, e, 0, k + 1 });
+        if (edge.reverse >= 0) {
+            out.push_back(Portal{ edge.to, L - 1 - k, edge.reverse, 0, L - 1 - k });
+        }
+    }
+
+    // Start and goal inside the same corridor: walk straight along it
+    bool CorridorGraph::directPortal(const Tile& start, const Tile& goal, Portal& out) const {
+        const std::size_t i = indexOf(start);
+        const std::size_t j = indexOf(goal);
+        if (nodeOf[i] >= 0 || nodeOf[j] >= 0 || corridorEdge[i] < 0 || corridorEdge[i] != corridorEdge[j]) {
+            return false;
+        }
+        const Edge& edge = edges[static_cast<std::size_t>(corridorEdge[i])];
+        const int k = corridorPos[i];
+        const int kg = corridorPos[j];
+        if (kg > k) {
+            out = Portal{ -1, kg - k, corridorEdge[i], k + 1, kg - k };
+            return true;
+        }
+        if (edge.reverse < 0) return false;
+        out = Portal{ -1, k - kg, edge.reverse, edge.length - 1 - k, k - kg };
+        return true;
+    }
+
+    void CorridorGraph::appendSlice(int edge, int first, int count, std::vector<Tile>& path) const {
+        const int base = edges[static_cast<std::size_t>(edge)].run + first;
+        for (int k = 0; k < count; ++k) {
+            const int tile = runTiles[static_cast<std::size_t>(base + k)];
+            path.push_back(Tile{ tile % w, tile / w });
+        }
+    }
+
+    // Edges from the search's source to `node`, in walking order
+    void CorridorGraph::appendNodeChain(const Scratch& s, int node, std::vector<int>& out) const {
+        const std::size_t begin = out.size();
+        for (int e = s.via[static_cast<std::size_t>(node)]; e >= 0;
+             e = s.via[static_cast<std::size_t>(edges[static_cast<std::size_t>(e)].from)]) {
+            out.push_back(e);
+        }
+        std::reverse(out.begin() + static_cast<std::ptrdiff_t>(begin), out.end());
+    }
+
+    void CorridorGraph::appendEdges(const std::vector<int>& chainEdges, std::vector<Tile>& path) const {
+        for (int e : chainEdges) {
+            appendSlice(e, 0, edges[static_cast<std::size_t>(e)].length, path);
+        }
+    }
+
+    int CorridorGraph::search(const Tile& start, const Tile& goal, int maxLength,
+                              std::vector<Tile>* path, Workspace& ws) const {
+        if (path) path->clear();
+        if (!ready() || !inside(start) || !inside(goal)) return -1;
+        if (start == goal) return 0;
+        return hierarchical() ? searchClustered(start, goal, maxLength, path, ws)
+                              : searchFlat(start, goal, maxLength, path, ws);
+    }
+
+    // A* over corridor nodes
+    int CorridorGraph::searchFlat(const Tile& start, const Tile& goal, int maxLength,
+                                  std::vector<Tile>* path, Workspace& ws) const {
+        entryPortals(start, ws.entries);
+        exitPortals(goal, ws.exits);
+
+        int best = Infinity;
+        int bestNode = -1;
+        int bestExit = -1;
+        Portal direct{};
+        if (directPortal(start, goal, direct)) {
+            best = direct.cost;
+        }
+
+        ws.forward.begin(nodeTiles.size());
+        for (std::size_t j = 0; j < ws.entries.size(); ++j) {
+            const Portal& in = ws.entries[j];
+            const int f = in.cost + distanceTo(in.node, goal);
+            if (f <= maxLength) {
+                ws.forward.improve(in.node, in.cost, f, -1, static_cast<int>(j));
+            }
+        }
+
+        int expanded = 0;
+        Scratch::Entry top;
+        while (ws.forward.pop(top)) {
+            if (top.f >= best) break;
+            ++expanded;
+            for (std::size_t j = 0; j < ws.exits.size(); ++j) {
+                if (ws.exits[j].node == top.item && top.g + ws.exits[j].cost < best) {
+                    best = top.g + ws.exits[j].cost;
+                    bestNode = top.item;
+                    bestExit = static_cast<int>(j);
+                }
+            }
+            const int origin = ws.forward.origin[static_cast<std::size_t>(top.item)];
+            for (int e = edgeStart[static_cast<std::size_t>(top.item)]; e < edgeStart[static_cast<std::size_t>(top.item) + 1]; ++e) {
+                const Edge& edge = edges[static_cast<std::size_t>(e)];
+                const int g = top.g + edge.length;
+                const int f = g + distanceTo(edge.to, goal);
+                if (f >= best || f > maxLength) continue;
+                ws.forward.improve(edge.to, g, f, e, origin);
+            }
+        }
+        ++ws.counters.queries;
+        ws.counters.expanded += static_cast<std::uint64_t>(expanded);
+        ws.counters.lastExpanded = expanded;
+
+        if (best >= Infinity || best > maxLength) return -1;
+        if (path) {
+            if (bestNode < 0) {
+                appendSlice(direct.edge, direct.first, direct.count, *path);
+            } else {
+                const Portal& in = ws.entries[static_cast<std::size_t>(ws.forward.origin[static_cast<std::size_t>(bestNode)])];
+                const Portal& out = ws.exits[static_cast<std::size_t>(bestExit)];
+                if (in.edge >= 0) appendSlice(in.edge, in.first, in.count, *path);
+                ws.chain.clear();
+                appendNodeChain(ws.forward, bestNode, ws.chain);
+                appendEdges(ws.chain, *path);
+                if (out.edge >= 0) appendSlice(out.edge, out.first, out.count, *path);
+            }
+        }
+        return best;
+    }
+
+    // Local searches in the start and goal clusters, A* over border nodes
+    // in between, then the in-cluster ws.legs are refined
+    int CorridorGraph::searchClustered(const Tile& start, const Tile& goal, int maxLength,
+                                       std::vector<Tile>* path, Workspace& ws) const {
+        entryPortals(start, ws.entries);
+        exitPortals(goal, ws.exits);
+        const std::size_t nodes = nodeTiles.size();
+
+        int best = Infinity;
+        int bestNode = -1;      // exit node reached inside the start clusters
+        int bestExit = -1;
+        int bestBorder = -1;    // or the border node the abstract route ends at
+        Portal direct{};
+        if (directPortal(start, goal, direct)) {
+            best = direct.cost;
+        }
+        int expanded = 0;
+        Scratch::Entry item;
+
+        // Goal clusters: in-cluster distance from each node to the goal
+        ws.backward.begin(nodes);
+        for (std::size_t j = 0; j < ws.exits.size(); ++j) {
+            ws.backward.improve(ws.exits[j].node, ws.exits[j].cost, ws.exits[j].cost, -1, static_cast<int>(j));
+        }
+        while (ws.backward.pop(item)) {
+            ++expanded;
+            const int cluster = clusterOf[static_cast<std::size_t>(item.item)];
+            const int origin = ws.backward.origin[static_cast<std::size_t>(item.item)];
+            for (int k = inStart[static_cast<std::size_t>(item.item)]; k < inStart[static_cast<std::size_t>(item.item) + 1]; ++k) {
+                const int e = inEdges[static_cast<std::size_t>(k)];
+                const Edge& edge = edges[static_cast<std::size_t>(e)];
+                if (clusterOf[static_cast<std::size_t>(edge.from)] != cluster) continue;
+                const int g = item.g + edge.length;
+                if (g + distanceTo(edge.from, start) > maxLength) continue;
+                ws.backward.improve(edge.from, g, g, e, origin);
+            }
+        }
+
+        // Start clusters: in-cluster distances from the start; border nodes
+        // reached seed the abstract search
+        ws.forward.begin(nodes);
+        ws.top.begin(borderNodes.size());
+        for (std::size_t j = 0; j < ws.entries.size(); ++j) {
+            ws.forward.improve(ws.entries[j].node, ws.entries[j].cost, ws.entries[j].cost, -1, static_cast<int>(j));
+        }
+        while (ws.forward.pop(item)) {
+            if (item.g >= best) break;
+            ++expanded;
+            const std::size_t at = static_cast<std::size_t>(item.item);
+            for (std::size_t j = 0; j < ws.exits.size(); ++j) {
+                if (ws.exits[j].node == item.item && item.g + ws.exits[j].cost < best) {
+                    best = item.g + ws.exits[j].cost;
+                    bestNode = item.item;
+                    bestExit = static_cast<int>(j);
+                }
+            }
+            if (borderOf[at] >= 0) {
+                ws.top.improve(borderOf[at], item.g, item.g + distanceTo(item.item, goal), -1, -1);
+            }
+            const int cluster = clusterOf[at];
+            const int origin = ws.forward.origin[at];
+            for (int e = edgeStart[at]; e < edgeStart[at + 1]; ++e) {
+                const Edge& edge = edges[static_cast<std::size_t>(e)];
+                if (clusterOf[static_cast<std::size_t>(edge.to)] != cluster) continue;
+                const int g = item.g + edge.length;
+                if (g + distanceTo(edge.to, goal) > maxLength) continue;
+                ws.forward.improve(edge.to, g, g, e, origin);
+            }
+        }
+
+        // Border nodes
+        while (ws.top.pop(item)) {
+            if (item.f >= best) break;
+            ++expanded;
+            const int node = borderNodes[static_cast<std::size_t>(item.item)];
+            if (ws.backward.reached(node)) {
+                const int total = item.g + ws.backward.cost[static_cast<std::size_t>(node)];
+                if (total < best) {
+                    best = total;
+                    bestBorder = item.item;
+                    bestNode = -1;
+                }
+            }
+            for (int a = absStart[static_cast<std::size_t>(item.item)]; a < absStart[static_cast<std::size_t>(item.item) + 1]; ++a) {
+                const AbsEdge& link = absEdges[static_cast<std::size_t>(a)];
+                const int g = item.g + link.cost;
+                const int f = g + distanceTo(borderNodes[static_cast<std::size_t>(link.to)], goal);
+                if (f >= best || f > maxLength) continue;
+                ws.top.improve(link.to, g, f, a, -1);
+            }
+        }
+        ++ws.counters.queries;
+        ws.counters.expanded += static_cast<std::uint64_t>(expanded);
+        ws.counters.lastExpanded = expanded;
+
+        if (best >= Infinity || best > maxLength) return -1;
+        if (!path) return best;
+
+        if (bestBorder < 0 && bestNode < 0) {
+            appendSlice(direct.edge, direct.first, direct.count, *path);
+            return best;
+        }
+        if (bestNode >= 0) {
+            const Portal& in = ws.entries[static_cast<std::size_t>(ws.forward.origin[static_cast<std::size_t>(bestNode)])];
+            const Portal& out = ws.exits[static_cast<std::size_t>(bestExit)];
+            if (in.edge >= 0) appendSlice(in.edge, in.first, in.count, *path);
+            ws.chain.clear();
+            appendNodeChain(ws.forward, bestNode, ws.chain);
+            appendEdges(ws.chain, *path);
+            if (out.edge >= 0) appendSlice(out.edge, out.first, out.count, *path);
+            return best;
+        }
+
+        // Abstract route, back to the border node the start clusters reached
+        ws.legs.clear();
+        int border = bestBorder;
+        for (int a = ws.top.via[static_cast<std::size_t>(border)]; a >= 0; a = ws.top.via[static_cast<std::size_t>(border)]) {
+            ws.legs.push_back(a);
+            border = absEdges[static_cast<std::size_t>(a)].from;
+        }
+        std::reverse(ws.legs.begin(), ws.legs.end());
+
+        // Start tile -> first border node
+        const int firstNode = borderNodes[static_cast<std::size_t>(border)];
+        const Portal& in = ws.entries[static_cast<std::size_t>(ws.forward.origin[static_cast<std::size_t>(firstNode)])];
+        if (in.edge >= 0) appendSlice(in.edge, in.first, in.count, *path);
+        ws.chain.clear();
+        appendNodeChain(ws.forward, firstNode, ws.chain);
+
+        // Border to border: cross-cluster edges as they are, in-cluster
+        // ws.legs searched again inside their cluster
+        for (int a : ws.legs) {
+            const AbsEdge& link = absEdges[static_cast<std::size_t>(a)];
+            if (link.edge >= 0) {
+                ws.chain.push_back(link.edge);
+                continue;
+            }
+            const int from = borderNodes[static_cast<std::size_t>(link.from)];
+            const int to = borderNodes[static_cast<std::size_t>(link.to)];
+            const int cluster = clusterOf[static_cast<std::size_t>(from)];
+            ws.local.begin(nodes);
+            ws.local.improve(from, 0, 0, -1, -1);
+            while (ws.local.pop(item) && item.item != to) {
+                for (int e = edgeStart[static_cast<std::size_t>(item.item)]; e < edgeStart[static_cast<std::size_t>(item.item) + 1]; ++e) {
+                    const Edge& edge = edges[static_cast<std::size_t>(e)];
+                    if (clusterOf[static_cast<std::size_t>(edge.to)] != cluster) continue;
+                    ws.local.improve(edge.to, item.g + edge.length, item.g + edge.length, e, -1);
+                }
+            }
+            appendNodeChain(ws.local, to, ws.chain);
+        }
+
+        // Last border node -> goal tile
+        int node = borderNodes[static_cast<std::size_t>(bestBorder)];
+        for (int e = ws.backward.via[static_cast<std::size_t>(node)]; e >= 0; e = ws.backward.via[static_cast<std::size_t>(node)]) {
+            ws.chain.push_back(e);
+            node = edges[static_cast<std::size_t>(e)].to;
+        }
+        appendEdges(ws.chain, *path);
+        const Portal& out = ws.exits[static_cast<std::size_t>(ws.backward.origin[static_cast<std::size_t>(node)])];
+        if (out.edge >= 0) appendSlice(out.edge, out.first, out.count, *path);
+        return best;
+    }
+
+}
@@ -0,0 +1,224 @@
+#include "entities/DStarLite.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace game {
+
+    namespace {
+        // Same neighbour order as the path engines: right, left, down, up
+        struct Step { Direction dir; int dx; int dy; };
+        const Step kSteps[4] = {
+            { Direction::Right,  1,  0 },
+            { Direction::Left,  -1,  0 },
+            { Direction::Down,   0,  1 },
+            { Direction::Up,     0, -1 },
+        };
+
+        struct EntryAfter {
+            template <typename E>
+            bool operator()(const E& a, const E& b) const { return b.key < a.key; }
+        };
+    }
+
+    void DStarLite::reset(const TraversalMasks& grid, Traversal rule) {
+        masks = &grid;
+        who = rule;
+        w = grid.width();
+        h = grid.height();
+        const std::size_t cells = static_cast<std::size_t>(w) * static_cast<std::size_t>(h);
+        seen.assign(cells, 0);
+        gValue.resize(cells);
+        rhsValue.resize(cells);
+        openKey.resize(cells);
+        inOpen.resize(cells);
+        stamp = 0;
+        open.clear();
+        goalIndex = startIndex = lastStart = -1;
+        km = 0;
+    }
+
+    void DStarLite::touch(int i) {
+        const std::size_t at = static_cast<std::size_t>(i);
+        if (seen[at] != stamp) {
+            seen[at] = stamp;
+            gValue[at] = Infinity;
+            rhsValue[at] = Infinity;
+            inOpen[at] = 0;
+        }
+    }
+
+    int DStarLite::heuristic(int a, int b) const {
+        return std::abs(a % w - b % w) + std::abs(a / w - b / w);
+    }
+
+    DStarLite::Key DStarLite::keyOf(int i) const {
+        const int best = std::min(g(i), rhs(i));
+        return Key{ best >= Infinity ? Infinity : best + heuristic(startIndex, i) + km, best };
+    }
+
+    // Recompute rhs from the tile's outgoing moves and fix its open-list entry
+    void DStarLite::updateVertex(int i) {
+        touch(i);
+        const std::size_t at = static_cast<std::size_t>(i);
+        if (i != goalIndex) {
+            const std::uint8_t exits = masks->data(who)[at];
+            int best = Infinity;
+            for (const auto& step : kSteps) {
+                if (!hasExit(exits, step.dir)) continue;
+                best = std::min(best, g(i + step.dy * w + step.dx) + 1);
+            }
+            rhsValue[at] = std::min(best, Infinity);
+        }
+        if (gValue[at] != rhsValue[at]) {
+            openKey[at] = keyOf(i);
+            inOpen[at] = 1;
+            open.push_back(Entry{ openKey[at], i });
+            std::push_heap(open.begin(), open.end(), EntryAfter{});
+        } else {
+            inOpen[at] = 0;
+        }
+    }
+
+    void DStarLite::repair() {
+        const std::uint8_t* exits = masks->data(who);
+        int expanded = 0;
+        while (!open.empty()) {
+            const Entry top = open.front();
+            const std::size_t at = static_cast<std::size_t>(top.index);
+            if (seen[at] != stamp || !inOpen[at] || !(openKey[at] == top.key)) {
+                std::pop_heap(open.begin(), open.end(), EntryAfter{});
+                open.pop_back();
+                continue;   // stale entry
+            }
+            if (!(top.key < keyOf(startIndex)) && rhs(startIndex) == g(startIndex)) {
+                break;
+            }
+            std::pop_heap(open.begin(), open.end(), EntryAfter{});
+            open.pop_back();
+            ++expanded;
+
+            const int u = top.index;
+            const Key fresh = keyOf(u);
+            if (top.key < fresh) {
+                openKey[at] = fresh;
+                open.push_back(Entry{ fresh, u });
+                std::push_heap(open.begin(), open.end(), EntryAfter{});
+                continue;
+            }
+
+            inOpen[at] = 0;
+            if (gValue[at] > rhsValue[at]) {
+                gValue[at] = rhsValue[at];
+            } else {
+                gValue[at] = Infinity;
+                updateVertex(u);
+            }
+            // Tiles with a move into u depend on its value
+            const int ux = u % w;
+            const int uy = u / w;
+            for (const auto& step : kSteps) {
+                const int px = ux - step.dx;
+                const int py = uy - step.dy;
+                if (static_cast<unsigned>(px) >= static_cast<unsigned>(w) ||
+                    static_cast<unsigned>(py) >= static_cast<unsigned>(h)) {
+                    continue;
+                }
+                const int p = py * w + px;
+                if (hasExit(exits[p], step.dir)) {
+                    updateVertex(p);
+                }
+            }
+        }
+        ++counters.queries;
+        counters.expanded += static_cast<std::uint64_t>(expanded);
+        counters.lastExpanded = expanded;
+        counters.scanned += static_cast<std::uint64_t>(expanded);
+        counters.lastScanned = expanded;
+    }
+
+    void DStarLite::restart(int goal, int start) {
+        if (++stamp == 0) {
+            std::fill(seen.begin(), seen.end(), 0u);
+            stamp = 1;
+        }
+        open.clear();
+        goalIndex = goal;
+        startIndex = lastStart = start;
+        km = 0;
+        touch(goal);
+        rhsValue[static_cast<std::size_t>(goal)] = 0;
+        updateVertex(goal);
+    }
+
+    int DStarLite::plan(const Tile& start, const Tile& goal, std::vector<Tile>& path) {
+        path.clear();
+        if (masks == nullptr) return -1;
+        if (masks->width() != w || masks->height() != h) {
+            reset(*masks, who);
+        }
+        if (static_cast<unsigned>(start.x) >= static_cast<unsigned>(w) ||
+            static_cast<unsigned>(start.y) >= static_cast<unsigned>(h) ||
+            static_cast<unsigned>(goal.x) >= static_cast<unsigned>(w) ||
+            static_cast<unsigned>(goal.y) >= static_cast<unsigned>(h)) {
+            return -1;
+        }
+        if (start == goal) return 0;
+
+        const int s = start.y * w + start.x;
+        const int t = goal.y * w + goal.x;
+        if (t != goalIndex) {
+            restart(t, s);
+        } else if (s != lastStart) {
+            // The chaser moved: keep every value, shift the keys instead
+            km += heuristic(lastStart, s);
+            startIndex = lastStart = s;
+        }
+        repair();
+
+        const int length = g(s);
+        if (length >= Infinity) return -1;
+
+        // Descend the distances; ties go right, left, down, up
+        const std::uint8_t* exits = masks->data(who);
+        int cur = s;
+        for (int i = 0; i < length; ++i) {
+            int next = -1;
+            int best = Infinity;
+            for (const auto& step : kSteps) {
+                if (!hasExit(exits[cur], step.dir)) continue;
+                const int n = cur + step.dy * w + step.dx;
+                if (g(n) < best) {
+                    best = g(n);
+                    next = n;
+                }
+            }
+            if (next < 0) {
+                path.clear();
+                return -1;
+            }
+            cur = next;
+            path.push_back(Tile{ cur % w, cur / w });
+        }
+        return length;
+    }
+
+    void DStarLite::tileChanged(int x, int y) {
+        if (goalIndex < 0 || masks == nullptr ||
+            masks->width() != w || masks->height() != h) {
+            return;
+        }
+        // The masks of (x, y) and its neighbours changed, i.e. their outgoing moves
+        const int dx[5] = { 0, 1, -1, 0, 0 };
+        const int dy[5] = { 0, 0, 0, 1, -1 };
+        for (int i = 0; i < 5; ++i) {
+            const int nx = x + dx[i];
+            const int ny = y + dy[i];
+            if (static_cast<unsigned>(nx) < static_cast<unsigned>(w) &&
+                static_cast<unsigned>(ny) < static_cast<unsigned>(h)) {
+                updateVertex(ny * w + nx);
+            }
+        }
+    }
+
+}
@@ -1,8 +1,9 @@
 #include "entities/MonsterSystem.hpp"
 
-#include <queue>
 #include <limits>
 #include <algorithm>
+#include <chrono>
+#include <cstdlib>
 
 namespace game {
 
@@ -11,32 +12,397 @@ namespace game {
                                  const std::vector<Tile>& spawns)
         : map(mapGrid)
     {
+        searchContexts.resize(1);
+        searchContexts[0].engine = makePathEngine(pathAlgorithm);
+        startLevel(spawns);
+    }
+
+    void MonsterSystem::startLevel(const std::vector<Tile>& spawns) {
+        traversal.build(map);
+        playerField.invalidate();
+        buildLayoutTables();
+        ++planEpoch;
         events.reset();
+        player = MonsterPlayerState{};
+        prevPlayerTile = Tile{};
+        ghosts.clear();
+        ghosts.reserve(spawns.size());
+        redGhost = -1;
 
         for (std::size_t i = 0; i < spawns.size(); ++i) {
-            Ghost g;
-            g.pos = spawns[i];
-            g.prevPos = g.pos;
-            g.spawnPos = spawns[i];
-            g.dir = Direction::Right;
-            g.state = GhostState::Patrol;
-            g.patrolPath = generatePatrolLoop(g.pos);
-            g.patrolIndex = 0;
-            g.animTimer = 0.0;
-            g.moveTimer = 0.0;
-            // Stagger spawn delays: Red=2s, Yellow=4s, Blue=6s
-            g.spawnDelay = 2.0 + (i * 2.0);
-
             // monster spawn order: 0=Red, 1=Yellow, others=Blue
+            GhostType type = GhostType::Blue;
             if (i == 0) {
-                g.type = GhostType::Red;
+                type = GhostType::Red;
+                redGhost = 0;
             } else if (i == 1) {
-                g.type = GhostType::Yellow;
+                type = GhostType::Yellow;
+            }
+
+            // Stagger spawn delays: Red=2s, Yellow=4s, Blue=6s
+            const std::size_t g = ghosts.add(spawns[i], type, 2.0 + (i * 2.0));
+            GhostRoute& route = ghosts.routes[g];
+            route.patrolPath = generatePatrolLoop(spawns[i]);
+            route.patrolLookup.invalidate();
+            route.patrolIndex = 0;
+        }
+        occupancy.reset(map.width(), map.height(), ghosts.size());
+        for (std::size_t i = 0; i < ghosts.size(); ++i) {
+            occupancy.place(static_cast<int>(i), ghosts.pos[i]);
+        }
+        perceptionReach = 0;
+        for (double range : ghosts.perceptionRange) {
+            perceptionReach = std::max(perceptionReach, static_cast<int>(range));
+        }
+        clearPlanQueue();
+        resetChasePlanners();
+    }
+
+    void MonsterSystem::onTileChanged(int x, int y) {
+        traversal.update(map, x, y);
+        // Rebuilt once on the next update(), however many tiles changed
+        distances.clear();
+        corridors.clear();
+        distancesStale = true;
+        playerField.invalidate();
+        for (auto& planner : chasePlanners) {
+            planner.tileChanged(x, y);
+        }
+        ++planEpoch;
+    }
+
+    void MonsterSystem::setDistanceTableBudget(std::size_t bytes) {
+        distances.setBudget(bytes);
+        playerField.invalidate();
+        buildLayoutTables();
+        ++planEpoch;
+    }
+
+    // All-pairs table when it fits the budget, corridor graph otherwise;
+    // then the house routes, which are planned on them
+    void MonsterSystem::buildLayoutTables() {
+        distances.build(traversal, Traversal::Ghost, search);
+        if (distances.ready()) {
+            corridors.clear();
+        } else {
+            corridors.build(traversal, Traversal::Ghost);
+        }
+        distancesStale = false;
+        buildHouseRoutes();
+    }
+
+    // Way out for every house tile, ending on the first tile that is
+    // neither house nor door: one step there if the Ghost rule allows it,
+    // else through the door to the nearest such tile (first in row-major
+    // order on ties)
+    void MonsterSystem::buildHouseRoutes() {
+        const int W = map.width();
+        const int H = map.height();
+        houseRoutes.reset(W, H);
+        std::vector<Tile> route;
+        const Direction dirs[4] = { Direction::Right, Direction::Left, Direction::Down, Direction::Up };
+
+        for (int y = 0; y < H; ++y) {
+            for (int x = 0; x < W; ++x) {
+                if (!isInGhostHouse(x, y)) {
+                    continue;
+                }
+                const Tile from{ x, y };
+                const std::uint8_t exits = ghostExits(from);
+
+                bool adjacent = false;
+                for (Direction d : dirs) {
+                    const Tile delta = dirToDelta(d);
+                    const Tile next{ x + delta.x, y + delta.y };
+                    if (hasExit(exits, d) && !isInGhostHouse(next.x, next.y) && !isGhostDoor(next.x, next.y) &&
+                        computeShortestPath(from, next, route, searchContexts[0])) {
+                        houseRoutes.add(from, route);
+                        adjacent = true;
+                        break;
+                    }
+                }
+                if (adjacent) {
+                    continue;
+                }
+
+                Tile exit{ -1, -1 };
+                searchContexts[0].engine->searchNearest(traversal, Traversal::Ghost, from, std::numeric_limits<int>::max(),
+                                                        [this, W](const Tile& t) {
+                                                            return isInGhostHouse(t.x, t.y) || isGhostDoor(t.x, t.y)
+                                                                ? -1 : t.y * W + t.x;
+                                                        },
+                                                        &exit);
+                if (exit.x != -1 && computeShortestPath(from, exit, route, searchContexts[0])) {
+                    houseRoutes.add(from, route);
+                }
+            }
+        }
+    }
+
+    void MonsterSystem::setPathAlgorithm(PathAlgorithm algorithm) {
+        if (algorithm != pathAlgorithm) {
+            pathAlgorithm = algorithm;
+            for (auto& ctx : searchContexts) {
+                ctx.engine = makePathEngine(algorithm);
+            }
+            buildHouseRoutes();
+            ++planEpoch;
+        }
+    }
+
+    PathStats MonsterSystem::getPathStats() const {
+        PathStats total;
+        for (const auto& ctx : searchContexts) {
+            total.queries += ctx.engine->stats().queries;
+            total.expanded += ctx.engine->stats().expanded;
+            total.lastExpanded += ctx.engine->stats().lastExpanded;
+            total.scanned += ctx.engine->stats().scanned;
+            total.lastScanned += ctx.engine->stats().lastScanned;
+        }
+        return total;
+    }
+
+    PathStats MonsterSystem::getCorridorStats() const {
+        PathStats total;
+        for (const auto& ctx : searchContexts) {
+            total.queries += ctx.corridor.stats().queries;
+            total.expanded += ctx.corridor.stats().expanded;
+            total.lastExpanded += ctx.corridor.stats().lastExpanded;
+        }
+        return total;
+    }
+
+    void MonsterSystem::setWorkerThreads(unsigned threads) {
+        threads = std::max(threads, 1u);
+        if (threads == getWorkerThreads()) {
+            return;
+        }
+        workers = threads > 1 ? std::make_unique<WorkerPool>(threads) : nullptr;
+        const std::size_t before = searchContexts.size();
+        searchContexts.resize(threads);
+        for (std::size_t k = before; k < searchContexts.size(); ++k) {
+            searchContexts[k].engine = makePathEngine(pathAlgorithm);
+        }
+    }
+
+    void MonsterSystem::setIncrementalChase(bool enabled) {
+        if (enabled != incrementalChase) {
+            incrementalChase = enabled;
+            resetChasePlanners();
+            ++planEpoch;
+        }
+    }
+
+    void MonsterSystem::resetChasePlanners() {
+        chasePlanners.clear();
+        if (!incrementalChase) {
+            return;
+        }
+        chasePlanners.resize(ghosts.size());
+        for (auto& planner : chasePlanners) {
+            planner.reset(traversal, Traversal::Ghost);
+        }
+    }
+
+    PathStats MonsterSystem::getChasePlannerStats() const {
+        PathStats total;
+        for (const auto& planner : chasePlanners) {
+            total.queries += planner.stats().queries;
+            total.expanded += planner.stats().expanded;
+            total.lastExpanded += planner.stats().lastExpanded;
+            total.scanned += planner.stats().scanned;
+            total.lastScanned += planner.stats().lastScanned;
+        }
+        return total;
+    }
+
+    void MonsterSystem::setPlanningBudget(int microseconds) {
+        planBudgetMicros = std::max(microseconds, 0);
+        // Waiting ghosts ask again on the next update(), or plan inline
+        clearPlanQueue();
+    }
+
+    void MonsterSystem::clearPlanQueue() {
+        planQueue = {};
+        for (auto& route : ghosts.routes) {
+            route.planWanted = false;
+            route.planQueued = false;
+        }
+        // The masks may have been rebuilt under the field. Size it now
+        // rather than inside the first budgeted plan.
+        if (planBudgetMicros > 0) {
+            planField.begin(traversal, Traversal::Ghost, Tile{ -1, -1 });
+        }
+        planField.invalidate();
+    }
+
+    // Queue this frame's plan requests, then serve the queue until the
+    // budget runs out. Runs on the calling thread between the decide and
+    // commit phases, so it is the only writer of the routes it touches.
+    void MonsterSystem::runPlanner() {
+        const long long deadline = planningNow() + planBudgetMicros;
+        ++planFrame;
+
+        for (std::size_t i = 0; i < ghosts.size(); ++i) {
+            GhostRoute& route = ghosts.routes[i];
+            if (!route.planWanted) continue;
+            route.planWanted = false;
+            if (route.planQueued) continue;     // still waiting; serves the latest target
+            route.planQueued = true;
+            const Tile& pos = ghosts.pos[i];
+            const long long distance = std::abs(pos.x - route.planTarget.x) + std::abs(pos.y - route.planTarget.y);
+            const long long key = distance + PlanAgeWeight * planFrame - (route.path.empty() ? PlanNoPathBonus : 0);
+            planQueue.push(PlanRequest{ key, i });
+        }
+
+        while (!planQueue.empty()) {
+            const std::size_t i = planQueue.top().ghost;
+            GhostRoute& route = ghosts.routes[i];
+            const Tile pos = ghosts.pos[i];
+            const Tile target = route.planTarget;
+            // Lost the player, respawned or eaten since asking
+            if (ghosts.state[i] != GhostState::Chase || pos == target) {
+                planQueue.pop();
+                route.planQueued = false;
+                continue;
+            }
+
+            if (incrementalChase || distances.ready()) {
+                if (incrementalChase) {
+                    chasePlanners[i].plan(pos, target, route.path);
+                } else {
+                    computeShortestPath(pos, target, route.path, searchContexts[0]);
+                }
             } else {
-                g.type = GhostType::Blue;
+                // One reverse BFS per target (the player field for the
+                // player's tile), kept while it has queued takers; the
+                // ghost's path is ready as soon as its tile is in
+                const bool toPlayer = playerField.valid() && target == playerField.target();
+                DistanceField& field = toPlayer ? playerField : planField;
+                if (!toPlayer && (!planField.valid() || planField.target() != target || planFieldEpoch != planEpoch)) {
+                    planField.begin(traversal, Traversal::Ghost, target);
+                    planFieldEpoch = planEpoch;
+                }
+                while (field.distance(pos) < 0 && !field.advance(PlanSlice)) {
+                    if (planningNow() >= deadline) {
+                        return;     // resumes here next update()
+                    }
+                }
+                route.path.clear();
+                const int length = field.distance(pos);
+                Tile cur = pos;
+                for (int k = 0; k < length; ++k) {
+                    const Tile d = dirToDelta(field.nextStep(cur));
+                    cur = Tile{ cur.x + d.x, cur.y + d.y };
+                    route.path.push_back(cur);
+                }
             }
+            route.pathIndex = 0;
+            route.pathPlanned = true;
+            route.plannedFrom = pos;
+            route.plannedTarget = target;
+            route.plannedEpoch = planEpoch;
+            route.planQueued = false;
+            planQueue.pop();
+
+            if (planningNow() >= deadline) {
+                return;
+            }
+        }
+    }
 
-            ghosts.push_back(g);
+    long long MonsterSystem::planningNow() const {
+        if (planClock) {
+            return planClock();
+        }
+        using namespace std::chrono;
+        return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    // The ghost is where its last plan left it: at the start, or on the tile
+    // it is stepping from or towards
+    bool MonsterSystem::followingPlan(std::size_t i) const {
+        const GhostRoute& route = ghosts.routes[i];
+        const Tile& pos = ghosts.pos[i];
+        if (pos == route.plannedFrom) return true;
+        if (route.pathIndex >= route.path.size()) return false;
+        return pos == route.path[route.pathIndex] ||
+               (route.pathIndex > 0 && pos == route.path[route.pathIndex - 1]);
+    }
+
+    // Ghost store
+    void GhostStore::clear() {
+        pos.clear();
+        prevPos.clear();
+        dir.clear();
+        state.clear();
+        spawnDelay.clear();
+        animTimer.clear();
+        moveTimer.clear();
+        hitFreezeSteps.clear();
+        fleeDir.clear();
+        spawnPos.clear();
+        type.clear();
+        perceptionRange.clear();
+        stunTimer.clear();
+        stepCounter.clear();
+        routes.clear();
+    }
+
+    void GhostStore::reserve(std::size_t count) {
+        pos.reserve(count);
+        prevPos.reserve(count);
+        dir.reserve(count);
+        state.reserve(count);
+        spawnDelay.reserve(count);
+        animTimer.reserve(count);
+        moveTimer.reserve(count);
+        hitFreezeSteps.reserve(count);
+        fleeDir.reserve(count);
+        spawnPos.reserve(count);
+        type.reserve(count);
+        perceptionRange.reserve(count);
+        stunTimer.reserve(count);
+        stepCounter.reserve(count);
+        routes.reserve(count);
+    }
+
+    std::size_t GhostStore::add(const Tile& spawn, GhostType ghostType, double delay) {
+        pos.push_back(spawn);
+        prevPos.push_back(spawn);
+        dir.push_back(Direction::Right);
+        state.push_back(GhostState::Patrol);
+        spawnDelay.push_back(delay);
+        animTimer.push_back(0.0);
+        moveTimer.push_back(0.0);
+        hitFreezeSteps.push_back(0);
+        fleeDir.push_back(Direction::None);
+        spawnPos.push_back(spawn);
+        type.push_back(ghostType);
+        perceptionRange.push_back(8.0);     // Perception range (reduced from 12.0)
+        stunTimer.push_back(0.0);
+        stepCounter.push_back(0);
+        routes.emplace_back();
+        return pos.size() - 1;
+    }
+
+    void GhostStore::tickTimers(double dt) {
+        const std::size_t n = size();
+        double* delay = spawnDelay.data();
+        for (std::size_t i = 0; i < n; ++i) {
+            delay[i] = delay[i] > 0.0 ? delay[i] - dt : delay[i];
+        }
+        // A hit sets HitFreezeUpdates + 1, so the count reaches 0 only after
+        // the ghost has sat out that many whole updates
+        int* freeze = hitFreezeSteps.data();
+        for (std::size_t i = 0; i < n; ++i) {
+            freeze[i] = freeze[i] > 0 ? freeze[i] - 1 : 0;
+        }
+        // Keep timer reasonable (wrap at 10 seconds to prevent overflow)
+        double* anim = animTimer.data();
+        for (std::size_t i = 0; i < n; ++i) {
+            const double t = anim[i] + dt;
+            anim[i] = t > 10.0 ? t - 10.0 : t;
         }
     }
 
@@ -47,38 +413,85 @@ namespace game {
 
     void MonsterSystem::update(double dt) {
         events.reset();
-        for (auto& g : ghosts) {
-            // Update timers
-            if (g.spawnDelay > 0.0) {
-                g.spawnDelay -= dt;
+        if (distancesStale) {
+            buildLayoutTables();
+        }
+        // Without a table, one reverse BFS from the player serves every
+        // ghost's perception test and chase; redone only when the player
+        // reaches another tile. Under a planning budget it is filled only as
+        // far as the perception tests look, and the planner extends it.
+        if (!distances.ready()) {
+            const Tile playerTile{ player.gridX, player.gridY };
+            if (planBudgetMicros == 0) {
+                if (!playerField.valid() || playerField.target() != playerTile || !playerField.complete()) {
+                    playerField.build(traversal, Traversal::Ghost, playerTile);
+                }
+            } else {
+                if (!playerField.valid() || playerField.target() != playerTile) {
+                    playerField.begin(traversal, Traversal::Ghost, playerTile);
+                }
+                while (playerField.settledRange() < perceptionReach && !playerField.advance(PlanSlice)) {}
             }
-            
-            // Update animation timer 
-            g.animTimer += dt;
-            // Keep timer reasonable (wrap at 10 seconds to prevent overflow)
-            if (g.animTimer > 10.0) {
-                g.animTimer -= 10.0;
+        }
+        // Per-ghost timers never depend on other ghosts: one pass each
+        ghosts.tickTimers(dt);
+        if (player.isPowered) {
+            scoreFleeDirections();
+        }
+        // Red goes first, all the way: Yellow aims off its position after
+        // its move
+        const std::size_t count = ghosts.size();
+        const std::size_t leader = redGhost >= 0 ? static_cast<std::size_t>(redGhost) : count;
+        if (leader < count) {
+            updateGhostAI(leader, dt, searchContexts[0]);
+            moveGhost(leader, dt);
+            resolvePlayerCollisions(true);
+        }
+
+        // Decide: every other ghost plans against the same snapshot and
+        // writes only its own state and route, so the pool may split them
+        // any way
+        auto decide = [&](std::size_t begin, std::size_t end, unsigned worker) {
+            for (std::size_t i = begin; i < end; ++i) {
+                if (i != leader) {
+                    updateGhostAI(i, dt, searchContexts[worker]);
+                }
             }
-            updateGhostAI(g, dt);
-            moveGhost(g, dt);
+        };
+        if (workers && count >= ParallelMinGhosts) {
+            workers->parallelFor(count, DecideGrain, decide);
+        } else {
+            decide(0, count, 0);
+        }
+
+        if (planBudgetMicros > 0) {
+            runPlanner();
         }
+
+        // Commit: moves in ghost order, then every contact with the player
+        for (std::size_t i = 0; i < count; ++i) {
+            if (i != leader) {
+                moveGhost(i, dt);
+            }
+        }
+        resolvePlayerCollisions(false);
     }
 
     std::vector<GhostRenderInfo> MonsterSystem::getRenderInfo() const {
         std::vector<GhostRenderInfo> out;
         out.reserve(ghosts.size());
-        for (const auto& g : ghosts) {
+        for (std::size_t i = 0; i < ghosts.size(); ++i) {
             GhostRenderInfo info;
-            info.gridX = g.pos.x;
-            info.gridY = g.pos.y;
-            info.dir   = g.dir;
-            info.state = g.state;
+            info.gridX = ghosts.pos[i].x;
+            info.gridY = ghosts.pos[i].y;
+            info.dir   = ghosts.dir[i];
+            info.state = ghosts.state[i];
             // Use animTimer for smooth animation - change frame every 0.3 seconds
             // animTimer is cumulative, so we divide by frame duration
             const double frameDuration = 0.3; // 0.3 seconds per frame
-            int frameIndex = static_cast<int>(g.animTimer / frameDuration) % 4;
+            int frameIndex = static_cast<int>(ghosts.animTimer[i] / frameDuration) % 4;
             info.animFrame = frameIndex; 
-            info.type  = g.type;
+            info.type  = ghosts.type[i];
             out.push_back(info);
         }
         return out;
@@ -89,52 +502,59 @@ namespace game {
 
     // Reset all ghosts after the player loses a life.
     void MonsterSystem::resetAllGhosts() {
-        for (auto& g : ghosts) {
-            g.pos      = g.spawnPos;
-            g.prevPos  = g.spawnPos;
-            g.state    = GhostState::Patrol;
-            g.dir      = Direction::Right;
+        for (std::size_t i = 0; i < ghosts.size(); ++i) {
+            ghosts.pos[i]     = ghosts.spawnPos[i];
+            ghosts.prevPos[i] = ghosts.spawnPos[i];
+            occupancy.place(static_cast<int>(i), ghosts.pos[i]);
+            ghosts.state[i]   = GhostState::Patrol;
+            ghosts.dir[i]     = Direction::Right;
 
             // Clear any chasing/return paths and rebuild patrol loop from spawn
-            g.path.clear();
-            g.pathIndex   = 0;
-            g.patrolPath  = generatePatrolLoop(g.spawnPos);
-            g.patrolIndex = 0;
+            GhostRoute& route = ghosts.routes[i];
+            route.path.clear();
+            route.pathIndex   = 0;
+            route.pathPlanned = false;
+            route.patrolPath  = generatePatrolLoop(ghosts.spawnPos[i]);
+            route.patrolLookup.invalidate();
+            route.patrolIndex = 0;
 
             // Reset timers and flags
-            g.stunTimer      = 0.0;
-            g.spawnDelay     = 2.0;  // small delay before they can chase again
-            g.hitFreezeSteps = 0;
-            g.animTimer      = 0.0;
-            g.moveTimer      = 0.0;
-            g.stepCounter    = 0;
+            ghosts.stunTimer[i]      = 0.0;
+            ghosts.spawnDelay[i]     = 2.0;  // small delay before they can chase again
+            ghosts.hitFreezeSteps[i] = 0;
+            ghosts.animTimer[i]      = 0.0;
+            ghosts.moveTimer[i]      = 0.0;
+            ghosts.stepCounter[i]    = 0;
         }
+        clearPlanQueue();
     }
 
     // helper
     bool MonsterSystem::inBounds(int x, int y) const {
-        return y >= 0 && y < (int)map.size() &&
-               !map.empty() &&
-               x >= 0 && x < (int)map[0].size();
+        return map.inBounds(x, y);
     }
 
     bool MonsterSystem::isWalkable(int x, int y) const {
         if (!inBounds(x, y)) return false;
-        int cell = map[y][x];
         // Monsters can walk on: empty path (0), ghost house (2), dots (3),
         // power pellets (4), and ghost doors (5).
         // They cannot walk on walls (1).
-        return (cell == 0 || cell == 2 || cell == 3 || cell == 4 || cell == 5);
+        return map.at(x, y) != tile::Wall;
     }
     
     bool MonsterSystem::isInGhostHouse(int x, int y) const {
         if (!inBounds(x, y)) return false;
-        return map[y][x] == 2; // Ghost house cell
+        return map.at(x, y) == tile::House;
     }
 
     bool MonsterSystem::isGhostDoor(int x, int y) const {
         if (!inBounds(x, y)) return false;
-        return map[y][x] == 5;
+        return map.at(x, y) == tile::Door;
+    }
+
+    // Legal ghost moves out of t, door rule included
+    std::uint8_t MonsterSystem::ghostExits(const Tile& t) const {
+        return traversal.exits(Traversal::Ghost, t.x, t.y);
     }
 
     Tile MonsterSystem::dirToDelta(Direction d) const {
@@ -225,130 +645,141 @@ namespace game {
         return path;
     }
 
-    // BFS
-    std::vector<Tile> MonsterSystem::computeShortestPath(const Tile& start,
-                                                         const Tile& goal) const
+    // Shortest path: distance table, then player field, then corridor graph,
+    // then the path engine
+    bool MonsterSystem::computeShortestPath(const Tile& start,
+                                            const Tile& goal,
+                                            std::vector<Tile>& path,
+                                            SearchContext& ctx) const
     {
-        if (start == goal) return {};
-
-        const int H = (int)map.size();
-        const int W = map.empty() ? 0 : (int)map[0].size();
-
-        std::vector<std::vector<bool>> visited(H, std::vector<bool>(W, false));
-        std::vector<std::vector<Tile>> parent(H, std::vector<Tile>(W, Tile{-1,-1}));
-
-        std::queue<Tile> q;
-        q.push(start);
-        visited[start.y][start.x] = true;
-
-        const Tile dirs[4] = { {1,0},{-1,0},{0,1},{0,-1} };
-
-        bool found = false;
-        while (!q.empty()) {
-            Tile cur = q.front(); q.pop();
-            if (cur == goal) { found = true; break; }
-
-            for (const auto& d : dirs) {
-                Tile nxt{ cur.x + d.x, cur.y + d.y };
-                if (!inBounds(nxt.x, nxt.y)) continue;
-                if (!isWalkable(nxt.x, nxt.y)) continue;
-
-                if (isGhostDoor(nxt.x, nxt.y) &&
-                    !isInGhostHouse(cur.x, cur.y)) {
-                    continue;
-                }
-
-                if (visited[nxt.y][nxt.x]) continue;
-
-                visited[nxt.y][nxt.x] = true;
-                parent[nxt.y][nxt.x]  = cur;
-                q.push(nxt);
+        path.clear();
+        if (start == goal) return false;
+        if (!inBounds(start.x, start.y) || !inBounds(goal.x, goal.y)) return false;
+
+        if (distances.ready()) {
+            // Follow first steps from the table; no search
+            const int length = distances.distance(start, goal);
+            if (length < 0) return false;
+            Tile cur = start;
+            for (int i = 0; i < length; ++i) {
+                const Tile d = dirToDelta(distances.firstStep(cur, goal));
+                cur = Tile{ cur.x + d.x, cur.y + d.y };
+                path.push_back(cur);
             }
+            return true;
         }
 
-        std::vector<Tile> path;
-        if (!found) return path;
+        if (playerField.valid() && goal == playerField.target() &&
+            (playerField.complete() || playerField.distance(start) >= 0)) {
+            // Walk down the player distance field
+            const int length = playerField.distance(start);
+            if (length < 0) return false;
+            Tile cur = start;
+            for (int i = 0; i < length; ++i) {
+                const Tile d = dirToDelta(playerField.nextStep(cur));
+                cur = Tile{ cur.x + d.x, cur.y + d.y };
+                path.push_back(cur);
+            }
+            return true;
+        }
 
-        // Backtrace path 
-        Tile cur = goal;
-        while (cur != start) {
-            path.push_back(cur);
-            Tile p = parent[cur.y][cur.x];
-            cur = p;
+        if (corridors.ready() && corridors.covers(start) && corridors.covers(goal)) {
+            return corridors.search(start, goal, std::numeric_limits<int>::max(), &path, ctx.corridor) > 0;
         }
-        std::reverse(path.begin(), path.end());
-        return path;
+
+        return ctx.engine->search(traversal, Traversal::Ghost, start, goal,
+                                  std::numeric_limits<int>::max(), &path) > 0;
     }
 
+    // Path length from start to goal, or -1 if unreachable, farther than
+    // maxRange, or start == goal. Stops expanding at maxRange and never
+    // builds the path.
     int MonsterSystem::shortestPathDistance(const Tile& start,
                                             const Tile& goal,
-                                            int maxRange) const
+                                            int maxRange,
+                                            SearchContext& ctx) const
     {
-        auto path = computeShortestPath(start, goal);
-        if (path.empty()) return -1;
-        int dist = (int)path.size(); 
-        if (dist > maxRange) return -1;
-        return dist;
+        if (start == goal) return -1;
+        if (!inBounds(start.x, start.y) || !inBounds(goal.x, goal.y)) return -1;
+
+        if (distances.ready()) {
+            const int d = distances.distance(start, goal);
+            return (d < 0 || d > maxRange) ? -1 : d;
+        }
+        if (playerField.valid() && goal == playerField.target()) {
+            // A partly filled field still answers for tiles it reached and
+            // for anything beyond its settled range
+            const int d = playerField.distance(start);
+            if (d >= 0 || playerField.settledRange() >= maxRange) {
+                return (d < 0 || d > maxRange) ? -1 : d;
+            }
+        }
+
+        if (corridors.ready() && corridors.covers(start) && corridors.covers(goal)) {
+            return corridors.search(start, goal, maxRange, nullptr, ctx.corridor);
+        }
+
+        return ctx.engine->search(traversal, Traversal::Ghost, start, goal, maxRange, nullptr);
     }
 
     // intersection/dead end
+    // Junctions count every non-wall neighbour, doors included
     bool MonsterSystem::isIntersection(const Tile& t) const {
-        int count = 0;
-        const Tile dirs[4] = { {1,0},{-1,0},{0,1},{0,-1} };
-        for (const auto& d : dirs) {
-            int nx = t.x + d.x, ny = t.y + d.y;
-            if (isWalkable(nx, ny)) ++count;
-        }
-        return count >= 3;
+        return exitCount(traversal.exits(Traversal::GhostInside, t.x, t.y)) >= 3;
     }
 
     bool MonsterSystem::isDeadEnd(const Tile& t, Direction /*dir*/) const {
-        int count = 0;
-        const Tile dirs[4] = { {1,0},{-1,0},{0,1},{0,-1} };
-        for (const auto& d : dirs) {
-            int nx = t.x + d.x, ny = t.y + d.y;
-            if (isWalkable(nx, ny)) ++count;
-        }
         // dead end
-        return count <= 1;
+        return exitCount(traversal.exits(Traversal::GhostInside, t.x, t.y)) <= 1;
     }
 
-    bool MonsterSystem::onPatrolPath(const Ghost& g) const {
-        for (const auto& t : g.patrolPath) {
-            if (t == g.pos) return true;
+    // Only ghost i's own decide step touches its route, so building the
+    // lookup lazily is safe on the worker threads too
+    const PatrolLookup& MonsterSystem::patrolLookupOf(std::size_t i) const {
+        const GhostRoute& route = ghosts.routes[i];
+        if (!route.patrolLookup.built) {
+            route.patrolLookup.assign(route.patrolPath);
         }
-        return false;
+        return route.patrolLookup;
     }
 
-    Tile MonsterSystem::nearestPatrolNode(const Ghost& g) const {
-        Tile best = g.pos;
-        int bestDist = std::numeric_limits<int>::max();
-
-        for (const auto& t : g.patrolPath) {
-            int d = shortestPathDistance(g.pos, t, 9999);
-            if (d >= 0 && d < bestDist) {
-                bestDist = d;
-                best = t;
-            }
-        }
-        return best;
+    bool MonsterSystem::onPatrolPath(std::size_t i) const {
+        return patrolLookupOf(i).indexOf(ghosts.pos[i]) >= 0;
     }
 
-    // find red position
-    const Ghost* MonsterSystem::findRedGhost() const {
-        for (const auto& gh : ghosts) {
-            if (gh.type == GhostType::Red) {
-                return &gh;
+    // Closest patrol tile other than the ghost's own; ties go to the one
+    // earliest in the loop
+    Tile MonsterSystem::nearestPatrolNode(std::size_t i, SearchContext& ctx) const {
+        const Tile pos = ghosts.pos[i];
+        const GhostRoute& route = ghosts.routes[i];
+        Tile best = pos;
+
+        if (distances.ready()) {
+            // One lookup per patrol tile
+            int bestDist = std::numeric_limits<int>::max();
+            for (const auto& t : route.patrolPath) {
+                int d = shortestPathDistance(pos, t, 9999, ctx);
+                if (d >= 0 && d < bestDist) {
+                    bestDist = d;
+                    best = t;
+                }
             }
+            return best;
         }
-        return nullptr;
+
+        // One BFS that stops at the first ring holding a patrol tile
+        const PatrolLookup& lookup = patrolLookupOf(i);
+        ctx.engine->searchNearest(traversal, Traversal::Ghost, pos, 9999,
+                                  [&lookup](const Tile& t) { return lookup.indexOf(t); },
+                                  &best);
+        return best;
     }
 
     //chase strategy chose
-    Tile MonsterSystem::computeChaseTarget(const Ghost& g, const Tile& playerTile) const
+    Tile MonsterSystem::computeChaseTarget(std::size_t i, const Tile& playerTile) const
     {
-        const int H = (int)map.size();
-        const int W = map.empty() ? 0 : (int)map[0].size();
+        const int H = map.height();
+        const int W = map.width();
 
         auto clamp = [](int v, int lo, int hi) {
             if (v < lo) return lo;
@@ -357,16 +788,18 @@ namespace game {
         };
 
     //Red and Blue
-    if (g.type == GhostType::Red || g.type == GhostType::Blue) {
+    const GhostType type = ghosts.type[i];
+    if (type == GhostType::Red || type == GhostType::Blue) {
         return playerTile;
         }
 
     // Yellow
-    if (g.type == GhostType::Yellow) {
-        const Ghost* red = findRedGhost();
-        if (!red) {
+    if (type == GhostType::Yellow) {
+        // red position
+        if (redGhost < 0) {
             return playerTile;
         }
+        const Tile red = ghosts.pos[static_cast<std::size_t>(redGhost)];
 
         Tile dirDelta = dirToDelta(player.dir);
         int k = 2;
@@ -375,8 +808,8 @@ namespace game {
             playerTile.y + dirDelta.y * k
         };
 
-        int vx = ahead.x - red->pos.x;
-        int vy = ahead.y - red->pos.y;
+        int vx = ahead.x - red.x;
+        int vy = ahead.y - red.y;
 
         //shift
         Tile target{
@@ -398,243 +831,244 @@ namespace game {
 }
 
     // State Machine
-    void MonsterSystem::updateGhostAI(Ghost& g, double dt) {
-
-        auto setPathOrStay = [&](Ghost& gg, const Tile& chaseTarget) {
-            auto p = computeShortestPath(gg.pos, chaseTarget);
-            if (p.empty()) {
-                gg.path.clear();
-                gg.pathIndex = 0;
+    void MonsterSystem::updateGhostAI(std::size_t i, double dt, SearchContext& ctx) {
+        Tile& pos = ghosts.pos[i];
+        GhostState& state = ghosts.state[i];
+        const double spawnDelay = ghosts.spawnDelay[i];
+        GhostRoute& route = ghosts.routes[i];
+
+        auto setPathOrStay = [&](const Tile& chaseTarget) {
+            if (planBudgetMicros > 0) {
+                // Keep following a plan for this target; otherwise ask the
+                // planner and keep following the old path meanwhile
+                if (route.pathPlanned && route.plannedTarget == chaseTarget &&
+                    route.plannedEpoch == planEpoch && followingPlan(i)) {
+                    return;
+                }
+                route.planTarget = chaseTarget;
+                route.planWanted = true;
+                return;
+            }
+            route.pathIndex = 0;
+            // Ghosts change tile a few times a second: replan only when the
+            // ghost, the target or the layout changed since the last plan
+            if (route.pathPlanned && route.plannedFrom == pos &&
+                route.plannedTarget == chaseTarget && route.plannedEpoch == planEpoch) {
+                return;
+            }
+            // Reuses route.path's storage; left empty when there is no path
+            if (incrementalChase) {
+                chasePlanners[i].plan(pos, chaseTarget, route.path);
             } else {
-                gg.path = std::move(p);
-                gg.pathIndex = 0;
+                computeShortestPath(pos, chaseTarget, route.path, ctx);
             }
+            route.pathPlanned = true;
+            route.plannedFrom = pos;
+            route.plannedTarget = chaseTarget;
+            route.plannedEpoch = planEpoch;
         };
         Tile playerTile{ player.gridX, player.gridY };
         
         // Check if monster is in ghost house
-        bool inGhostHouse = isInGhostHouse(g.pos.x, g.pos.y);
+        bool inGhostHouse = isInGhostHouse(pos.x, pos.y);
 
-        if (inGhostHouse && g.spawnDelay > 0.0) {
+        if (inGhostHouse && spawnDelay > 0.0) {
             // Keep monster in ghost house
-            if (g.state != GhostState::Patrol) {
-                g.state = GhostState::Patrol;
-                g.patrolPath = generatePatrolLoop(g.pos);
-                g.patrolIndex = 0;
+            if (state != GhostState::Patrol) {
+                state = GhostState::Patrol;
+                route.patrolPath = generatePatrolLoop(pos);
+                route.patrolLookup.invalidate();
+                route.patrolIndex = 0;
             }
             return; 
         }
         
-        // exit from ghost house
-        if (inGhostHouse && g.spawnDelay <= 0.0) {
-            // 1) First, try to find an immediate adjacent exit tile
-            const Tile dirs[4] = { {1,0},{-1,0},{0,1},{0,-1} };
-            for (const auto& d : dirs) {
-                int nx = g.pos.x + d.x, ny = g.pos.y + d.y;
-                if (inBounds(nx, ny) && !isInGhostHouse(nx, ny) && isWalkable(nx, ny)) {
-                    Tile exitTile{nx, ny};
-                    g.path = computeShortestPath(g.pos, exitTile);
-                    g.pathIndex = 0;
-                    g.state = GhostState::Patrol; 
-                    return;
-                }
-            }
-
-            // 2) Fallback: search for a ghost door tile anywhere on the map
-            Tile bestExit{ -1, -1 };
-            int bestLen = std::numeric_limits<int>::max();
-
-            const int H = (int)map.size();
-            const int W = map.empty() ? 0 : (int)map[0].size();
-
-            for (int y = 0; y < H; ++y) {
-                for (int x = 0; x < W; ++x) {
-                    if (!isGhostDoor(x, y)) {
-                        continue;
-                    }
-                    Tile exitTile{ x, y };
-                    auto p = computeShortestPath(g.pos, exitTile);
-                    if (!p.empty() && (int)p.size() < bestLen) {
-                        bestLen = (int)p.size();
-                        bestExit = exitTile;
-                    }
-                }
-            }
-
-            if (bestExit.x != -1) {
-                g.path = computeShortestPath(g.pos, bestExit);
-                g.pathIndex = 0;
-                g.state = GhostState::Patrol;
-                return;
+        // exit from ghost house along the route stored for this tile
+        if (inGhostHouse && spawnDelay <= 0.0) {
+            if (houseRoutes.route(pos, route.path)) {
+                route.pathIndex = 0;
+                route.pathPlanned = false;
+                state = GhostState::Patrol;
             }
-
-            // Can't find exit at all, stay in patrol
+            // No route: can't find exit at all, stay in patrol
             return;
         }
 
         // Red: chase when in range (not immediately)
-        if (g.type == GhostType::Red) {
+        if (ghosts.type[i] == GhostType::Red) {
             // Only chase if spawn delay is over and outside ghost house
-            if (g.spawnDelay <= 0.0 && !inGhostHouse) {
-                int dist = shortestPathDistance(g.pos, playerTile, (int)g.perceptionRange);
+            if (spawnDelay <= 0.0 && !inGhostHouse) {
+                int dist = shortestPathDistance(pos, playerTile, (int)ghosts.perceptionRange[i], ctx);
                 bool inRange = (dist >= 0);
                 if (inRange) {
-                    Tile target = computeChaseTarget(g, playerTile);
-                    g.state = GhostState::Chase;
-                    setPathOrStay(g, target);
-                } else if (g.state == GhostState::Chase) {
+                    Tile target = computeChaseTarget(i, playerTile);
+                    state = GhostState::Chase;
+                    setPathOrStay(target);
+                } else if (state == GhostState::Chase) {
                     // Lost player, return to patrol
-                    g.state = GhostState::Patrol;
-                    g.path.clear();
-                    g.pathIndex = 0;
+                    state = GhostState::Patrol;
+                    route.path.clear();
+                    route.pathIndex = 0;
+                    route.pathPlanned = false;
                 }
             }
             return;
         }
 
         // Other ghosts - only chase if spawn delay is over and outside ghost house
-        if (g.spawnDelay > 0.0 || inGhostHouse) {
+        if (spawnDelay > 0.0 || inGhostHouse) {
             return; 
         }
         
-        int dist = shortestPathDistance(g.pos,
+        int dist = shortestPathDistance(pos,
                                         playerTile,
-                                        (int)g.perceptionRange);
+                                        (int)ghosts.perceptionRange[i],
+                                        ctx);
         bool inRange = (dist >= 0);
 
         // Chase target with ghost type
-        Tile chaseTarget = computeChaseTarget(g, playerTile);
+        Tile chaseTarget = computeChaseTarget(i, playerTile);
 
-        if (g.state == GhostState::Patrol) {
+        if (state == GhostState::Patrol) {
             if (inRange) {
                 // Chase 
-                g.state = GhostState::Chase;
-                setPathOrStay(g, chaseTarget);
+                state = GhostState::Chase;
+                setPathOrStay(chaseTarget);
             }
         }
-        else if (g.state == GhostState::Chase) {
+        else if (state == GhostState::Chase) {
             if (!inRange) {
                 // Lost player, simply fall back to patrol.
-                g.state = GhostState::Patrol;
-                g.path.clear();
-                g.pathIndex = 0;
+                state = GhostState::Patrol;
+                route.path.clear();
+                route.pathIndex = 0;
+                route.pathPlanned = false;
             } else {
-                setPathOrStay(g, chaseTarget);
+                setPathOrStay(chaseTarget);
             }
         }
     }
 
-    // Move & Collide
-    void MonsterSystem::moveGhost(Ghost& g, double dt) {
-        g.prevPos = g.pos;
-
-        if (g.hitFreezeSteps > 0) {
-            --g.hitFreezeSteps;
-            return;
-        }
-
-        if (player.isPowered) {
-            Tile playerTile{ player.gridX, player.gridY };
-
-            Direction bestDir = g.dir;
-            bool hasBest = false;
+    // Flee direction of every ghost from a powered player: the legal step
+    // whose tile is farthest (squared) from the player, first of
+    // up / down / left / right on ties. Reads only hot columns and the exit
+    // masks, with no dependency between ghosts.
+    void MonsterSystem::scoreFleeDirections() {
+        const Tile playerTile{ player.gridX, player.gridY };
+        const std::uint8_t* exits = traversal.data(Traversal::Ghost);
+        const int W = traversal.width();
+        const Direction dirs[4] = { Direction::Up, Direction::Down, Direction::Left, Direction::Right };
+        const int stepX[4] = { 0, 0, -1, 1 };
+        const int stepY[4] = { -1, 1, 0, 0 };
+
+        const std::size_t n = ghosts.size();
+        const Tile* pos = ghosts.pos.data();
+        Direction* flee = ghosts.fleeDir.data();
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::uint8_t mask = inBounds(pos[i].x, pos[i].y) ? exits[pos[i].y * W + pos[i].x] : 0;
             int bestDist2 = -1;
+            Direction best = Direction::None;
+            for (int k = 0; k < 4; ++k) {
+                const int dx = pos[i].x + stepX[k] - playerTile.x;
+                const int dy = pos[i].y + stepY[k] - playerTile.y;
+                const int dist2 = hasExit(mask, dirs[k]) ? dx * dx + dy * dy : -1;
+                best = dist2 > bestDist2 ? dirs[k] : best;
+                bestDist2 = dist2 > bestDist2 ? dist2 : bestDist2;
+            }
+            flee[i] = best;
+        }
+    }
 
-            Direction dirs[4] = {
-                Direction::Up,
-                Direction::Down,
-                Direction::Left,
-                Direction::Right
-            };
-
-            for (Direction d : dirs) {
-                Tile delta = dirToDelta(d);
-                int nx = g.pos.x + delta.x;
-                int ny = g.pos.y + delta.y;
-
-                if (!isWalkable(nx, ny)) {
-                    continue;
-                }
-
-                if (isGhostDoor(nx, ny) && !isInGhostHouse(g.pos.x, g.pos.y)) {
-                    continue;
-                }
-
-                int dx = nx - playerTile.x;
-                int dy = ny - playerTile.y;
-                int dist2 = dx * dx + dy * dy;
-
-                if (!hasBest || dist2 > bestDist2) {
-                    hasBest = true;
-                    bestDist2 = dist2;
-                    bestDir = d;
-                }
+    // Greedy step for a ghost whose new plan is still queued: the open exit
+    // whose tile is nearest (squared) to the target. Turning back is allowed,
+    // as it is when following a path down a corridor; on ties the current
+    // heading wins, then up / down / left / right.
+    Direction MonsterSystem::stepTowards(const Tile& from, Direction facing, const Tile& target) const {
+        const Direction dirs[4] = { Direction::Up, Direction::Down, Direction::Left, Direction::Right };
+        const int stepX[4] = { 0, 0, -1, 1 };
+        const int stepY[4] = { -1, 1, 0, 0 };
+        const std::uint8_t exits = ghostExits(from);
+        Direction best = Direction::None;
+        int bestDist2 = 0;
+        for (int k = 0; k < 4; ++k) {
+            if (!hasExit(exits, dirs[k])) continue;
+            const int dx = from.x + stepX[k] - target.x;
+            const int dy = from.y + stepY[k] - target.y;
+            const int dist2 = dx * dx + dy * dy;
+            if (best == Direction::None || dist2 < bestDist2 || (dist2 == bestDist2 && dirs[k] == facing)) {
+                best = dirs[k];
+                bestDist2 = dist2;
             }
+        }
+        return best;
+    }
 
-            if (hasBest) {
+    // Move & Collide
+    void MonsterSystem::moveGhost(std::size_t i, double dt) {
+        Tile& pos = ghosts.pos[i];
+        Direction& dir = ghosts.dir[i];
+        GhostRoute& route = ghosts.routes[i];
+        ghosts.prevPos[i] = pos;
 
-                g.dir = bestDir;
-                g.path.clear();
-                g.pathIndex = 0;
-            }
+        if (ghosts.hitFreezeSteps[i] > 0) {
+            return;
         }
 
-        Direction desired = g.dir;
+        const bool fleeing = player.isPowered && ghosts.fleeDir[i] != Direction::None;
+        if (fleeing) {
+            // Scored for every ghost at the start of update()
+            dir = ghosts.fleeDir[i];
+            route.path.clear();
+            route.pathIndex = 0;
+            route.pathPlanned = false;
+        }
+
+        Direction desired = dir;
 
+        // 0) Old path used up while the new plan waits in the queue: keep
+        // heading for the target rather than wandering off along `dir`
+        const bool awaitingPlan = !fleeing && (route.planWanted || route.planQueued) &&
+                                  (route.path.empty() || pos == route.path.back());
+        const Direction fallback = awaitingPlan ? stepTowards(pos, dir, route.planTarget) : Direction::None;
+        if (fallback != Direction::None) {
+            desired = fallback;
+        }
         // 1) CHASE / RETURN
-        if (!g.path.empty() && g.pathIndex < g.path.size()) {
-            Tile next = g.path[g.pathIndex];
-            Tile delta{ next.x - g.pos.x, next.y - g.pos.y };
+        else if (!route.path.empty() && route.pathIndex < route.path.size()) {
+            Tile next = route.path[route.pathIndex];
+            Tile delta{ next.x - pos.x, next.y - pos.y };
             Direction pathDir = deltaToDir(delta);
 
-            // forward
-            Tile fwd = { g.pos.x + dirToDelta(g.dir).x, g.pos.y + dirToDelta(g.dir).y };
-            bool forwardBlocked = true;
-            if (isWalkable(fwd.x, fwd.y)) {
-                bool intoDoorFromOutside = isGhostDoor(fwd.x, fwd.y) && !isInGhostHouse(g.pos.x, g.pos.y);
-                if (!intoDoorFromOutside) {
-                    forwardBlocked = false;
-                    }
-                }
-
-            // count possible path neighbor, pathDir
-            int open = 0; bool pathDirOpen = false;
-            const Tile dirs4[4] = { {1,0},{-1,0},{0,1},{0,-1} };
-            for (auto d : dirs4) {
-                int nx = g.pos.x + d.x, ny = g.pos.y + d.y;
-                if (isWalkable(nx, ny)) {
-                    if (isGhostDoor(nx, ny) && !isInGhostHouse(g.pos.x, g.pos.y)) {
-                        continue;
-                    }
-                    ++open;
-                    if (deltaToDir(d) == pathDir) pathDirOpen = true;
-                }
-            }
+            // forward, possible path neighbors, pathDir
+            const std::uint8_t exits = ghostExits(pos);
+            bool forwardBlocked = !hasExit(exits, dir);
+            int open = exitCount(exits);
+            bool pathDirOpen = hasExit(exits, pathDir);
 
             // 1. straight,  2. intersection, 3. Blocked ahead, 4. corner&pathDir
            if (pathDir != Direction::None) {
-                if (pathDir == g.dir) {
+                if (pathDir == dir) {
                     desired = pathDir;
-                } else if (isIntersection(g.pos) || forwardBlocked || (open == 2 && pathDirOpen)) {
+                } else if (isIntersection(pos) || forwardBlocked || (open == 2 && pathDirOpen)) {
                     desired = pathDir;
                 }
             }
 
            // push path index
-            if (g.pos == next && g.pathIndex + 1 < (int)g.path.size()) {
-                ++g.pathIndex;
+            if (pos == next && route.pathIndex + 1 < (int)route.path.size()) {
+                ++route.pathIndex;
             }
         }
         // 2) PATROL
-        else if (g.state == GhostState::Patrol &&
-                 !g.patrolPath.empty())
+        else if (ghosts.state[i] == GhostState::Patrol &&
+                 !route.patrolPath.empty())
         {
-            const Tile& target = g.patrolPath[g.patrolIndex];
-            if (g.pos == target) {
-                g.patrolIndex = (g.patrolIndex + 1) % g.patrolPath.size();
+            const Tile& target = route.patrolPath[route.patrolIndex];
+            if (pos == target) {
+                route.patrolIndex = (route.patrolIndex + 1) % route.patrolPath.size();
             }
-            const Tile& next = g.patrolPath[g.patrolIndex];
-            Tile delta{ next.x - g.pos.x, next.y - g.pos.y };
+            const Tile& next = route.patrolPath[route.patrolIndex];
+            Tile delta{ next.x - pos.x, next.y - pos.y };
             Direction patrolDir = deltaToDir(delta);
             if (patrolDir != Direction::None) {
                 desired = patrolDir;
@@ -643,13 +1077,10 @@ namespace game {
 
         //Corner pathfinding fixes
         {
-            Direction baseDir = (desired != Direction::None) ? desired : g.dir;
-            Tile fwd = { g.pos.x + dirToDelta(baseDir).x,
-                         g.pos.y + dirToDelta(baseDir).y };
+            Direction baseDir = (desired != Direction::None) ? desired : dir;
+            const std::uint8_t exits = ghostExits(pos);
 
-            bool blocked = !isWalkable(fwd.x, fwd.y) ||
-                           (isGhostDoor(fwd.x, fwd.y) &&
-                            !isInGhostHouse(g.pos.x, g.pos.y));
+            bool blocked = !hasExit(exits, baseDir);
 
             if (blocked) {
                 Direction candidates[3] = {
@@ -659,14 +1090,7 @@ namespace game {
                 };
 
                 for (Direction cd : candidates) {
-                    if (cd == Direction::None) continue;
-                    Tile step = dirToDelta(cd);
-                    int nx = g.pos.x + step.x;
-                    int ny = g.pos.y + step.y;
-                    if (!isWalkable(nx, ny)) continue;
-                    if (isGhostDoor(nx, ny) && !isInGhostHouse(g.pos.x, g.pos.y)) {
-                        continue;
-                    }
+                    if (!hasExit(exits, cd)) continue;
                     desired = cd;
                     break;
                 }
@@ -674,70 +1098,92 @@ namespace game {
         }
 
         // dead end
-        if (isDeadEnd(g.pos, g.dir)) {
-            desired = turnBack(g.dir);
+        if (isDeadEnd(pos, dir)) {
+            desired = turnBack(dir);
         }
 
-        g.dir = desired;
+        dir = desired;
         
         // Slow down monster movement (similar to player speed)
+        // Leftover time carries into the next step so the speed doesn't depend on dt
         const double monsterMoveSpeed = 3.5; // Slightly slower than player (4.0)
-        g.moveTimer += dt;
-        if (g.moveTimer >= (1.0 / monsterMoveSpeed)) {
-            g.moveTimer = 0.0;
-            Tile d = dirToDelta(g.dir);
-            Tile newPos{ g.pos.x + d.x, g.pos.y + d.y };
-            bool fromOutsideIntoDoor = isGhostDoor(newPos.x, newPos.y) && !isInGhostHouse(g.pos.x, g.pos.y);
-            if (isWalkable(newPos.x, newPos.y) && !fromOutsideIntoDoor) {
-                g.pos = newPos;
-                g.stepCounter++;
+        ghosts.moveTimer[i] += dt;
+        if (ghosts.moveTimer[i] >= (1.0 / monsterMoveSpeed)) {
+            ghosts.moveTimer[i] -= 1.0 / monsterMoveSpeed;
+            if (hasExit(ghostExits(pos), dir)) {
+                Tile d = dirToDelta(dir);
+                pos = Tile{ pos.x + d.x, pos.y + d.y };
+                occupancy.place(static_cast<int>(i), pos);
+                ghosts.stepCounter[i]++;
             }
         }
 
-        // Collision detection (with player)
-        Tile playerTile{ player.gridX, player.gridY };
-        auto respawnGhost = [&](Ghost& gg) {
-        gg.pos = gg.spawnPos;
-        gg.prevPos = gg.spawnPos;
-        gg.state = GhostState::Patrol;
-        gg.path.clear();
-        gg.pathIndex = 0;
-        gg.patrolPath = generatePatrolLoop(gg.spawnPos);
-        gg.patrolIndex = 0;
-        gg.spawnDelay = 2.0; // small delay before it can chase again
-    };
-
-    if (g.pos == playerTile) {
+    }
+
+    // Collide
+    void MonsterSystem::resolvePlayerCollisions(bool leaderOnly) {
+        const Tile playerTile{ player.gridX, player.gridY };
+        occupancy.forEachOn(playerTile, [&](int a) {
+            if ((a == redGhost) == leaderOnly) {
+                collideWithPlayer(static_cast<std::size_t>(a));
+            }
+        });
+    }
+
+    void MonsterSystem::collideWithPlayer(std::size_t i) {
+        // Sitting out a hit: the same contact must not cost two lives
+        if (ghosts.hitFreezeSteps[i] > 0) {
+            return;
+        }
+
         // POWER state: player eats ghost -> respawn at spawn
         if (player.isPowered) {
-            respawnGhost(g);
+            respawnGhost(i);
+            ++events.ghostsEaten;
             return;
         }
 
         // Not POWER – decide who "wins" this collision.
+        const Tile pos = ghosts.pos[i];
+        Tile playerTile{ player.gridX, player.gridY };
         Tile prevP = prevPlayerTile;
-        Tile prevG = g.prevPos;
+        Tile prevG = ghosts.prevPos[i];
         Tile dP{ playerTile.x - prevP.x, playerTile.y - prevP.y };
-        Tile dG{ g.pos.x - prevG.x,       g.pos.y - prevG.y };
+        Tile dG{ pos.x - prevG.x,       pos.y - prevG.y };
 
         bool playerMovedInto = (prevP.x != playerTile.x || prevP.y != playerTile.y) &&
-                              (prevP.x + dP.x == g.pos.x && prevP.y + dP.y == g.pos.y);
-        bool ghostMovedInto  = (prevG.x != g.pos.x || prevG.y != g.pos.y) &&
+                              (prevP.x + dP.x == pos.x && prevP.y + dP.y == pos.y);
+        bool ghostMovedInto  = (prevG.x != pos.x || prevG.y != pos.y) &&
                               (prevG.x + dG.x == playerTile.x && prevG.y + dG.y == playerTile.y);
 
         // behind collision rule
-        Tile back = dirToDelta(g.dir);
+        Tile back = dirToDelta(ghosts.dir[i]);
         bool fromBehind = (dP.x == back.x && dP.y == back.y);
 
         if (playerMovedInto && !ghostMovedInto && fromBehind) {
             // Player behind ghost -> respawn ghost at spawn
-            respawnGhost(g);
+            respawnGhost(i);
         } else {
             // else = playerHit event
             events.playerHit = true;
-            g.hitFreezeSteps = 1;
+            ++events.hits;
+            ghosts.hitFreezeSteps[i] = HitFreezeUpdates + 1;   // counted down at the next update's start
         }
     }
+
+    void MonsterSystem::respawnGhost(std::size_t i) {
+        GhostRoute& route = ghosts.routes[i];
+        ghosts.pos[i] = ghosts.spawnPos[i];
+        occupancy.place(static_cast<int>(i), ghosts.pos[i]);
+        ghosts.prevPos[i] = ghosts.spawnPos[i];
+        ghosts.state[i] = GhostState::Patrol;
+        route.path.clear();
+        route.pathIndex = 0;
+        route.pathPlanned = false;
+        route.patrolPath = generatePatrolLoop(ghosts.spawnPos[i]);
+        route.patrolLookup.invalidate();
+        route.patrolIndex = 0;
+        ghosts.spawnDelay[i] = 2.0; // small delay before it can chase again
     }
 
-} 
\ No newline at end of file
+}
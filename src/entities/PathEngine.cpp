@@ -0,0 +1,368 @@
+#include "entities/PathEngine.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+namespace game {
+
+    namespace {
+        // Neighbour order used by every engine: right, left, down, up
+        struct Step { Direction dir; int dx; int dy; };
+        const Step kSteps[4] = {
+            { Direction::Right,  1,  0 },
+            { Direction::Left,  -1,  0 },
+            { Direction::Down,   0,  1 },
+            { Direction::Up,     0, -1 },
+        };
+
+        bool insideGrid(const TraversalMasks& masks, const Tile& t) {
+            return static_cast<unsigned>(t.x) < static_cast<unsigned>(masks.width()) &&
+                   static_cast<unsigned>(t.y) < static_cast<unsigned>(masks.height());
+        }
+
+        int manhattan(int a, int b, int w) {
+            return std::abs(a % w - b % w) + std::abs(a / w - b / w);
+        }
+
+        // Open-list entry ordered by f, then by h (deeper nodes first)
+        struct OpenNode {
+            int f;
+            int h;
+            int index;
+        };
+        struct OpenNodeAfter {
+            bool operator()(const OpenNode& a, const OpenNode& b) const {
+                return a.f != b.f ? a.f > b.f : a.h > b.h;
+            }
+        };
+
+        // Tiles of the straight run from `from` (exclusive) to `to`
+        // (inclusive), appended to path
+        void appendRun(int from, int to, int w, std::vector<Tile>& path) {
+            const int dx = (to % w > from % w) - (to % w < from % w);
+            const int dy = (to / w > from / w) - (to / w < from / w);
+            for (int x = from % w, y = from / w; x != to % w || y != to / w;) {
+                x += dx;
+                y += dy;
+                path.push_back(Tile{ x, y });
+            }
+        }
+
+        class BfsEngine : public PathEngine {
+        public:
+            PathAlgorithm algorithm() const override { return PathAlgorithm::BFS; }
+
+            int search(const TraversalMasks& masks, Traversal who,
+                       const Tile& start, const Tile& goal,
+                       int maxLength, std::vector<Tile>* path) override
+            {
+                if (path) path->clear();
+                if (!insideGrid(masks, start) || !insideGrid(masks, goal)) return -1;
+                if (start == goal) return 0;
+
+                const int W = masks.width();
+                const std::uint8_t* exits = masks.data(who);
+                const int startIndex = start.y * W + start.x;
+                const int goalIndex = goal.y * W + goal.x;
+
+                // Range-limited queries (perception checks) only visit tiles
+                // that could still reach the goal in time: d + Manhattan
+                // distance <= maxLength. Such tiles keep the parents they
+                // would have had in a full search, so the path is unchanged.
+                const bool bounded = maxLength < std::numeric_limits<int>::max();
+                if (bounded && manhattan(startIndex, goalIndex, W) > maxLength) {
+                    countQuery(0);
+                    return -1;
+                }
+
+                work.begin(static_cast<std::size_t>(W) * masks.height());
+                work.visit(startIndex, -1, 0);
+                work.push(startIndex);
+
+                int expanded = 0;
+                int length = -1;
+                while (!work.empty()) {
+                    const int cur = work.pop();
+                    const int d = work.distanceOf(cur);
+                    if (cur == goalIndex) { length = d; break; }
+                    if (d >= maxLength) continue;
+                    ++expanded;
+
+                    for (const auto& step : kSteps) {
+                        if (!hasExit(exits[cur], step.dir)) continue;
+                        const int nxt = cur + step.dy * W + step.dx;
+                        if (work.visited(nxt)) continue;
+                        if (bounded && d + 1 + manhattan(nxt, goalIndex, W) > maxLength) continue;
+                        work.visit(nxt, cur, d + 1);
+                        work.push(nxt);
+                    }
+                }
+                countQuery(expanded);
+
+                if (length > 0 && path) {
+                    for (int cur = goalIndex; cur != startIndex; cur = work.parentOf(cur)) {
+                        path->push_back(Tile{ cur % W, cur / W });
+                    }
+                    std::reverse(path->begin(), path->end());
+                }
+                return length;
+            }
+        };
+
+        class AStarEngine : public PathEngine {
+        public:
+            PathAlgorithm algorithm() const override { return PathAlgorithm::AStar; }
+
+            int search(const TraversalMasks& masks, Traversal who,
+                       const Tile& start, const Tile& goal,
+                       int maxLength, std::vector<Tile>* path) override
+            {
+                if (path) path->clear();
+                if (!insideGrid(masks, start) || !insideGrid(masks, goal)) return -1;
+                if (start == goal) return 0;
+
+                const int W = masks.width();
+                const std::uint8_t* exits = masks.data(who);
+                const int startIndex = start.y * W + start.x;
+                const int goalIndex = goal.y * W + goal.x;
+
+                // visit() records the best g found so far; stale heap entries
+                // (g larger than recorded) are skipped when popped
+                work.begin(static_cast<std::size_t>(W) * masks.height());
+                open.clear();
+                work.visit(startIndex, -1, 0);
+                const int h0 = manhattan(startIndex, goalIndex, W);
+                if (h0 > maxLength) {
+                    countQuery(0);
+                    return -1;
+                }
+                open.push_back(OpenNode{ h0, h0, startIndex });
+
+                int expanded = 0;
+                int length = -1;
+                while (!open.empty()) {
+                    std::pop_heap(open.begin(), open.end(), OpenNodeAfter{});
+                    const OpenNode node = open.back();
+                    open.pop_back();
+                    const int g = node.f - node.h;
+                    if (g > work.distanceOf(node.index)) continue;
+                    if (node.index == goalIndex) { length = g; break; }
+                    ++expanded;
+
+                    for (const auto& step : kSteps) {
+                        if (!hasExit(exits[node.index], step.dir)) continue;
+                        const int nxt = node.index + step.dy * W + step.dx;
+                        const int ng = g + 1;
+                        if (work.visited(nxt) && work.distanceOf(nxt) <= ng) continue;
+                        const int h = manhattan(nxt, goalIndex, W);
+                        if (ng + h > maxLength) continue;
+                        work.visit(nxt, node.index, ng);
+                        open.push_back(OpenNode{ ng + h, h, nxt });
+                        std::push_heap(open.begin(), open.end(), OpenNodeAfter{});
+                    }
+                }
+                countQuery(expanded);
+
+                if (length > 0 && path) {
+                    for (int cur = goalIndex; cur != startIndex; cur = work.parentOf(cur)) {
+                        path->push_back(Tile{ cur % W, cur / W });
+                    }
+                    std::reverse(path->begin(), path->end());
+                }
+                return length;
+            }
+
+        private:
+            std::vector<OpenNode> open;   // binary heap, storage reused
+        };
+
+        // Jump point search for 4-connected grids. Shortest paths are taken in
+        // a canonical form where a horizontal move never follows a vertical
+        // one unless it has to: swapping "vertical, then horizontal" for
+        // "horizontal, then vertical" is only impossible when the tile beside
+        // the previous one is not walkable that way. So
+        //   - vertical runs stop at the goal or where such a forced turn opens,
+        //   - horizontal runs stop at the goal or where a vertical run from the
+        //     tile would stop,
+        // and only those tiles enter the open list. Moves are checked against
+        // the exit masks, so one-way tiles (ghost doors) are handled exactly.
+        // Search states are (tile, arrival direction), as the successors of a
+        // jump point depend on how it was reached.
+        class JumpPointEngine : public PathEngine {
+        public:
+            PathAlgorithm algorithm() const override { return PathAlgorithm::JumpPoint; }
+
+            int search(const TraversalMasks& masks, Traversal who,
+                       const Tile& start, const Tile& goal,
+                       int maxLength, std::vector<Tile>* path) override
+            {
+                if (path) path->clear();
+                if (!insideGrid(masks, start) || !insideGrid(masks, goal)) return -1;
+                if (start == goal) return 0;
+
+                W = masks.width();
+                exits = masks.data(who);
+                goalIndex = goal.y * W + goal.x;
+                const int startIndex = start.y * W + start.x;
+                const int cells = W * masks.height();
+
+                // State s = direction * cells + tile; the start uses the
+                // Direction::None slot
+                work.begin(static_cast<std::size_t>(cells) * 5);
+                open.clear();
+                const int startState = static_cast<int>(Direction::None) * cells + startIndex;
+                work.visit(startState, -1, 0);
+                const int h0 = manhattan(startIndex, goalIndex, W);
+                if (h0 > maxLength) {
+                    countQuery(0);
+                    return -1;
+                }
+                open.push_back(OpenNode{ h0, h0, startState });
+
+                int expanded = 0;
+                jumpSteps = 0;
+                int length = -1;
+                int goalState = -1;
+                while (!open.empty()) {
+                    std::pop_heap(open.begin(), open.end(), OpenNodeAfter{});
+                    const OpenNode node = open.back();
+                    open.pop_back();
+                    const int g = node.f - node.h;
+                    if (g > work.distanceOf(node.index)) continue;
+                    const int tileIndex = node.index % cells;
+                    if (tileIndex == goalIndex) { length = g; goalState = node.index; break; }
+                    ++expanded;
+
+                    const Direction arrived = static_cast<Direction>(node.index / cells);
+                    for (const auto& step : kSteps) {
+                        if (!wantsSuccessor(tileIndex, arrived, step.dir)) continue;
+                        const int jp = isHorizontal(step.dir) ? jumpHorizontal(tileIndex, step.dir)
+                                                              : jumpVertical(tileIndex, step.dir);
+                        if (jp < 0) continue;
+                        const int ng = g + manhattan(tileIndex, jp, W);
+                        const int h = manhattan(jp, goalIndex, W);
+                        if (ng + h > maxLength) continue;
+                        const int state = static_cast<int>(step.dir) * cells + jp;
+                        if (work.visited(state) && work.distanceOf(state) <= ng) continue;
+                        work.visit(state, node.index, ng);
+                        open.push_back(OpenNode{ ng + h, h, state });
+                        std::push_heap(open.begin(), open.end(), OpenNodeAfter{});
+                    }
+                }
+                countQuery(expanded, expanded + jumpSteps);
+
+                if (length > 0 && path) {
+                    // Jump points back to the start, then fill in each straight run
+                    jumpPoints.clear();
+                    for (int s = goalState; s >= 0; s = work.parentOf(s)) {
+                        jumpPoints.push_back(s % cells);
+                    }
+                    for (std::size_t i = jumpPoints.size() - 1; i > 0; --i) {
+                        appendRun(jumpPoints[i], jumpPoints[i - 1], W, *path);
+                    }
+                }
+                return length;
+            }
+
+        private:
+            static bool isHorizontal(Direction d) {
+                return d == Direction::Left || d == Direction::Right;
+            }
+
+            static int deltaOf(Direction d, int w) {
+                switch (d) {
+                    case Direction::Right: return 1;
+                    case Direction::Left:  return -1;
+                    case Direction::Down:  return w;
+                    case Direction::Up:    return -w;
+                    default:               return 0;
+                }
+            }
+
+            static Direction reverseOf(Direction d) {
+                switch (d) {
+                    case Direction::Right: return Direction::Left;
+                    case Direction::Left:  return Direction::Right;
+                    case Direction::Down:  return Direction::Up;
+                    case Direction::Up:    return Direction::Down;
+                    default:               return Direction::None;
+                }
+            }
+
+            bool canStep(int index, Direction d) const { return hasExit(exits[index], d); }
+
+            // After stepping vertically into `index`, turning `side` is forced
+            // if the same two moves in the other order are not possible
+            bool forcedTurn(int index, Direction vertical, Direction side) const {
+                if (!canStep(index, side)) return false;
+                const int prev = index - deltaOf(vertical, W);
+                return !(canStep(prev, side) && canStep(prev + deltaOf(side, W), vertical));
+            }
+
+            bool wantsSuccessor(int index, Direction arrived, Direction d) const {
+                if (arrived == Direction::None) return true;           // start: all four
+                if (d == reverseOf(arrived)) return false;
+                if (isHorizontal(arrived)) return true;                // ahead, up, down
+                if (d == arrived) return true;                         // vertical: ahead
+                return forcedTurn(index, arrived, d);                  // and forced turns
+            }
+
+            int jumpVertical(int index, Direction d) {
+                const int delta = deltaOf(d, W);
+                while (canStep(index, d)) {
+                    index += delta;
+                    ++jumpSteps;
+                    if (index == goalIndex ||
+                        forcedTurn(index, d, Direction::Left) ||
+                        forcedTurn(index, d, Direction::Right)) {
+                        return index;
+                    }
+                }
+                return -1;
+            }
+
+            // Every tile stepped onto, including those of the vertical
+            // probes, counts towards jumpSteps
+            int jumpHorizontal(int index, Direction d) {
+                const int delta = deltaOf(d, W);
+                while (canStep(index, d)) {
+                    index += delta;
+                    ++jumpSteps;
+                    if (index == goalIndex ||
+                        jumpVertical(index, Direction::Up) >= 0 ||
+                        jumpVertical(index, Direction::Down) >= 0) {
+                        return index;
+                    }
+                }
+                return -1;
+            }
+
+            int W = 0;
+            int goalIndex = -1;
+            int jumpSteps = 0;      // tiles stepped onto by jumps, this query
+            const std::uint8_t* exits = nullptr;
+            std::vector<OpenNode> open;
+            std::vector<int> jumpPoints;
+        };
+    }
+
+    const char* pathAlgorithmName(PathAlgorithm algorithm) {
+        switch (algorithm) {
+            case PathAlgorithm::BFS:       return "bfs";
+            case PathAlgorithm::AStar:     return "astar";
+            case PathAlgorithm::JumpPoint: return "jps";
+        }
+        return "unknown";
+    }
+
+    std::unique_ptr<PathEngine> makePathEngine(PathAlgorithm algorithm) {
+        switch (algorithm) {
+            case PathAlgorithm::AStar:     return std::unique_ptr<PathEngine>(new AStarEngine());
+            case PathAlgorithm::JumpPoint: return std::unique_ptr<PathEngine>(new JumpPointEngine());
+            case PathAlgorithm::BFS:
+            default:                       return std::unique_ptr<PathEngine>(new BfsEngine());
+        }
+    }
+
+}
@@ -0,0 +1,198 @@
+// ChunkedTileStore.cpp
+#include "map/ChunkedTileStore.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+    // FNV-1a over 64-bit words; only used to find candidate duplicates
+    std::uint64_t hashCells(const std::uint8_t* cells, std::size_t length) {
+        std::uint64_t hash = 0xCBF29CE484222325ull;
+        for (std::size_t i = 0; i < length; i += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, cells + i, sizeof(word));
+            hash = (hash ^ word) * 0x100000001B3ull;
+        }
+        return hash ^ (hash >> 29);
+    }
+
+}
+
+void ChunkedTileStore::build(const std::uint8_t* cells, int width, int height) {
+    clear();
+    if (cells == nullptr || width <= 0 || height <= 0) {
+        return;
+    }
+    w = width;
+    h = height;
+    cw = (w + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+    ch = (h + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+
+    Chunk scratch;
+    scratch.cells.fill(game::tile::Wall);
+    pristine.push_back(scratch);                 // WALL_CHUNK
+    scratch.cells.fill(game::tile::Path);
+    pristine.push_back(scratch);                 // PATH_CHUNK
+
+    std::unordered_multimap<std::uint64_t, std::uint32_t> known;
+    known.emplace(hashCells(pristine[WALL_CHUNK].cells.data(), CHUNK_CELLS), WALL_CHUNK);
+    known.emplace(hashCells(pristine[PATH_CHUNK].cells.data(), CHUNK_CELLS), PATH_CHUNK);
+
+    pristineSlots.resize(static_cast<std::size_t>(cw) * ch);
+    for (int cy = 0; cy < ch; ++cy) {
+        for (int cx = 0; cx < cw; ++cx) {
+            // Gather the chunk, padding cells past the map edge with wall
+            scratch.cells.fill(game::tile::Wall);
+            const int x0 = cx << CHUNK_SHIFT;
+            const int y0 = cy << CHUNK_SHIFT;
+            const int spanX = std::min(CHUNK_SIZE, w - x0);
+            const int spanY = std::min(CHUNK_SIZE, h - y0);
+            for (int dy = 0; dy < spanY; ++dy) {
+                std::memcpy(&scratch.cells[static_cast<std::size_t>(dy) << CHUNK_SHIFT],
+                            cells + static_cast<std::size_t>(y0 + dy) * w + x0,
+                            static_cast<std::size_t>(spanX));
+            }
+
+            // Share it with an identical chunk if one exists
+            const std::uint64_t hash = hashCells(scratch.cells.data(), CHUNK_CELLS);
+            std::uint32_t index = static_cast<std::uint32_t>(pristine.size());
+            auto range = known.equal_range(hash);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (pristine[it->second].cells == scratch.cells) {
+                    index = it->second;
+                    break;
+                }
+            }
+            if (index == pristine.size()) {
+                pristine.push_back(scratch);
+                known.emplace(hash, index);
+            }
+            pristineSlots[static_cast<std::size_t>(cy) * cw + cx] = index;
+        }
+    }
+    pristine.shrink_to_fit();
+    liveSlots = pristineSlots;
+}
+
+void ChunkedTileStore::clear() {
+    w = h = cw = ch = 0;
+    pristine.clear();
+    pristine.shrink_to_fit();
+    pristineSlots.clear();
+    liveSlots.clear();
+    dirtySlots.clear();
+    // Working copies are kept for the next level; they are all free now
+    freeWorking.clear();
+    for (std::uint32_t i = 0; i < working.size(); ++i) {
+        freeWorking.push_back(i);
+    }
+}
+
+void ChunkedTileStore::set(int x, int y, std::uint8_t value) {
+    if (!inBounds(x, y)) {
+        return;
+    }
+    const std::size_t slot = slotOf(x, y);
+    std::uint32_t ref = liveSlots[slot];
+    if ((ref & DIRTY_BIT) == 0) {
+        if (pristine[ref].cells[cellOf(x, y)] == value) {
+            return;  // no change, keep sharing
+        }
+        // First write to this chunk: take a working copy
+        std::uint32_t copy;
+        if (!freeWorking.empty()) {
+            copy = freeWorking.back();
+            freeWorking.pop_back();
+            working[copy] = pristine[ref];
+        } else {
+            copy = static_cast<std::uint32_t>(working.size());
+            working.push_back(pristine[ref]);
+        }
+        ref = DIRTY_BIT | copy;
+        liveSlots[slot] = ref;
+        dirtySlots.push_back(static_cast<std::uint32_t>(slot));
+    }
+    working[ref & ~DIRTY_BIT].cells[cellOf(x, y)] = value;
+}
+
+void ChunkedTileStore::reset() {
+    for (std::uint32_t slot : dirtySlots) {
+        freeWorking.push_back(liveSlots[slot] & ~DIRTY_BIT);
+        liveSlots[slot] = pristineSlots[slot];
+    }
+    dirtySlots.clear();
+}
+
+// Cells past the map edge are padding and count as wall
+int ChunkedTileStore::count(std::uint8_t code) const {
+    // Count each distinct pristine chunk once, then weight by use
+    std::vector<int> pristineCounts(pristine.size());
+    for (std::size_t i = 0; i < pristine.size(); ++i) {
+        pristineCounts[i] = static_cast<int>(std::count(pristine[i].cells.begin(), pristine[i].cells.end(), code));
+    }
+    int total = 0;
+    for (std::uint32_t ref : liveSlots) {
+        if (ref & DIRTY_BIT) {
+            const Chunk& chunk = working[ref & ~DIRTY_BIT];
+            total += static_cast<int>(std::count(chunk.cells.begin(), chunk.cells.end(), code));
+        } else {
+            total += pristineCounts[ref];
+        }
+    }
+    return total;
+}
+
+int ChunkedTileStore::countInRect(int x0, int y0, int x1, int y1, std::uint8_t code) const {
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, w - 1);
+    y1 = std::min(y1, h - 1);
+    if (x0 > x1 || y0 > y1) {
+        return 0;
+    }
+
+    int total = 0;
+    for (int cy = y0 >> CHUNK_SHIFT; cy <= (y1 >> CHUNK_SHIFT); ++cy) {
+        for (int cx = x0 >> CHUNK_SHIFT; cx <= (x1 >> CHUNK_SHIFT); ++cx) {
+            const std::uint32_t ref = liveSlots[static_cast<std::size_t>(cy) * cw + cx];
+            const int ax = std::max(x0, cx << CHUNK_SHIFT);
+            const int ay = std::max(y0, cy << CHUNK_SHIFT);
+            const int bx = std::min(x1, (cx << CHUNK_SHIFT) + CHUNK_SIZE - 1);
+            const int by = std::min(y1, (cy << CHUNK_SHIFT) + CHUNK_SIZE - 1);
+
+            // Flyweights answer without touching cells
+            if (ref == WALL_CHUNK || ref == PATH_CHUNK) {
+                const std::uint8_t fill = (ref == WALL_CHUNK) ? game::tile::Wall : game::tile::Path;
+                if (fill == code) total += (bx - ax + 1) * (by - ay + 1);
+                continue;
+            }
+            const Chunk& chunk = liveChunk(static_cast<std::size_t>(cy) * cw + cx);
+            for (int y = ay; y <= by; ++y) {
+                const std::uint8_t* row = &chunk.cells[static_cast<std::size_t>(cellOf(ax, y))];
+                total += static_cast<int>(std::count(row, row + (bx - ax + 1), code));
+            }
+        }
+    }
+    return total;
+}
+
+void ChunkedTileStore::copyTo(game::MapGrid& out) const {
+    out.assign(w, h);
+    for (int y = 0; y < h; ++y) {
+        std::uint8_t* row = out.row(y);
+        for (int cx = 0; cx < cw; ++cx) {
+            const int x0 = cx << CHUNK_SHIFT;
+            const Chunk& chunk = liveChunk(slotOf(x0, y));
+            std::memcpy(row + x0, &chunk.cells[static_cast<std::size_t>(cellOf(0, y))],
+                        static_cast<std::size_t>(std::min(CHUNK_SIZE, w - x0)));
+        }
+    }
+}
+
+std::size_t ChunkedTileStore::memoryBytes() const {
+    return (pristine.capacity() + working.capacity()) * sizeof(Chunk) +
+           (pristineSlots.capacity() + liveSlots.capacity() + freeWorking.capacity() +
+            dirtySlots.capacity()) * sizeof(std::uint32_t);
+}
@@ -0,0 +1,379 @@
+// LevelLoader.cpp
+#include "map/LevelLoader.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// ---------------------------------------------------------------------------
+// MappedFile
+// ---------------------------------------------------------------------------
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(view, other.view);
+        std::swap(length, other.length);
+#ifdef _WIN32
+        std::swap(fileHandle, other.fileHandle);
+        std::swap(mappingHandle, other.mappingHandle);
+#endif
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        return false;
+    }
+    void* mapped = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (mapped == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    view = mapped;
+    length = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // the mapping keeps its own reference to the file
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    view = mapped;
+    length = static_cast<std::size_t>(st.st_size);
+#endif
+    return true;
+}
+
+void MappedFile::close() {
+    if (view == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(view);
+    CloseHandle(static_cast<HANDLE>(mappingHandle));
+    CloseHandle(static_cast<HANDLE>(fileHandle));
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    munmap(view, length);
+#endif
+    view = nullptr;
+    length = 0;
+}
+
+// ---------------------------------------------------------------------------
+// Parsing
+// ---------------------------------------------------------------------------
+
+namespace {
+
+    void setError(std::string* error, const std::string& message) {
+        if (error) {
+            *error = message;
+        }
+    }
+
+    void resetLevel(LevelData& out, int width, int height) {
+        out.tiles.assign(width, height, game::tile::Wall);
+        out.playerStart = game::Tile{};
+        out.monsterStarts.clear();
+        out.ghostHouse.clear();
+        out.ghostDoors.clear();
+        out.energyDots = 0;
+        out.powerPellets = 0;
+    }
+
+    // Store one map character; counts collectibles and records spawns
+    bool putCell(char c, int x, int y, LevelData& out, bool& sawPlayer, std::string* error) {
+        std::uint8_t& cell = out.tiles.at(x, y);
+        switch (c) {
+            case '#': cell = game::tile::Wall; break;
+            case ' ': cell = game::tile::Path; break;
+            case '.': cell = game::tile::Dot; ++out.energyDots; break;
+            case 'O': cell = game::tile::Pellet; ++out.powerPellets; break;
+            case 'G': cell = game::tile::House; out.ghostHouse.push_back(game::Tile{x, y}); break;
+            case 'D': cell = game::tile::Door; out.ghostDoors.push_back(game::Tile{x, y}); break;
+            case 'P':
+                if (sawPlayer) {
+                    setError(error, "more than one player start 'P' (second at " +
+                                    std::to_string(x) + ", " + std::to_string(y) + ")");
+                    return false;
+                }
+                sawPlayer = true;
+                out.playerStart = game::Tile{x, y};
+                cell = game::tile::Path;  // Player starts on empty tile
+                break;
+            case 'M':
+                out.monsterStarts.push_back(game::Tile{x, y});
+                cell = game::tile::Path;  // Monster starts on empty tile
+                break;
+            default:
+                setError(error, std::string("unknown map character '") + c + "' at (" +
+                                std::to_string(x) + ", " + std::to_string(y) + ")");
+                return false;
+        }
+        return true;
+    }
+
+    bool isBlank(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    // Read a non-negative decimal number; returns -1 on malformed / oversized input
+    int readNumber(const char* text, std::size_t length, std::size_t& pos) {
+        int value = 0;
+        std::size_t start = pos;
+        while (pos < length && text[pos] >= '0' && text[pos] <= '9') {
+            value = value * 10 + (text[pos] - '0');
+            if (value > LevelLoader::MAX_LEVEL_SIDE) {
+                return -1;
+            }
+            ++pos;
+        }
+        return pos == start ? -1 : value;
+    }
+
+    char tileChar(std::uint8_t cell) {
+        switch (cell) {
+            case game::tile::Wall: return '#';
+            case game::tile::House: return 'G';
+            case game::tile::Dot: return '.';
+            case game::tile::Pellet: return 'O';
+            case game::tile::Door: return 'D';
+            default: return ' ';
+        }
+    }
+
+}
+
+namespace LevelLoader {
+
+    bool parseLevelText(const char* text, std::size_t length, LevelData& out, std::string* error) {
+        std::size_t pos = 0;
+
+        // Skip comments and blank lines before the size header
+        while (pos < length) {
+            if (text[pos] == ';') {
+                while (pos < length && text[pos] != '\n') ++pos;
+            } else if (text[pos] != '\n' && !isBlank(text[pos])) {
+                break;
+            }
+            ++pos;
+        }
+
+        // Size header: "<width> <height>"
+        const int width = readNumber(text, length, pos);
+        while (pos < length && isBlank(text[pos])) ++pos;
+        const int height = readNumber(text, length, pos);
+        while (pos < length && isBlank(text[pos])) ++pos;
+        if (width <= 0 || height <= 0 || pos >= length || text[pos] != '\n') {
+            setError(error, "missing or invalid size header (expected \"<width> <height>\", each 1.." +
+                            std::to_string(MAX_LEVEL_SIDE) + ")");
+            return false;
+        }
+        ++pos;
+
+        resetLevel(out, width, height);
+        bool sawPlayer = false;
+
+        // Rows, written straight into the packed grid
+        for (int y = 0; y < height; ++y) {
+            if (length - pos < static_cast<std::size_t>(width)) {
+                setError(error, "level ends early at row " + std::to_string(y));
+                return false;
+            }
+            for (int x = 0; x < width; ++x) {
+                const char c = text[pos++];
+                if (c == '\n' || c == '\r') {
+                    setError(error, "row " + std::to_string(y) + " is shorter than " +
+                                    std::to_string(width) + " columns");
+                    return false;
+                }
+                if (!putCell(c, x, y, out, sawPlayer, error)) {
+                    return false;
+                }
+            }
+            if (pos < length && text[pos] == '\r') ++pos;
+            if (pos < length && text[pos] != '\n') {
+                setError(error, "row " + std::to_string(y) + " is longer than " +
+                                std::to_string(width) + " columns");
+                return false;
+            }
+            if (pos < length) ++pos;
+        }
+
+        // Only whitespace may follow the last row
+        for (; pos < length; ++pos) {
+            if (text[pos] != '\n' && !isBlank(text[pos])) {
+                setError(error, "unexpected data after the last row");
+                return false;
+            }
+        }
+
+        if (!sawPlayer) {
+            setError(error, "no player start 'P'");
+            return false;
+        }
+        return true;
+    }
+
+    bool parseLevelRows(const char* const* rows, int width, int height, LevelData& out, std::string* error) {
+        if (width <= 0 || height <= 0 || width > MAX_LEVEL_SIDE || height > MAX_LEVEL_SIDE) {
+            setError(error, "invalid level size");
+            return false;
+        }
+        resetLevel(out, width, height);
+        bool sawPlayer = false;
+        for (int y = 0; y < height; ++y) {
+            const char* row = rows[y];
+            for (int x = 0; x < width; ++x) {
+                if (row[x] == '\0') {
+                    setError(error, "row " + std::to_string(y) + " is shorter than " +
+                                    std::to_string(width) + " columns");
+                    return false;
+                }
+                if (!putCell(row[x], x, y, out, sawPlayer, error)) {
+                    return false;
+                }
+            }
+        }
+        if (!sawPlayer) {
+            setError(error, "no player start 'P'");
+            return false;
+        }
+        return true;
+    }
+
+    bool loadLevelFile(const std::string& path, LevelData& out, std::string* error) {
+        MappedFile file;
+        if (!file.open(path)) {
+            setError(error, path + ": cannot open or map file");
+            return false;
+        }
+        std::string parseError;
+        if (!parseLevelText(file.data(), file.size(), out, &parseError)) {
+            setError(error, path + ": " + parseError);
+            return false;
+        }
+        out.name = fs::path(path).stem().string();
+        return true;
+    }
+
+    std::vector<LevelData> loadLevelDirectory(const std::string& directory, std::vector<std::string>* errors) {
+        std::vector<LevelData> levels;
+
+        std::vector<fs::path> files;
+        std::error_code ec;
+        for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+            if (it->is_regular_file() && it->path().extension() == ".lvl") {
+                files.push_back(it->path());
+            }
+        }
+        if (ec && errors) {
+            errors->push_back(directory + ": " + ec.message());
+        }
+        std::sort(files.begin(), files.end());
+
+        levels.reserve(files.size());
+        for (const auto& file : files) {
+            LevelData level;
+            std::string error;
+            if (loadLevelFile(file.string(), level, &error)) {
+                levels.push_back(std::move(level));
+            } else if (errors) {
+                errors->push_back(error);
+            }
+        }
+        return levels;
+    }
+
+    std::string toLevelText(const LevelData& level) {
+        const int width = level.tiles.width();
+        const int height = level.tiles.height();
+
+        std::string text = std::to_string(width) + " " + std::to_string(height) + "\n";
+        const std::size_t header = text.size();
+        text.resize(header + static_cast<std::size_t>(width + 1) * height);
+
+        char* out = &text[header];
+        for (int y = 0; y < height; ++y) {
+            const std::uint8_t* row = level.tiles.row(y);
+            for (int x = 0; x < width; ++x) {
+                *out++ = tileChar(row[x]);
+            }
+            *out++ = '\n';
+        }
+
+        auto mark = [&](const game::Tile& t, char c) {
+            if (level.tiles.inBounds(t.x, t.y)) {
+                text[header + static_cast<std::size_t>(t.y) * (width + 1) + t.x] = c;
+            }
+        };
+        for (const auto& m : level.monsterStarts) {
+            mark(m, 'M');
+        }
+        mark(level.playerStart, 'P');
+        return text;
+    }
+
+    bool saveLevelFile(const std::string& path, const LevelData& level) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        const std::string text = toLevelText(level);
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+        return static_cast<bool>(file);
+    }
+
+}
@@ -0,0 +1,297 @@
+// LevelPack.cpp
+#include "map/LevelPack.h"
+
+#include <cstring>
+#include <fstream>
+
+using namespace levelpack;
+
+namespace {
+
+    void setError(std::string* error, const std::string& message) {
+        if (error) {
+            *error = message;
+        }
+    }
+
+    std::uint64_t alignUp(std::uint64_t value) {
+        return (value + 7u) & ~static_cast<std::uint64_t>(7u);
+    }
+
+    // True when [offset, offset + bytes) lies inside a buffer of `limit` bytes
+    bool fits(std::uint64_t offset, std::uint64_t bytes, std::uint64_t limit) {
+        return offset <= limit && bytes <= limit - offset;
+    }
+
+    void appendBytes(std::vector<char>& out, const void* data, std::size_t bytes) {
+        const char* p = static_cast<const char*>(data);
+        out.insert(out.end(), p, p + bytes);
+    }
+
+    void padTo8(std::vector<char>& out) {
+        out.resize(static_cast<std::size_t>(alignUp(out.size())), 0);
+    }
+
+    void appendTiles(std::vector<char>& out, const std::vector<game::Tile>& tiles) {
+        for (const auto& t : tiles) {
+            PackedTile packed{ t.x, t.y };
+            appendBytes(out, &packed, sizeof(packed));
+        }
+    }
+
+    // Serialize one level record (header plus sections) into `out`
+    void appendLevel(std::vector<char>& out, const LevelData& level) {
+        const int width = level.tiles.width();
+        const int height = level.tiles.height();
+
+        LevelRecord record;
+        std::memset(&record, 0, sizeof(record));
+        std::strncpy(record.name, level.name.c_str(), NAME_SIZE - 1);
+        record.width = static_cast<std::uint32_t>(width);
+        record.height = static_cast<std::uint32_t>(height);
+        record.playerX = level.playerStart.x;
+        record.playerY = level.playerStart.y;
+        record.monsterCount = static_cast<std::uint32_t>(level.monsterStarts.size());
+        record.houseCount = static_cast<std::uint32_t>(level.ghostHouse.size());
+        record.doorCount = static_cast<std::uint32_t>(level.ghostDoors.size());
+        // Counted from the tiles, whatever the LevelData claims
+        for (std::size_t i = 0; i < level.tiles.size(); ++i) {
+            record.energyDots += level.tiles.data()[i] == game::tile::Dot;
+            record.powerPellets += level.tiles.data()[i] == game::tile::Pellet;
+        }
+
+        // Section offsets, relative to the record
+        std::uint64_t cursor = alignUp(sizeof(LevelRecord));
+        record.tilesOffset = cursor;
+        cursor = alignUp(cursor + level.tiles.size());
+        record.monstersOffset = cursor;
+        cursor += sizeof(PackedTile) * level.monsterStarts.size();
+        record.houseOffset = cursor;
+        cursor += sizeof(PackedTile) * level.ghostHouse.size();
+        record.doorOffset = cursor;
+
+        appendBytes(out, &record, sizeof(record));
+        padTo8(out);
+        appendBytes(out, level.tiles.data(), level.tiles.size());
+        padTo8(out);
+        appendTiles(out, level.monsterStarts);
+        appendTiles(out, level.ghostHouse);
+        appendTiles(out, level.ghostDoors);
+    }
+
+    bool tilesInBounds(const PackedTile* tiles, std::uint32_t count, const LevelRecord& record) {
+        for (std::uint32_t i = 0; i < count; ++i) {
+            if (tiles[i].x < 0 || tiles[i].y < 0 ||
+                tiles[i].x >= static_cast<std::int32_t>(record.width) ||
+                tiles[i].y >= static_cast<std::int32_t>(record.height)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+bool LevelPack::open(const std::string& path, std::string* error) {
+    close();
+    if (!file.open(path)) {
+        setError(error, path + ": cannot open or map file");
+        return false;
+    }
+
+    const char* base = file.data();
+    const std::uint64_t fileSize = file.size();
+
+    auto fail = [&](const std::string& message) {
+        setError(error, path + ": " + message);
+        close();
+        return false;
+    };
+
+    if (fileSize < sizeof(PackHeader)) {
+        return fail("file too small for a level pack header");
+    }
+    PackHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        return fail("not a level pack (bad magic)");
+    }
+    if (header.endianTag != ENDIAN_TAG) {
+        return fail("level pack was written with a different byte order");
+    }
+    if (header.version != VERSION) {
+        return fail("unsupported level pack version " + std::to_string(header.version));
+    }
+    const std::uint64_t indexBytes = sizeof(PackIndexEntry) * static_cast<std::uint64_t>(header.levelCount);
+    if (!fits(sizeof(PackHeader), indexBytes, fileSize)) {
+        return fail("level index runs past the end of the file");
+    }
+
+    views.reserve(header.levelCount);
+    for (std::uint32_t i = 0; i < header.levelCount; ++i) {
+        PackIndexEntry entry;
+        std::memcpy(&entry, base + sizeof(PackHeader) + i * sizeof(PackIndexEntry), sizeof(entry));
+        const std::string where = "level " + std::to_string(i) + ": ";
+        if (!fits(entry.offset, entry.size, fileSize) || entry.size < sizeof(LevelRecord) || (entry.offset & 7u) != 0) {
+            return fail(where + "record out of bounds");
+        }
+
+        const char* recordBase = base + entry.offset;
+        LevelRecord record;
+        std::memcpy(&record, recordBase, sizeof(record));
+
+        if (record.width == 0 || record.height == 0 ||
+            record.width > static_cast<std::uint32_t>(LevelLoader::MAX_LEVEL_SIDE) ||
+            record.height > static_cast<std::uint32_t>(LevelLoader::MAX_LEVEL_SIDE)) {
+            return fail(where + "invalid size");
+        }
+        const std::uint64_t tileBytes = static_cast<std::uint64_t>(record.width) * record.height;
+        if (!fits(record.tilesOffset, tileBytes, entry.size) ||
+            !fits(record.monstersOffset, sizeof(PackedTile) * static_cast<std::uint64_t>(record.monsterCount), entry.size) ||
+            !fits(record.houseOffset, sizeof(PackedTile) * static_cast<std::uint64_t>(record.houseCount), entry.size) ||
+            !fits(record.doorOffset, sizeof(PackedTile) * static_cast<std::uint64_t>(record.doorCount), entry.size)) {
+            return fail(where + "section out of bounds");
+        }
+        if (((record.monstersOffset | record.houseOffset | record.doorOffset) & 3u) != 0) {
+            return fail(where + "misaligned section");
+        }
+        if (static_cast<std::uint64_t>(record.energyDots) + record.powerPellets > tileBytes) {
+            return fail(where + "item counts larger than the level");
+        }
+        if (record.playerX < 0 || record.playerY < 0 ||
+            record.playerX >= static_cast<std::int32_t>(record.width) ||
+            record.playerY >= static_cast<std::int32_t>(record.height)) {
+            return fail(where + "player start outside the map");
+        }
+
+        LevelPackView view;
+        view.name.assign(record.name, strnlen(record.name, NAME_SIZE));
+        view.width = static_cast<int>(record.width);
+        view.height = static_cast<int>(record.height);
+        view.energyDots = static_cast<int>(record.energyDots);
+        view.powerPellets = static_cast<int>(record.powerPellets);
+        view.playerStart = game::Tile{ record.playerX, record.playerY };
+        view.tiles = reinterpret_cast<const std::uint8_t*>(recordBase + record.tilesOffset);
+        view.monsterStarts = reinterpret_cast<const PackedTile*>(recordBase + record.monstersOffset);
+        view.monsterCount = static_cast<int>(record.monsterCount);
+        view.ghostHouse = reinterpret_cast<const PackedTile*>(recordBase + record.houseOffset);
+        view.houseCount = static_cast<int>(record.houseCount);
+        view.ghostDoors = reinterpret_cast<const PackedTile*>(recordBase + record.doorOffset);
+        view.doorCount = static_cast<int>(record.doorCount);
+        if (!tilesInBounds(view.monsterStarts, record.monsterCount, record) ||
+            !tilesInBounds(view.ghostHouse, record.houseCount, record) ||
+            !tilesInBounds(view.ghostDoors, record.doorCount, record)) {
+            return fail(where + "spawn or door tile outside the map");
+        }
+        views.push_back(view);
+    }
+    verified.assign(views.size(), false);
+    return true;
+}
+
+void LevelPack::close() {
+    views.clear();
+    verified.clear();
+    file.close();
+}
+
+bool LevelPack::verify(int index, std::string* error) {
+    if (index < 0 || index >= levelCount()) {
+        setError(error, "level " + std::to_string(index) + " is not in the pack");
+        return false;
+    }
+    if (verified[index]) {
+        return true;
+    }
+    const LevelPackView& view = views[index];
+    const std::string where = "level " + std::to_string(index) + ": ";
+
+    // The tile rules only know tile::Path..Door; reject anything else here
+    // rather than let each rule guess what it is
+    const std::size_t tileBytes = static_cast<std::size_t>(view.width) * view.height;
+    int dots = 0;
+    int pellets = 0;
+    for (std::size_t t = 0; t < tileBytes; ++t) {
+        const std::uint8_t cell = view.tiles[t];
+        if (cell > game::tile::Door) {
+            setError(error, where + "unknown tile code " + std::to_string(cell) + " at (" +
+                            std::to_string(t % view.width) + ", " + std::to_string(t / view.width) + ")");
+            return false;
+        }
+        dots += cell == game::tile::Dot;
+        pellets += cell == game::tile::Pellet;
+    }
+    if (dots != view.energyDots || pellets != view.powerPellets) {
+        setError(error, where + "baked counts (" + std::to_string(view.energyDots) + " dots, " +
+                        std::to_string(view.powerPellets) + " pellets) do not match the tiles");
+        return false;
+    }
+    verified[index] = true;
+    return true;
+}
+
+bool LevelPack::extract(int index, LevelData& out, std::string* error) {
+    if (!verify(index, error)) {
+        return false;
+    }
+    const LevelPackView& view = views[index];
+    out.name = view.name;
+    out.tiles.assign(view.width, view.height);
+    std::memcpy(out.tiles.data(), view.tiles, out.tiles.size());
+    out.playerStart = view.playerStart;
+    out.monsterStarts.clear();
+    for (int i = 0; i < view.monsterCount; ++i) {
+        out.monsterStarts.push_back(game::Tile{ view.monsterStarts[i].x, view.monsterStarts[i].y });
+    }
+    out.ghostHouse.clear();
+    for (int i = 0; i < view.houseCount; ++i) {
+        out.ghostHouse.push_back(game::Tile{ view.ghostHouse[i].x, view.ghostHouse[i].y });
+    }
+    out.ghostDoors.clear();
+    for (int i = 0; i < view.doorCount; ++i) {
+        out.ghostDoors.push_back(game::Tile{ view.ghostDoors[i].x, view.ghostDoors[i].y });
+    }
+    out.energyDots = view.energyDots;
+    out.powerPellets = view.powerPellets;
+    return true;
+}
+
+bool LevelPack::write(const std::string& path, const std::vector<LevelData>& levels, std::string* error) {
+    std::vector<char> out;
+
+    PackHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.endianTag = ENDIAN_TAG;
+    header.levelCount = static_cast<std::uint32_t>(levels.size());
+    appendBytes(out, &header, sizeof(header));
+
+    // Reserve the index; it is filled in once every record's position is known
+    const std::size_t indexStart = out.size();
+    out.resize(indexStart + sizeof(PackIndexEntry) * levels.size(), 0);
+
+    for (std::size_t i = 0; i < levels.size(); ++i) {
+        if (levels[i].tiles.empty()) {
+            setError(error, "level " + std::to_string(i) + " is empty");
+            return false;
+        }
+        padTo8(out);
+        PackIndexEntry entry;
+        entry.offset = out.size();
+        appendLevel(out, levels[i]);
+        entry.size = out.size() - entry.offset;
+        std::memcpy(&out[indexStart + i * sizeof(PackIndexEntry)], &entry, sizeof(entry));
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        setError(error, path + ": cannot open for writing");
+        return false;
+    }
+    file.write(out.data(), static_cast<std::streamsize>(out.size()));
+    if (!file) {
+        setError(error, path + ": write failed");
+        return false;
+    }
+    return true;
+}
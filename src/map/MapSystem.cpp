@@ -1,8 +1,11 @@
 // MapSystem.cpp
 #include "map/MapSystem.h"
 #include "external/fssimplewindow.h"
+#include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <cstring>
+#include <utility>
 
 const char* MAP1[] = {
     "###################",
@@ -83,106 +86,244 @@ MapSystem::MapSystem() {
     remainingPowerPellets = 0;
     mapWidth = 0;
     mapHeight = 0;
+    levelEnergyDots = 0;
+    levelPowerPellets = 0;
+    verbose = true;
+    storageMode = MapStorage::Dense;
+    requestedStorage = MapStorage::Dense;
+    houseListsEdited = false;
 }
 
 MapSystem::~MapSystem() {
 }
 
-TileType MapSystem::parseTileType(char c) {
-    switch(c) {
-        case '#': return WALL;           // Wall = 1
-        case ' ': return EMPTY;          // Empty path = 0
-        case '.': return ENERGY;         // Energy dot = 3
-        case 'O': return POWER_PELLET;   // Power pellet = 4
-        case 'G': return GHOST_HOUSE;    // Ghost house = 2
-        case 'D': return GHOST_DOOR;     // Ghost door = 5
-        case 'P': return EMPTY;          // Player start (will be stored separately)
-        case 'M': return EMPTY;          // Monster start (will be stored separately)
-        default: return EMPTY;
-    }
-}
-
 bool MapSystem::loadLevel(int levelId) {
     // Validate level ID
-    if (levelId < 1 || levelId > 3) {
+    if (levelId < 1 || levelId > getLevelCount()) {
         std::cout << "Error: Invalid level ID " << levelId << std::endl;
         return false;
     }
     
-    currentLevelId = levelId;
-    
-    // Select the appropriate map
-    const char** selectedMap = nullptr;
-    int rows = 21;
-    int cols = 19;
+    bool loaded = false;
+    if (levelPack.isOpen()) {
+        // Tile bytes are checked on a level's first load only
+        std::string error;
+        if (!levelPack.verify(levelId - 1, &error)) {
+            std::cout << "Error: " << error << std::endl;
+            return false;
+        }
+        loaded = loadLevel(levelPack.level(levelId - 1));
+    } else if (!levelLibrary.empty()) {
+        loaded = loadLevel(levelLibrary[levelId - 1]);
+    } else {
+        // Built-in maps: 21 rows x 19 columns
+        const char** selectedMap = nullptr;
+        switch(levelId) {
+            case 1: selectedMap = MAP1; break;
+            case 2: selectedMap = MAP2; break;
+            case 3: selectedMap = MAP3; break;
+        }
+        
+        LevelData level;
+        level.name = std::to_string(levelId);
+        std::string error;
+        if (!LevelLoader::parseLevelRows(selectedMap, 19, 21, level, &error)) {
+            std::cout << "Error: Built-in level " << levelId << ": " << error << std::endl;
+            return false;
+        }
+        loaded = loadLevel(level);
+    }
     
-    switch(levelId) {
-        case 1: selectedMap = MAP1; break;
-        case 2: selectedMap = MAP2; break;
-        case 3: selectedMap = MAP3; break;
+    if (loaded) {
+        currentLevelId = levelId;
+    }
+    return loaded;
+}
+
+bool MapSystem::loadLevel(const LevelData& level) {
+    if (level.tiles.empty()) {
+        std::cout << "Error: Empty level" << std::endl;
+        return false;
     }
     
     // Set map dimensions
-    mapHeight = rows;
-    mapWidth = cols;
+    mapWidth = level.tiles.width();
+    mapHeight = level.tiles.height();
     
-    // Clear previous data
-    tileMap.clear();
-    monsterStartPositions.clear();
-    remainingEnergyDots = 0;
-    remainingPowerPellets = 0;
-    
-    // Resize the tile map
-    tileMap.resize(mapHeight);
-    for (int i = 0; i < mapHeight; i++) {
-        tileMap[i].resize(mapWidth);
+    // Copy the packed tiles into the live grid (reuses its storage when the size matches)
+    storageMode = requestedStorage;
+    if (storageMode == MapStorage::Chunked) {
+        chunks.build(level.tiles);
+        tileMap = game::MapGrid();  // no stale dense copy after a switch
+    } else {
+        tileMap = level.tiles;
+        if (!chunks.empty()) chunks.clear();
     }
     
-    // Load map data
-    for (int y = 0; y < mapHeight; y++) {
-        for (int x = 0; x < mapWidth; x++) {
-            char c = selectedMap[y][x];
-            
-            // Check for special markers first
-            if (c == 'P') {
-                playerStartPos.x = x;
-                playerStartPos.y = y;
-                tileMap[y][x] = EMPTY;  // Player starts on empty tile
-            } else if (c == 'M') {
-                Position monsterPos;
-                monsterPos.x = x;
-                monsterPos.y = y;
-                monsterStartPositions.push_back(monsterPos);
-                tileMap[y][x] = EMPTY;  // Monster starts on empty tile
-            } else {
-                // Parse normal tile
-                TileType type = parseTileType(c);
-                tileMap[y][x] = type;
-                
-                // Count collectibles
-                if (type == ENERGY) {
-                    remainingEnergyDots++;
-                } else if (type == POWER_PELLET) {
-                    remainingPowerPellets++;
-                }
-            }
+    playerStartPos.x = level.playerStart.x;
+    playerStartPos.y = level.playerStart.y;
+    
+    auto toPositions = [](const std::vector<game::Tile>& tiles, std::vector<Position>& out) {
+        out.clear();
+        for (const auto& t : tiles) {
+            out.push_back(Position{t.x, t.y});
         }
+    };
+    toPositions(level.monsterStarts, monsterStartPositions);
+    toPositions(level.ghostHouse, ghostHouseTiles);
+    toPositions(level.ghostDoors, ghostDoorTiles);
+    
+    currentLevelId = 0;
+    
+    takeSnapshot();
+    logLevelLoaded(level.name);
+    return true;
+}
+
+bool MapSystem::loadLevel(const LevelPackView& level) {
+    if (level.tiles == nullptr || level.width <= 0 || level.height <= 0) {
+        std::cout << "Error: Empty level" << std::endl;
+        return false;
     }
     
-    std::cout << "Level " << levelId << " loaded successfully!" << std::endl;
-    std::cout << "Energy Dots: " << remainingEnergyDots << std::endl;
-    std::cout << "Power Pellets: " << remainingPowerPellets << std::endl;
-    std::cout << "Player Start: (" << playerStartPos.x << ", " << playerStartPos.y << ")" << std::endl;
-    std::cout << "Monster Starts: " << monsterStartPositions.size() << std::endl;
+    mapWidth = level.width;
+    mapHeight = level.height;
+    
+    // Sizes were validated against the file when the pack was opened
+    storageMode = requestedStorage;
+    if (storageMode == MapStorage::Chunked) {
+        chunks.build(level.tiles, mapWidth, mapHeight);
+        tileMap = game::MapGrid();
+    } else {
+        tileMap.assign(mapWidth, mapHeight);
+        std::memcpy(tileMap.data(), level.tiles, tileMap.size());
+        if (!chunks.empty()) chunks.clear();
+    }
     
+    playerStartPos.x = level.playerStart.x;
+    playerStartPos.y = level.playerStart.y;
+    
+    auto toPositions = [](const levelpack::PackedTile* tiles, int count, std::vector<Position>& out) {
+        out.clear();
+        for (int i = 0; i < count; ++i) {
+            out.push_back(Position{tiles[i].x, tiles[i].y});
+        }
+    };
+    toPositions(level.monsterStarts, level.monsterCount, monsterStartPositions);
+    toPositions(level.ghostHouse, level.houseCount, ghostHouseTiles);
+    toPositions(level.ghostDoors, level.doorCount, ghostDoorTiles);
+    
+    currentLevelId = 0;
+    
+    takeSnapshot(level.energyDots, level.powerPellets);
+    logLevelLoaded(level.name);
     return true;
 }
 
+// Keep the freshly loaded level so resets only have to undo pickups.
+// Item counts are the baked ones when given (>= 0), else counted.
+void MapSystem::takeSnapshot(int energyDots, int powerPellets) {
+    journal.restart();
+    houseListsEdited = false;
+    if (storageMode == MapStorage::Chunked) {
+        // The chunk store is its own snapshot; release every dense structure
+        tileMap = game::MapGrid();
+        pristineMap = game::MapGrid();
+        layers = game::TileLayers();
+        collectedMask = std::vector<std::uint64_t>();
+        changedMask = std::vector<std::uint64_t>();
+        collectedTiles = std::vector<int>();
+        remainingEnergyDots = energyDots >= 0 ? energyDots : chunks.count(ENERGY);
+        remainingPowerPellets = powerPellets >= 0 ? powerPellets : chunks.count(POWER_PELLET);
+        levelEnergyDots = remainingEnergyDots;
+        levelPowerPellets = remainingPowerPellets;
+        return;
+    }
+    chunks.clear();
+    
+    pristineMap = tileMap;
+    layers.build(tileMap);
+    
+    // Without baked counts, count the bitboards rather than trust the source
+    remainingEnergyDots = energyDots >= 0 ? energyDots : layers.dots.count();
+    remainingPowerPellets = powerPellets >= 0 ? powerPellets : layers.pellets.count();
+    levelEnergyDots = remainingEnergyDots;
+    levelPowerPellets = remainingPowerPellets;
+    
+    collectedMask.assign((tileMap.size() + 63) / 64, 0);
+    changedMask.assign(collectedMask.size(), 0);
+    collectedTiles.clear();
+    // Pickups alone never outgrow this; setTile() edits may grow it once, and
+    // resets keep the capacity
+    collectedTiles.reserve(static_cast<std::size_t>(levelEnergyDots + levelPowerPellets));
+}
+
+void MapSystem::logLevelLoaded(const std::string& name) const {
+    if (!verbose) {
+        return;
+    }
+    std::cout << "Level " << (name.empty() ? std::string("(unnamed)") : name)
+              << " loaded successfully! (" << mapWidth << "x" << mapHeight << ")\n";
+    if (storageMode == MapStorage::Chunked) {
+        std::cout << "Chunks: " << chunks.uniqueChunkCount() << " distinct of "
+                  << chunks.chunksX() * chunks.chunksY() << " (" << chunks.memoryBytes() / 1024 << " KiB)\n";
+    }
+    std::cout
+              << "Energy Dots: " << remainingEnergyDots << "\n"
+              << "Power Pellets: " << remainingPowerPellets << "\n"
+              << "Player Start: (" << playerStartPos.x << ", " << playerStartPos.y << ")\n"
+              << "Monster Starts: " << monsterStartPositions.size() << std::endl;
+}
+
+bool MapSystem::loadLevelFile(const std::string& path) {
+    LevelData level;
+    std::string error;
+    if (!LevelLoader::loadLevelFile(path, level, &error)) {
+        std::cout << "Error: " << error << std::endl;
+        return false;
+    }
+    return loadLevel(level);
+}
+
+int MapSystem::loadLevelDirectory(const std::string& directory) {
+    std::vector<std::string> errors;
+    std::vector<LevelData> levels = LevelLoader::loadLevelDirectory(directory, &errors);
+    for (const auto& error : errors) {
+        std::cout << "Error: " << error << std::endl;
+    }
+    if (levels.empty()) {
+        return 0;
+    }
+    levelLibrary = std::move(levels);
+    return static_cast<int>(levelLibrary.size());
+}
+
+int MapSystem::loadLevelPack(const std::string& path) {
+    LevelPack pack;
+    std::string error;
+    if (!pack.open(path, &error)) {
+        std::cout << "Error: " << error << std::endl;
+        return 0;
+    }
+    if (pack.levelCount() == 0) {
+        return 0;
+    }
+    levelPack = std::move(pack);
+    return levelPack.levelCount();
+}
+
+int MapSystem::getLevelCount() const {
+    if (levelPack.isOpen()) {
+        return levelPack.levelCount();
+    }
+    return levelLibrary.empty() ? 3 : static_cast<int>(levelLibrary.size());
+}
+
 TileType MapSystem::getTileAt(int x, int y) const {
     if (x < 0 || x >= mapWidth || y < 0 || y >= mapHeight) {
         return WALL; // Out of bounds treated as wall
     }
-    return tileMap[y][x];
+    return static_cast<TileType>(tileAt(x, y));
 }
 
 bool MapSystem::isWalkable(int x, int y) const {
@@ -190,7 +331,7 @@ bool MapSystem::isWalkable(int x, int y) const {
         return false;
     }
     
-    TileType tile = tileMap[y][x];
+    TileType tile = static_cast<TileType>(tileAt(x, y));
     
     return (tile == EMPTY || tile == ENERGY || tile == POWER_PELLET);
 }
@@ -200,61 +341,166 @@ void MapSystem::removeCollectible(int x, int y) {
         return;
     }
     
-    TileType tile = tileMap[y][x];
+    TileType tile = static_cast<TileType>(tileAt(x, y));
+    
+    if (tile != ENERGY && tile != POWER_PELLET) {
+        return;
+    }
+    writeTile(x, y, tile, EMPTY);
+    
+    if (storageMode == MapStorage::Dense) {
+        const int index = tileMap.index(x, y);
+        collectedMask[index >> 6] |= std::uint64_t{1} << (index & 63);
+    }
+}
+
+bool MapSystem::setTile(int x, int y, TileType type) {
+    if (x < 0 || x >= mapWidth || y < 0 || y >= mapHeight) {
+        return false;
+    }
+    const std::uint8_t before = tileAt(x, y);
+    if (before == type) {
+        return true;
+    }
+    writeTile(x, y, before, static_cast<std::uint8_t>(type));
+    
+    // Keep the ghost house / door lists in row-major order
+    auto rowMajor = [](const Position& a, const Position& b) {
+        return a.y != b.y ? a.y < b.y : a.x < b.x;
+    };
+    const Position pos{x, y};
+    auto removeFrom = [&](std::vector<Position>& tiles) {
+        auto it = std::lower_bound(tiles.begin(), tiles.end(), pos, rowMajor);
+        if (it != tiles.end() && it->x == x && it->y == y) tiles.erase(it);
+    };
+    auto insertInto = [&](std::vector<Position>& tiles) {
+        tiles.insert(std::lower_bound(tiles.begin(), tiles.end(), pos, rowMajor), pos);
+    };
+    if (before == GHOST_HOUSE) removeFrom(ghostHouseTiles);
+    if (before == GHOST_DOOR) removeFrom(ghostDoorTiles);
+    if (type == GHOST_HOUSE) insertInto(ghostHouseTiles);
+    if (type == GHOST_DOOR) insertInto(ghostDoorTiles);
+    if (before == GHOST_HOUSE || before == GHOST_DOOR || type == GHOST_HOUSE || type == GHOST_DOOR) {
+        houseListsEdited = true;
+    }
+    
+    if (storageMode == MapStorage::Dense) {
+        // A tile placed by hand is not a pickup
+        const int index = tileMap.index(x, y);
+        collectedMask[index >> 6] &= ~(std::uint64_t{1} << (index & 63));
+    }
+    return true;
+}
+
+// Single write path for the live map: storage, bitboards, counts, the
+// reset list and the journal
+void MapSystem::writeTile(int x, int y, std::uint8_t before, std::uint8_t after) {
+    if (before == ENERGY && remainingEnergyDots > 0) remainingEnergyDots--;
+    if (before == POWER_PELLET && remainingPowerPellets > 0) remainingPowerPellets--;
+    if (after == ENERGY) remainingEnergyDots++;
+    if (after == POWER_PELLET) remainingPowerPellets++;
     
-    if (tile == ENERGY) {         // ENERGY = 3
-        tileMap[y][x] = EMPTY;    // EMPTY = 0
-        remainingEnergyDots--;
-        if (remainingEnergyDots < 0) remainingEnergyDots = 0;
-    } else if (tile == POWER_PELLET) {  // POWER_PELLET = 4
-        tileMap[y][x] = EMPTY;          // EMPTY = 0
-        remainingPowerPellets--;
-        if (remainingPowerPellets < 0) remainingPowerPellets = 0;
+    if (storageMode == MapStorage::Chunked) {
+        // Copy-on-write: the first change in a chunk gives it a private copy
+        chunks.set(x, y, after);
+    } else {
+        const int index = tileMap.index(x, y);
+        // Remember the tile, once, so resetMapState() can undo just this one
+        const std::uint64_t bit = std::uint64_t{1} << (index & 63);
+        if ((changedMask[index >> 6] & bit) == 0) {
+            changedMask[index >> 6] |= bit;
+            collectedTiles.push_back(index);
+        }
+        tileMap.at(x, y) = after;
+        moveLayerBit(x, y, before, after);
+    }
+    journal.record(x, y, before, after);
+}
+
+void MapSystem::moveLayerBit(int x, int y, std::uint8_t before, std::uint8_t after) {
+    game::TileBitboard* const layerOf[6] = { nullptr, &layers.walls, &layers.house,
+                                             &layers.dots, &layers.pellets, &layers.doors };
+    if (before < 6 && layerOf[before]) layerOf[before]->clear(x, y);
+    if (after < 6 && layerOf[after]) layerOf[after]->set(x, y);
+}
+
+// Rebuild the ghost house / door lists from the level as loaded
+void MapSystem::restoreHouseLists() {
+    ghostHouseTiles.clear();
+    ghostDoorTiles.clear();
+    for (int y = 0; y < mapHeight; ++y) {
+        for (int x = 0; x < mapWidth; ++x) {
+            const std::uint8_t original = (storageMode == MapStorage::Chunked) ? chunks.pristineAt(x, y)
+                                                                               : pristineMap.at(x, y);
+            if (original == GHOST_HOUSE) ghostHouseTiles.push_back(Position{x, y});
+            if (original == GHOST_DOOR) ghostDoorTiles.push_back(Position{x, y});
+        }
+    }
+    houseListsEdited = false;
+}
+
+bool MapSystem::isCollected(int x, int y) const {
+    if (x < 0 || x >= mapWidth || y < 0 || y >= mapHeight) {
+        return false;
+    }
+    if (storageMode == MapStorage::Chunked) {
+        const std::uint8_t original = chunks.pristineAt(x, y);
+        return (original == ENERGY || original == POWER_PELLET) && chunks.at(x, y) != original;
     }
+    const int index = tileMap.index(x, y);
+    return (collectedMask[index >> 6] >> (index & 63)) & 1u;
 }
 
 bool MapSystem::isLevelComplete() const {
     return (remainingEnergyDots == 0 && remainingPowerPellets == 0);
 }
 
-void MapSystem::resetMapState() {
-    // Reload current level to reset all collectibles
-    loadLevel(currentLevelId);
+int MapSystem::countItemsInRect(int x0, int y0, int x1, int y1) const {
+    if (storageMode == MapStorage::Chunked) {
+        return chunks.countInRect(x0, y0, x1, y1, ENERGY) + chunks.countInRect(x0, y0, x1, y1, POWER_PELLET);
+    }
+    return layers.dots.countInRect(x0, y0, x1, y1) + layers.pellets.countInRect(x0, y0, x1, y1);
+}
+
+bool MapSystem::anyItemsInRect(int x0, int y0, int x1, int y1) const {
+    if (storageMode == MapStorage::Chunked) {
+        return countItemsInRect(x0, y0, x1, y1) > 0;
+    }
+    return layers.dots.anyInRect(x0, y0, x1, y1) || layers.pellets.anyInRect(x0, y0, x1, y1);
 }
 
-std::vector<std::vector<int>> MapSystem::getMapGrid() const {
-    std::vector<std::vector<int>> grid;
-    grid.resize(mapHeight);
+void MapSystem::resetMapState() {
+    if (storageMode == MapStorage::Chunked) {
+        // Only chunks with pickups hold working copies
+        chunks.forEachChange([&](int x, int y, std::uint8_t live, std::uint8_t original) {
+            journal.record(x, y, live, original);
+        });
+        chunks.reset();
+        remainingEnergyDots = levelEnergyDots;
+        remainingPowerPellets = levelPowerPellets;
+        if (houseListsEdited) restoreHouseLists();
+        return;
+    }
     
-    for (int y = 0; y < mapHeight; y++) {
-        grid[y].resize(mapWidth);
-        for (int x = 0; x < mapWidth; x++) {
-            TileType tile = tileMap[y][x];
-            // Convert TileType to game component format:
-            // 0 = path, 1 = wall, 2 = monster room, 3 = dot, 4 = power pellet
-            switch (tile) {
-                case EMPTY:
-                    grid[y][x] = 0;
-                    break;
-                case WALL:
-                    grid[y][x] = 1;
-                    break;
-                case GHOST_HOUSE:
-                    grid[y][x] = 2;
-                    break;
-                case ENERGY:
-                    grid[y][x] = 3;
-                    break;
-                case POWER_PELLET:
-                    grid[y][x] = 4;
-                    break;
-                case GHOST_DOOR:
-                    grid[y][x] = 5;
-                    break;
-            }
+    // Put back only the collectibles picked up since the level was loaded
+    std::uint8_t* cells = tileMap.data();
+    const std::uint8_t* pristine = pristineMap.data();
+    const int width = tileMap.width();
+    for (int index : collectedTiles) {
+        const int x = index % width;
+        const int y = index / width;
+        const std::uint8_t live = cells[index];
+        if (live != pristine[index]) {
+            moveLayerBit(x, y, live, pristine[index]);
+            cells[index] = pristine[index];
+            journal.record(x, y, live, pristine[index]);
         }
+        collectedMask[index >> 6] &= ~(std::uint64_t{1} << (index & 63));
+        changedMask[index >> 6] &= ~(std::uint64_t{1} << (index & 63));
     }
+    collectedTiles.clear();
     
-    return grid;
+    remainingEnergyDots = levelEnergyDots;
+    remainingPowerPellets = levelPowerPellets;
+    if (houseListsEdited) restoreHouseLists();
 }
-
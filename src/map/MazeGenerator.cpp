@@ -0,0 +1,368 @@
+// MazeGenerator.cpp
+#include "map/MazeGenerator.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+    void setError(std::string* error, const std::string& message) {
+        if (error) {
+            *error = message;
+        }
+    }
+
+    // SplitMix64: tiny, fast and identical on every compiler, unlike the
+    // standard distributions
+    class Rng {
+    public:
+        explicit Rng(std::uint64_t seed) : state(seed) {}
+
+        std::uint64_t next() {
+            std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        // Uniform in [0, n), n > 0
+        int below(int n) {
+            return static_cast<int>(next() % static_cast<std::uint64_t>(n));
+        }
+
+        bool chance(double p) {
+            return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0) < p;
+        }
+
+    private:
+        std::uint64_t state;
+    };
+
+    // Ghost house footprint: corridor ring around doors / house rows
+    //     .......      ring (path)
+    //     .DDDDD.
+    //     .GMMMG.
+    //     .GGGGG.
+    //     .......
+    constexpr int HOUSE_W = 7;
+    constexpr int HOUSE_H = 5;
+    constexpr int MIN_SIDE = 15;
+
+    struct HouseRect {
+        int x0;
+        int y0;
+        int x1() const { return x0 + HOUSE_W - 1; }
+        int y1() const { return y0 + HOUSE_H - 1; }
+    };
+
+    // Houses need a free corridor line between them so the maze stays connected
+    bool housesClash(const HouseRect& a, const HouseRect& b) {
+        return !(a.x0 >= b.x1() + 4 || b.x0 >= a.x1() + 4 ||
+                 a.y0 >= b.y1() + 4 || b.y0 >= a.y1() + 4);
+    }
+
+    double clamp01(double v) {
+        return v < 0.0 ? 0.0 : (v > 1.0 ? 1.0 : v);
+    }
+
+    struct Maze {
+        int width;
+        int height;
+        int maxX;   // last corridor column (odd)
+        int maxY;   // last corridor row (odd)
+        game::MapGrid tiles;
+        std::vector<std::uint8_t> reserved;  // 1 = part of a ghost house footprint
+
+        bool isCell(int x, int y) const {
+            return x >= 1 && y >= 1 && x <= maxX && y <= maxY && (x & 1) && (y & 1);
+        }
+        bool isReserved(int x, int y) const {
+            return reserved[static_cast<std::size_t>(tiles.index(x, y))] != 0;
+        }
+        bool isOpen(int x, int y) const {
+            return tiles.get(x, y) != game::tile::Wall;
+        }
+    };
+
+    const int kDx[4] = { 1, -1, 0, 0 };
+    const int kDy[4] = { 0, 0, 1, -1 };
+
+    void stampHouse(Maze& maze, const HouseRect& house, int monsters, std::vector<game::Tile>& monsterStarts) {
+        for (int dy = 0; dy < HOUSE_H; ++dy) {
+            for (int dx = 0; dx < HOUSE_W; ++dx) {
+                const int x = house.x0 + dx;
+                const int y = house.y0 + dy;
+                std::uint8_t cell = game::tile::Path;
+                if (dx > 0 && dx < HOUSE_W - 1 && dy > 0 && dy < HOUSE_H - 1) {
+                    if (dy == 1) {
+                        cell = game::tile::Door;
+                    } else if (dy == 2 && dx >= 2 && dx < 2 + monsters) {
+                        cell = game::tile::Path;  // Monster starts on empty tile
+                        monsterStarts.push_back(game::Tile{x, y});
+                    } else {
+                        cell = game::tile::House;
+                    }
+                }
+                maze.tiles.at(x, y) = cell;
+                maze.reserved[static_cast<std::size_t>(maze.tiles.index(x, y))] = 1;
+            }
+        }
+    }
+
+    // Iterative recursive-backtracker over the odd cells outside the houses
+    void carveCorridors(Maze& maze, Rng& rng) {
+        // (1, 1) is never inside a house: houses keep a corridor line of margin
+        std::vector<int> stack;
+        maze.tiles.at(1, 1) = game::tile::Path;
+        stack.push_back(maze.tiles.index(1, 1));
+
+        while (!stack.empty()) {
+            const int x = stack.back() % maze.width;
+            const int y = stack.back() / maze.width;
+
+            int options[4];
+            int optionCount = 0;
+            for (int d = 0; d < 4; ++d) {
+                const int nx = x + 2 * kDx[d];
+                const int ny = y + 2 * kDy[d];
+                if (maze.isCell(nx, ny) && !maze.isReserved(nx, ny) &&
+                    maze.tiles.at(nx, ny) == game::tile::Wall) {
+                    options[optionCount++] = d;
+                }
+            }
+            if (optionCount == 0) {
+                stack.pop_back();
+                continue;
+            }
+
+            const int d = options[rng.below(optionCount)];
+            maze.tiles.at(x + kDx[d], y + kDy[d]) = game::tile::Path;
+            maze.tiles.at(x + 2 * kDx[d], y + 2 * kDy[d]) = game::tile::Path;
+            stack.push_back(maze.tiles.index(x + 2 * kDx[d], y + 2 * kDy[d]));
+        }
+    }
+
+    // Open wall slots between two corridors with probability `density`
+    void addLoops(Maze& maze, Rng& rng, double density) {
+        if (density <= 0.0) {
+            return;
+        }
+        for (int y = 1; y <= maze.maxY; ++y) {
+            for (int x = 1; x <= maze.maxX; ++x) {
+                if (((x ^ y) & 1) == 0 || maze.isReserved(x, y) ||
+                    maze.tiles.at(x, y) != game::tile::Wall) {
+                    continue;
+                }
+                const bool horizontal = (x & 1) == 0;   // separates left / right cells
+                const bool joinsCorridors = horizontal
+                    ? maze.isOpen(x - 1, y) && maze.isOpen(x + 1, y)
+                    : maze.isOpen(x, y - 1) && maze.isOpen(x, y + 1);
+                if (joinsCorridors && rng.chance(density)) {
+                    maze.tiles.at(x, y) = game::tile::Path;
+                }
+            }
+        }
+    }
+
+    // Give every cell with a single exit a second one
+    void braidDeadEnds(Maze& maze, Rng& rng) {
+        for (int y = 1; y <= maze.maxY; y += 2) {
+            for (int x = 1; x <= maze.maxX; x += 2) {
+                if (maze.isReserved(x, y) || maze.tiles.at(x, y) == game::tile::Wall) {
+                    continue;
+                }
+                int exits = 0;
+                int options[4];
+                int optionCount = 0;
+                for (int d = 0; d < 4; ++d) {
+                    if (maze.isOpen(x + kDx[d], y + kDy[d])) {
+                        ++exits;
+                    } else if (maze.isCell(x + 2 * kDx[d], y + 2 * kDy[d]) &&
+                               maze.isOpen(x + 2 * kDx[d], y + 2 * kDy[d])) {
+                        options[optionCount++] = d;
+                    }
+                }
+                if (exits == 1 && optionCount > 0) {
+                    const int d = options[rng.below(optionCount)];
+                    maze.tiles.at(x + kDx[d], y + kDy[d]) = game::tile::Path;
+                }
+            }
+        }
+    }
+
+    // Open corridor cell closest to (tx, ty); ties go to the first in row-major order
+    game::Tile nearestCell(const Maze& maze, int tx, int ty, const std::vector<std::uint8_t>& taken) {
+        game::Tile best{-1, -1};
+        long long bestDist = -1;
+        for (int y = 1; y <= maze.maxY; y += 2) {
+            for (int x = 1; x <= maze.maxX; x += 2) {
+                const std::size_t i = static_cast<std::size_t>(maze.tiles.index(x, y));
+                if (maze.reserved[i] || taken[i] || maze.tiles.at(x, y) != game::tile::Path) {
+                    continue;
+                }
+                const long long dx = x - tx;
+                const long long dy = y - ty;
+                const long long dist = dx * dx + dy * dy;
+                if (bestDist < 0 || dist < bestDist) {
+                    bestDist = dist;
+                    best = game::Tile{x, y};
+                }
+            }
+        }
+        return best;
+    }
+
+}
+
+namespace MazeGenerator {
+
+    bool generate(const MazeConfig& config, LevelData& out, std::string* error) {
+        const int width = config.width;
+        const int height = config.height;
+        if (width < MIN_SIDE || height < MIN_SIDE ||
+            width > LevelLoader::MAX_LEVEL_SIDE || height > LevelLoader::MAX_LEVEL_SIDE) {
+            setError(error, "maze size must be " + std::to_string(MIN_SIDE) + ".." +
+                            std::to_string(LevelLoader::MAX_LEVEL_SIDE) + " on each side");
+            return false;
+        }
+        if (config.ghostHouses < 0 || config.monstersPerHouse < 0 || config.monstersPerHouse > 3 ||
+            config.powerPellets < 0) {
+            setError(error, "ghostHouses and powerPellets must be >= 0, monstersPerHouse 0..3");
+            return false;
+        }
+
+        Rng rng(config.seed);
+        Maze maze;
+        maze.width = width;
+        maze.height = height;
+        maze.maxX = (width & 1) ? width - 2 : width - 3;
+        maze.maxY = (height & 1) ? height - 2 : height - 3;
+        maze.tiles.assign(width, height, game::tile::Wall);
+        maze.reserved.assign(maze.tiles.size(), 0);
+
+        // Ghost houses: footprint corners on odd lines, one corridor line of margin
+        const int minCorner = 3;
+        const int maxCornerX = maze.maxX - (HOUSE_W - 1) - 2;
+        const int maxCornerY = maze.maxY - (HOUSE_H - 1) - 2;
+        std::vector<HouseRect> houses;
+        if (config.ghostHouses > 0) {
+            if (maxCornerX < minCorner || maxCornerY < minCorner) {
+                setError(error, "maze too small for a ghost house");
+                return false;
+            }
+            HouseRect centre{ (width / 2 - HOUSE_W / 2) | 1, (height / 2 - HOUSE_H) | 1 };
+            centre.x0 = std::min(std::max(centre.x0, minCorner), maxCornerX);
+            centre.y0 = std::min(std::max(centre.y0, minCorner), maxCornerY);
+            houses.push_back(centre);
+
+            const int spanX = (maxCornerX - minCorner) / 2 + 1;
+            const int spanY = (maxCornerY - minCorner) / 2 + 1;
+            for (int tries = 0; static_cast<int>(houses.size()) < config.ghostHouses && tries < 64 * config.ghostHouses; ++tries) {
+                HouseRect candidate{ minCorner + 2 * rng.below(spanX), minCorner + 2 * rng.below(spanY) };
+                bool fits = true;
+                for (const auto& other : houses) {
+                    if (housesClash(candidate, other)) {
+                        fits = false;
+                        break;
+                    }
+                }
+                if (fits) {
+                    houses.push_back(candidate);
+                }
+            }
+            if (static_cast<int>(houses.size()) < config.ghostHouses) {
+                setError(error, "could not fit " + std::to_string(config.ghostHouses) + " ghost houses in " +
+                                std::to_string(width) + "x" + std::to_string(height));
+                return false;
+            }
+        }
+
+        std::vector<game::Tile> monsterStarts;
+        for (const auto& house : houses) {
+            stampHouse(maze, house, config.monstersPerHouse, monsterStarts);
+        }
+
+        carveCorridors(maze, rng);
+
+        // Join each house ring to the maze above and below
+        for (const auto& house : houses) {
+            maze.tiles.at(house.x0 + 2, house.y0 - 1) = game::tile::Path;
+            maze.tiles.at(house.x0 + 4, house.y1() + 1) = game::tile::Path;
+        }
+
+        addLoops(maze, rng, clamp01(config.loopDensity));
+        if (config.removeDeadEnds) {
+            braidDeadEnds(maze, rng);
+        }
+
+        // Player start, then pellets near the corners, then dots everywhere else
+        std::vector<std::uint8_t> taken(maze.tiles.size(), 0);
+        const game::Tile playerStart = nearestCell(maze, width / 2, height * 3 / 4, taken);
+        taken[static_cast<std::size_t>(maze.tiles.index(playerStart.x, playerStart.y))] = 1;
+
+        std::vector<int> corridorCells;
+        for (int y = 1; y <= maze.maxY; y += 2) {
+            for (int x = 1; x <= maze.maxX; x += 2) {
+                const std::size_t i = static_cast<std::size_t>(maze.tiles.index(x, y));
+                if (!maze.reserved[i] && !taken[i] && maze.tiles.at(x, y) == game::tile::Path) {
+                    corridorCells.push_back(static_cast<int>(i));
+                }
+            }
+        }
+        const int pellets = std::min(config.powerPellets, static_cast<int>(corridorCells.size()));
+        const game::Tile corners[4] = { {1, 1}, {maze.maxX, 1}, {1, maze.maxY}, {maze.maxX, maze.maxY} };
+        for (int placed = 0; placed < pellets; ) {
+            game::Tile spot{-1, -1};
+            if (placed < 4) {
+                spot = nearestCell(maze, corners[placed].x, corners[placed].y, taken);
+            } else {
+                const int i = corridorCells[static_cast<std::size_t>(rng.below(static_cast<int>(corridorCells.size())))];
+                if (!taken[static_cast<std::size_t>(i)]) {
+                    spot = game::Tile{ i % width, i / width };
+                }
+            }
+            if (spot.x < 0) {
+                continue;
+            }
+            maze.tiles.at(spot.x, spot.y) = game::tile::Pellet;
+            taken[static_cast<std::size_t>(maze.tiles.index(spot.x, spot.y))] = 1;
+            ++placed;
+        }
+
+        const double dotDensity = clamp01(config.dotDensity);
+        std::uint8_t* cells = maze.tiles.data();
+        for (std::size_t i = 0; i < maze.tiles.size(); ++i) {
+            if (cells[i] == game::tile::Path && !maze.reserved[i] && !taken[i] && rng.chance(dotDensity)) {
+                cells[i] = game::tile::Dot;
+            }
+        }
+
+        // Hand over in the loader's form: lists in row-major order
+        out.name = config.name.empty()
+            ? "maze_" + std::to_string(width) + "x" + std::to_string(height) + "_" + std::to_string(config.seed)
+            : config.name;
+        out.playerStart = playerStart;
+        out.monsterStarts = std::move(monsterStarts);
+        std::sort(out.monsterStarts.begin(), out.monsterStarts.end(),
+                  [](const game::Tile& a, const game::Tile& b) { return a.y != b.y ? a.y < b.y : a.x < b.x; });
+        out.ghostHouse.clear();
+        out.ghostDoors.clear();
+        out.energyDots = 0;
+        out.powerPellets = 0;
+        for (int y = 0; y < height; ++y) {
+            const std::uint8_t* row = maze.tiles.row(y);
+            for (int x = 0; x < width; ++x) {
+                switch (row[x]) {
+                    case game::tile::Dot: ++out.energyDots; break;
+                    case game::tile::Pellet: ++out.powerPellets; break;
+                    case game::tile::House: out.ghostHouse.push_back(game::Tile{x, y}); break;
+                    case game::tile::Door: out.ghostDoors.push_back(game::Tile{x, y}); break;
+                    default: break;
+                }
+            }
+        }
+        out.tiles = std::move(maze.tiles);
+        return true;
+    }
+
+}
@@ -279,6 +279,22 @@ void UIRenderer::end2D() {
     glPopAttrib();
 }
 
+void UIRenderer::setMap(const MapGrid& map) {
+    boundMap = &map;
+}
+
+void UIRenderer::setItemLayers(const TileBitboard& dots, const TileBitboard& pellets) {
+    boundDots = &dots;
+    boundPellets = &pellets;
+}
+
+void UIRenderer::drawFrame(GameScreenState state,
+                           const PlayerRenderInfo& player,
+                           const std::vector<GhostRenderInfo>& ghosts) {
+    static const MapGrid emptyMap;
+    drawFrame(state, player, ghosts, boundMap ? *boundMap : emptyMap);
+}
+
 void UIRenderer::drawFrame(GameScreenState state,
                            const PlayerRenderInfo& player,
                            const std::vector<GhostRenderInfo>& ghosts,
@@ -287,9 +303,9 @@ void UIRenderer::drawFrame(GameScreenState state,
         return;
     }
 
-    if (!map.empty() && !map[0].empty()) {
-        mapGeom.cols = static_cast<int>(map[0].size());
-        mapGeom.rows = static_cast<int>(map.size());
+    if (!map.empty()) {
+        mapGeom.cols = map.width();
+        mapGeom.rows = map.height();
         mapGeom.width = static_cast<float>(mapGeom.cols * tileSize);
         mapGeom.height = static_cast<float>(mapGeom.rows * tileSize);
         mapGeom.originX = (static_cast<float>(viewportWidth) - mapGeom.width) * 0.5f;
@@ -332,7 +348,7 @@ void UIRenderer::drawFrame(GameScreenState state,
             break;
     }
 
-    if (debugOverlay && !map.empty() && !map[0].empty()) {
+    if (debugOverlay && !map.empty()) {
         drawDebugGrid(map);
     }
 
@@ -426,19 +442,20 @@ void UIRenderer::drawBackground() {
 }
 
 void UIRenderer::drawMapLayer(const MapGrid& map) {
-    if (map.empty() || map[0].empty()) {
+    if (map.empty()) {
         return;
     }
     for (int y = 0; y < mapGeom.rows; ++y) {
+        const std::uint8_t* row = map.row(y);
         for (int x = 0; x < mapGeom.cols; ++x) {
             const float px = mapGeom.originX + static_cast<float>(x * tileSize);
             const float py = mapGeom.originY + static_cast<float>((mapGeom.rows - 1 - y) * tileSize);
             const float size = static_cast<float>(tileSize);
-            const int cell = map[y][x];
-            if (cell == 1) {
+            const int cell = row[x];
+            if (cell == tile::Wall) {
                 auto texture = getOrLoad(assets.wallTile, assets.wallTile);
                 drawSprite(texture, px, py, size, size, false, 16, 60, 200);
-            } else if (cell == 2) {
+            } else if (cell == tile::House) {
                 // Monster room: draw perimeter as wall, interior as path so monsters have space.
                 bool boundary = false;
                 const int nx[4] = {1,-1,0,0};
@@ -446,11 +463,7 @@ void UIRenderer::drawMapLayer(const MapGrid& map) {
                 for (int k = 0; k < 4; ++k) {
                     int xx = x + nx[k];
                     int yy = y + ny[k];
-                    if (yy < 0 || yy >= mapGeom.rows || xx < 0 || xx >= mapGeom.cols) {
-                        boundary = true;
-                        break;
-                    }
-                    if (map[yy][xx] != 2) {
+                    if (map.get(xx, yy) != tile::House) {
                         boundary = true;
                         break;
                     }
@@ -471,43 +484,58 @@ void UIRenderer::drawMapLayer(const MapGrid& map) {
 }
 
 void UIRenderer::drawItemsLayer(const MapGrid& map) {
+    auto dotTexture = getOrLoad(assets.dotTexture, assets.dotTexture);
+    auto powerTexture = getOrLoad(assets.powerTexture, assets.powerTexture);
+    using namespace std::chrono;
+    const double now = duration<double>(steady_clock::now().time_since_epoch()).count();
+
+    // Bitboards only describe the map they were built from
+    const bool useLayers = boundDots && boundPellets &&
+                           boundDots->width() == map.width() && boundDots->height() == map.height() &&
+                           boundPellets->width() == map.width() && boundPellets->height() == map.height();
+    if (useLayers) {
+        boundDots->forEach([&](int x, int y) { drawDot(x, y, dotTexture); });
+        boundPellets->forEach([&](int x, int y) { drawPellet(x, y, powerTexture, now); });
+        return;
+    }
+
     for (int y = 0; y < mapGeom.rows; ++y) {
+        const std::uint8_t* row = map.row(y);
         for (int x = 0; x < mapGeom.cols; ++x) {
-            const int value = map[y][x];
-            if (value != 3 && value != 4) {
-                continue;
-            }
-
-            const float centerX = mapGeom.originX + static_cast<float>((x + 0.5f) * tileSize);
-            const float centerY = mapGeom.originY + static_cast<float>((mapGeom.rows - y - 0.5f) * tileSize);
-
-            if (value == 3) {
-                auto texture = getOrLoad(assets.dotTexture, assets.dotTexture);
-                const float size = static_cast<float>(tileSize) *0.35f;
-                drawSprite(texture, centerX, centerY, size, size, true, 255, 255, 255);
-            } else if (value == 4) {
-                auto texture = getOrLoad(assets.powerTexture, assets.powerTexture);
-                const float size = static_cast<float>(tileSize);
-                    uint32_t seed = static_cast<uint32_t>(x * 73856093u) ^ static_cast<uint32_t>(y * 19349663u);
-                    uint32_t rnd = seed * 1103515245u + 12345u;
-                    double r = static_cast<double>(rnd & 0x7fffffff) / static_cast<double>(0x7fffffff);
-
-                    double period = 0.4 + 0.6 * r;
-                    double phaseOffset = r * period;
-
-                    using namespace std::chrono;
-                    auto now = steady_clock::now();
-                    double t = duration<double>(now.time_since_epoch()).count();
-                    double phase = std::fmod(t + phaseOffset, period);
-                    bool visible = (phase < (period * 0.5));
-
-                    unsigned char powerAlpha = visible ? 255 : 60;
-                    drawSprite(texture, centerX, centerY, size, size, true, 200, 200, 255, powerAlpha);
+            if (row[x] == tile::Dot) {
+                drawDot(x, y, dotTexture);
+            } else if (row[x] == tile::Pellet) {
+                drawPellet(x, y, powerTexture, now);
             }
         }
     }
 }
 
+void UIRenderer::drawDot(int x, int y, const TextureHandle& texture) {
+    const float centerX = mapGeom.originX + static_cast<float>((x + 0.5f) * tileSize);
+    const float centerY = mapGeom.originY + static_cast<float>((mapGeom.rows - y - 0.5f) * tileSize);
+    const float size = static_cast<float>(tileSize) *0.35f;
+    drawSprite(texture, centerX, centerY, size, size, true, 255, 255, 255);
+}
+
+void UIRenderer::drawPellet(int x, int y, const TextureHandle& texture, double now) {
+    const float centerX = mapGeom.originX + static_cast<float>((x + 0.5f) * tileSize);
+    const float centerY = mapGeom.originY + static_cast<float>((mapGeom.rows - y - 0.5f) * tileSize);
+    const float size = static_cast<float>(tileSize);
+    uint32_t seed = static_cast<uint32_t>(x * 73856093u) ^ static_cast<uint32_t>(y * 19349663u);
+    uint32_t rnd = seed * 1103515245u + 12345u;
+    double r = static_cast<double>(rnd & 0x7fffffff) / static_cast<double>(0x7fffffff);
+
+    double period = 0.4 + 0.6 * r;
+    double phaseOffset = r * period;
+
+    double phase = std::fmod(now + phaseOffset, period);
+    bool visible = (phase < (period * 0.5));
+
+    unsigned char powerAlpha = visible ? 255 : 60;
+    drawSprite(texture, centerX, centerY, size, size, true, 200, 200, 255, powerAlpha);
+}
+
 void UIRenderer::drawPlayerSprite(const PlayerRenderInfo& player) {
     if (mapGeom.cols == 0 || mapGeom.rows == 0) {
         return;
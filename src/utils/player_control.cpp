@@ -7,25 +7,28 @@
 namespace game {
 
     // Constructor
-    PlayerController::PlayerController(const MapGrid& mapGrid, const Tile& startPos)
+    PlayerController::PlayerController(const MapGrid& mapGrid, const Tile& startPos, int totalCollectibles)
         : map(mapGrid), startPosition(startPos), position(startPos) {
         
         pixelX = static_cast<double>(startPos.x);
         pixelY = static_cast<double>(startPos.y);
         
-        // Count total dots and power pellets in the map for level completion
-        stats.totalDots = 0;
-        for (const auto& row : map) {
-            for (int cell : row) {
-                if (cell == 3 || cell == 4) {  // dot or power pellet
-                    stats.totalDots++;
-                }
-            }
-        }
-        
+        traversal.build(map);
+        countCollectibles(totalCollectibles);
+        reset(startPos);
+    }
+
+    // Start a new level: the shared map has already been reloaded in place
+    void PlayerController::startLevel(const Tile& startPos, int totalCollectibles) {
+        traversal.build(map);
+        countCollectibles(totalCollectibles);
         reset(startPos);
     }
 
+    void PlayerController::onTileChanged(int x, int y) {
+        traversal.update(map, x, y);
+    }
+
     // Reset player to initial state
     void PlayerController::reset(const Tile& startPos) {
         position = startPos;
@@ -94,7 +97,9 @@ namespace game {
         Direction desiredDir = inputToDirection(input);
         
         // Buffer the input direction
-        if (desiredDir != Direction::None) {
+        // (holding the arrow we already move along is not a turn: re-aligning
+        // every tick would pin the player to its tile)
+        if (desiredDir != Direction::None && desiredDir != currentDir) {
             bufferedDir = desiredDir;
         }
         
@@ -189,28 +194,10 @@ namespace game {
         return currentEvents;
     }
 
-    // Check if position is walkable
-    bool PlayerController::isWalkable(int x, int y) const {
-        if (y < 0 || y >= static_cast<int>(map.size()) ||
-            x < 0 || x >= static_cast<int>(map[0].size())) {
-            return false;
-        }
-        
-        int cell = map[y][x];
-        // Walkable: path(0), dot(3), power pellet(4)
-        // Not walkable: wall(1), monster room(2)
-        return (cell == 0 || cell == 3 || cell == 4);
-    }
-
     // Check if player can move in given direction
     bool PlayerController::canMove(Direction dir) const {
-        if (dir == Direction::None) return false;
-        
-        Tile delta = directionToDelta(dir);
-        int nextX = position.x + delta.x;
-        int nextY = position.y + delta.y;
-        
-        return isWalkable(nextX, nextY);
+        // One lookup in the player's exit mask (None has no exit bit)
+        return traversal.canStep(Traversal::Player, position.x, position.y, dir);
     }
 
     // Check if player can turn to given direction (at tile center)
@@ -250,18 +237,32 @@ bool PlayerController::isAtTileCenter() const {
         }
     }
 
+    // Count total dots and power pellets in the map for level completion
+    void PlayerController::countCollectibles(int totalCollectibles) {
+        if (totalCollectibles >= 0) {
+            stats.totalDots = totalCollectibles;
+            return;
+        }
+        stats.totalDots = 0;
+        const std::uint8_t* cells = map.data();
+        for (std::size_t i = 0; i < map.size(); ++i) {
+            if (cells[i] == tile::Dot || cells[i] == tile::Pellet) {
+                stats.totalDots++;
+            }
+        }
+    }
+
     // Check for item collection at current position
     void PlayerController::checkItemCollection() {
-        if (position.y < 0 || position.y >= static_cast<int>(map.size()) ||
-            position.x < 0 || position.x >= static_cast<int>(map[0].size())) {
+        if (!map.inBounds(position.x, position.y)) {
             return;
         }
         
-        int cell = map[position.y][position.x];
+        std::uint8_t cell = map.at(position.x, position.y);
         
-        if (cell == 3) {  // Dot
+        if (cell == tile::Dot) {
             collectDot();
-        } else if (cell == 4) {  // Power pellet
+        } else if (cell == tile::Pellet) {
             collectPowerPellet();
         }
     }
@@ -0,0 +1,214 @@
+// SimulationClock_test.cpp
+// The fixed-step clock under fixed frame times. Tick rates and frame times
+// are powers of two, so every expected count is exact: frames shorter than
+// a tick carry their time until a tick is due, alpha() is the carried
+// fraction, and any frame rate gives the same ticks per simulated second.
+// Real time over maxFrameTime() is dropped and counted, which caps the
+// ticks one frame can return at maxFrameTime() * speed() / tickSeconds();
+// setSpeed() scales simulated time (fast-forward and slow motion), and
+// setTickRate() keeps the carried fraction. Bad settings are ignored,
+// reset() forgets carried time and counters. A common 60 Hz / 1/60 s loop
+// stays within a tick of real time. Last, ghosts driven tick by tick from
+// the clock end up the same at 32 and 256 frames per second.
+//
+// Usage: SimulationClock_test
+
+#include "common/SimulationClock.hpp"
+#include "entities/MonsterSystem.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace game;
+
+namespace {
+
+    int failed = 0;
+
+    void expect(bool ok, const std::string& what) {
+        if (!ok && ++failed <= 10) {
+            std::cerr << "FAIL " << what << std::endl;
+        }
+    }
+
+    // Feed `frames` frames of `frame` seconds; true if every frame returns
+    // the next count of `pattern` (cycled) and alpha() the next of `alphas`
+    bool feeds(SimulationClock& clock, double frame, int frames, const std::vector<int>& pattern,
+               const std::vector<double>& alphas) {
+        bool ok = true;
+        for (int f = 0; f < frames; ++f) {
+            const int ticks = clock.advance(frame);
+            ok = ok && ticks == pattern[static_cast<std::size_t>(f) % pattern.size()] &&
+                 clock.alpha() == alphas[static_cast<std::size_t>(f) % alphas.size()];
+        }
+        return ok;
+    }
+
+    void checkStepping() {
+        SimulationClock clock(64.0);
+        expect(clock.tickRate() == 64.0 && clock.tickSeconds() == 1.0 / 64.0 && clock.ticks() == 0 &&
+               clock.alpha() == 0.0, "fresh clock");
+
+        // Half a tick per frame: a tick every other frame
+        expect(feeds(clock, 1.0 / 128.0, 64, { 0, 1 }, { 0.5, 0.0 }), "half-tick frames");
+        expect(clock.ticks() == 32, "half-tick frames: " + std::to_string(clock.ticks()) + " ticks");
+
+        // One and a half ticks per frame: 1, 2, 1, 2
+        clock.reset();
+        expect(feeds(clock, 3.0 / 128.0, 64, { 1, 2 }, { 0.5, 0.0 }), "tick-and-a-half frames");
+        expect(clock.ticks() == 96, "tick-and-a-half frames: " + std::to_string(clock.ticks()) + " ticks");
+
+        // A second of frames at any rate is 64 ticks, nothing carried
+        const int framesPerSecond[] = { 16, 32, 64, 128, 256, 1024 };
+        for (int fps : framesPerSecond) {
+            SimulationClock c(64.0);
+            int total = 0;
+            for (int f = 0; f < fps; ++f) total += c.advance(1.0 / fps);
+            expect(total == 64 && c.ticks() == 64 && c.alpha() == 0.0,
+                   std::to_string(fps) + " fps: " + std::to_string(total) + " ticks in one second");
+        }
+
+        // No time, or negative time, is no tick and changes nothing
+        clock.reset();
+        clock.advance(1.0 / 128.0);
+        expect(clock.advance(0.0) == 0 && clock.advance(-1.0) == 0 && clock.alpha() == 0.5 && clock.droppedSeconds() == 0.0,
+               "zero and negative frames");
+    }
+
+    void checkClamp() {
+        SimulationClock clock(64.0);
+        expect(clock.maxFrameTime() == 0.25, "default catch-up limit");
+
+        // A one-second stall runs a quarter second of ticks and drops the rest
+        expect(clock.advance(1.0) == 16 && clock.droppedSeconds() == 0.75 && clock.alpha() == 0.0, "stall clamped");
+        expect(clock.advance(0.25) == 16 && clock.droppedSeconds() == 0.75, "frame at the limit not clamped");
+        clock.setMaxFrameTime(0.5);
+        expect(clock.advance(2.0) == 32 && clock.droppedSeconds() == 2.25, "raised limit");
+        clock.setMaxFrameTime(0.0);
+        clock.setMaxFrameTime(-1.0);
+        expect(clock.maxFrameTime() == 0.5, "bad limits ignored");
+
+        // The cap on ticks per frame holds however long the frame is
+        const double stalls[] = { 0.6, 3.0, 60.0, 1.0e6 };
+        for (double stall : stalls) {
+            SimulationClock c(64.0);
+            c.setMaxFrameTime(0.125);
+            expect(c.advance(stall) == 8, "stall of " + std::to_string(stall) + " s");
+        }
+    }
+
+    void checkSpeed() {
+        SimulationClock clock(64.0);
+
+        // Fast-forward: 4x turns half-tick frames into two ticks each
+        clock.setSpeed(4.0);
+        expect(clock.speed() == 4.0 && feeds(clock, 1.0 / 128.0, 32, { 2 }, { 0.0 }), "4x fast-forward");
+
+        // The catch-up limit is real time: at 8x a stall runs 8 * 0.25 s
+        clock.reset();
+        clock.setSpeed(8.0);
+        expect(clock.advance(1.0) == 128 && clock.droppedSeconds() == 0.75, "8x stall");
+
+        // Slow motion: half speed, a tick every other full-tick frame
+        clock.reset();
+        clock.setSpeed(0.5);
+        expect(feeds(clock, 1.0 / 64.0, 32, { 0, 1 }, { 0.5, 0.0 }), "half speed");
+
+        clock.setSpeed(0.0);
+        clock.setSpeed(-2.0);
+        expect(clock.speed() == 0.5, "bad speeds ignored");
+
+        // reset() forgets time and counters, not settings
+        clock.advance(1.0 / 64.0);
+        clock.reset();
+        expect(clock.ticks() == 0 && clock.alpha() == 0.0 && clock.droppedSeconds() == 0.0 &&
+               clock.speed() == 0.5 && clock.tickRate() == 64.0, "reset()");
+    }
+
+    void checkTickRate() {
+        SimulationClock clock(64.0);
+        clock.advance(1.0 / 128.0);                     // half a tick carried
+        clock.setTickRate(32.0);
+        expect(clock.tickSeconds() == 1.0 / 32.0 && clock.alpha() == 0.5, "rate change keeps the carried fraction");
+        expect(clock.advance(1.0 / 64.0) == 1 && clock.alpha() == 0.0, "carried half tick at the new rate");
+        clock.setTickRate(0.0);
+        clock.setTickRate(-60.0);
+        expect(clock.tickRate() == 32.0, "bad tick rates ignored");
+
+        // The game's own setting: 60 Hz fed 1/60 s or 1/144 s frames
+        SimulationClock game;
+        int total = 0;
+        for (int f = 0; f < 6000; ++f) {
+            const int ticks = game.advance(1.0 / 60.0);
+            expect(ticks >= 0 && ticks <= 2, "60 Hz frame " + std::to_string(f) + ": " + std::to_string(ticks) + " ticks");
+            total += ticks;
+        }
+        expect(total >= 5999 && total <= 6000 && game.droppedSeconds() == 0.0,
+               "100 s at 60 fps: " + std::to_string(total) + " ticks");
+        SimulationClock fast;
+        total = 0;
+        for (int f = 0; f < 14400; ++f) total += fast.advance(1.0 / 144.0);
+        expect(total >= 5999 && total <= 6000, "100 s at 144 fps: " + std::to_string(total) + " ticks");
+    }
+
+    // Ghosts stepped once per clock tick with the tick length, the player
+    // moving every 16 ticks: the frame rate must not show
+    std::vector<GhostRenderInfo> runGhosts(int framesPerSecond, int seconds) {
+        const char* const maze[] = {
+            "###########",
+            "#.........#",
+            "#.###.###.#",
+            "#.#.....#.#",
+            "#.#.#D#.#.#",
+            "#...#G#...#",
+            "#####G#####",
+        };
+        MapGrid grid(11, 7);
+        for (int y = 0; y < 7; ++y) {
+            for (int x = 0; x < 11; ++x) {
+                const char c = maze[y][x];
+                grid.at(x, y) = c == '#' ? tile::Wall : c == 'G' ? tile::House : c == 'D' ? tile::Door : tile::Dot;
+            }
+        }
+        MonsterSystem monsters(grid, { Tile{ 5, 5 }, Tile{ 5, 6 } });
+        const Tile route[] = { Tile{ 1, 1 }, Tile{ 9, 1 }, Tile{ 9, 5 }, Tile{ 1, 5 } };
+
+        SimulationClock clock(64.0);
+        std::uint64_t tick = 0;
+        for (int f = 0; f < framesPerSecond * seconds; ++f) {
+            const int due = clock.advance(1.0 / framesPerSecond);
+            for (int k = 0; k < due; ++k, ++tick) {
+                MonsterPlayerState player;
+                player.gridX = route[(tick / 16) % 4].x;
+                player.gridY = route[(tick / 16) % 4].y;
+                monsters.setPlayerState(player);
+                monsters.update(clock.tickSeconds());
+                monsters.pollEvents();
+            }
+        }
+        return monsters.getRenderInfo();
+    }
+
+    void checkFrameRateIndependence() {
+        const std::vector<GhostRenderInfo> slow = runGhosts(32, 20);
+        const std::vector<GhostRenderInfo> quick = runGhosts(256, 20);
+        bool same = slow.size() == quick.size();
+        for (std::size_t i = 0; same && i < slow.size(); ++i) {
+            same = slow[i].gridX == quick[i].gridX && slow[i].gridY == quick[i].gridY &&
+                   slow[i].state == quick[i].state && slow[i].dir == quick[i].dir;
+        }
+        expect(same, "ghosts differ between 32 and 256 fps");
+    }
+
+}
+
+int main() {
+    checkStepping();
+    checkClamp();
+    checkSpeed();
+    checkTickRate();
+    checkFrameRateIndependence();
+
+    std::cout << "SimulationClock_test: " << (failed == 0 ? "passed" : std::to_string(failed) + " failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+}
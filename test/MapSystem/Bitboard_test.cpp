@@ -0,0 +1,131 @@
+// Bitboard_test.cpp
+// TileBitboard / TileLayers against a plain per-tile scan, on widths either
+// side of the 64-bit word boundary: count(), countInRect() and anyInRect()
+// for random (including clipped and empty) rectangles, forEach() visiting
+// exactly the set tiles in row-major order, and padding bits left clear.
+// MapSystem's item queries must agree with getTileAt() while dots are eaten.
+//
+// Usage: Bitboard_test [seed]
+
+#include "common/Bitboard.hpp"
+#include "map/MapSystem.h"
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace game;
+
+namespace {
+
+    int failed = 0;
+
+    void expect(bool ok, const std::string& what) {
+        if (!ok && ++failed <= 10) {
+            std::cerr << "FAIL " << what << std::endl;
+        }
+    }
+
+    int slowCount(const MapGrid& grid, std::uint8_t code, int x0, int y0, int x1, int y1) {
+        int total = 0;
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                total += grid.inBounds(x, y) && grid.at(x, y) == code;
+            }
+        }
+        return total;
+    }
+
+    void checkBoard(std::mt19937_64& rng, int width, int height) {
+        MapGrid grid(width, height);
+        for (std::size_t i = 0; i < grid.size(); ++i) {
+            grid.data()[i] = static_cast<std::uint8_t>(rng() % 6);
+        }
+        TileLayers layers;
+        layers.build(grid);
+        const std::string size = std::to_string(width) + "x" + std::to_string(height);
+
+        const struct {
+            const TileBitboard* board;
+            std::uint8_t code;
+        } layerCodes[] = {
+            { &layers.walls, tile::Wall }, { &layers.dots, tile::Dot }, { &layers.pellets, tile::Pellet },
+            { &layers.house, tile::House }, { &layers.doors, tile::Door },
+        };
+        for (const auto& lc : layerCodes) {
+            const TileBitboard& board = *lc.board;
+            const std::string what = size + " code " + std::to_string(lc.code);
+            expect(board.count() == slowCount(grid, lc.code, 0, 0, width - 1, height - 1), what + ": count");
+            expect(board.any() == (board.count() > 0), what + ": any");
+
+            // Bits past the last column of each row stay clear
+            const int spare = board.wordsPerRow() * 64 - width;
+            bool clean = true;
+            for (int y = 0; y < height && spare > 0; ++y) {
+                clean &= (board.rowWords(y)[board.wordsPerRow() - 1] & bits::range(64 - spare, 64)) == 0;
+            }
+            expect(clean, what + ": padding bits set");
+
+            // forEach: every set tile once, row-major
+            std::vector<Tile> visited;
+            board.forEach([&](int x, int y) { visited.push_back(Tile{ x, y }); });
+            std::vector<Tile> expected;
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    if (grid.at(x, y) == lc.code) expected.push_back(Tile{ x, y });
+                }
+            }
+            expect(visited == expected, what + ": forEach order");
+
+            // Rectangles, some hanging off the board and some inverted
+            for (int r = 0; r < 200; ++r) {
+                const int x0 = static_cast<int>(rng() % static_cast<std::uint64_t>(width + 8)) - 4;
+                const int y0 = static_cast<int>(rng() % static_cast<std::uint64_t>(height + 8)) - 4;
+                const int x1 = x0 + static_cast<int>(rng() % 140) - 6;
+                const int y1 = y0 + static_cast<int>(rng() % 12) - 2;
+                const int want = slowCount(grid, lc.code, x0, y0, x1, y1);
+                const std::string rect = what + " rect [" + std::to_string(x0) + "," + std::to_string(x1) + "]x[" +
+                                         std::to_string(y0) + "," + std::to_string(y1) + "]";
+                expect(board.countInRect(x0, y0, x1, y1) == want, rect + ": countInRect");
+                expect(board.anyInRect(x0, y0, x1, y1) == (want > 0), rect + ": anyInRect");
+            }
+        }
+    }
+
+    // MapSystem's item queries follow pickups on built-in level 2
+    void checkMapSystem(std::mt19937_64& rng) {
+        MapSystem maps;
+        maps.setVerbose(false);
+        maps.loadLevel(2);
+        const MapGrid& grid = maps.getMapGrid();
+        for (int step = 0; step < 300; ++step) {
+            maps.removeCollectible(static_cast<int>(rng() % 19), static_cast<int>(rng() % 21));
+            const int x0 = static_cast<int>(rng() % 19);
+            const int y0 = static_cast<int>(rng() % 21);
+            const int x1 = x0 + static_cast<int>(rng() % 8);
+            const int y1 = y0 + static_cast<int>(rng() % 8);
+            const int items = slowCount(grid, tile::Dot, x0, y0, x1, y1) + slowCount(grid, tile::Pellet, x0, y0, x1, y1);
+            expect(maps.countItemsInRect(x0, y0, x1, y1) == items, "MapSystem countItemsInRect, step " + std::to_string(step));
+            expect(maps.anyItemsInRect(x0, y0, x1, y1) == (items > 0), "MapSystem anyItemsInRect, step " + std::to_string(step));
+        }
+        expect(maps.getRemainingDots() == slowCount(grid, tile::Dot, 0, 0, 18, 20) &&
+               maps.getRemainingPellets() == slowCount(grid, tile::Pellet, 0, 0, 18, 20), "MapSystem remaining counts");
+        expect(maps.isLevelComplete() == (maps.countItemsInRect(0, 0, 18, 20) == 0), "MapSystem level complete");
+    }
+
+}
+
+int main(int argc, char** argv) {
+    const std::uint64_t seed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1;
+    std::mt19937_64 rng(seed);
+
+    const int widths[] = { 1, 19, 63, 64, 65, 128, 130, 200 };
+    for (int width : widths) {
+        checkBoard(rng, width, 1 + static_cast<int>(rng() % 24));
+    }
+    checkMapSystem(rng);
+
+    std::cout << "Bitboard_test: " << (failed == 0 ? "passed" : std::to_string(failed) + " failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+// ChunkedStorage_test.cpp
+// MapSystem in Chunked storage on a 1024x1024 level whose maze fills one
+// corner: every tile reads back, the solid wall shares one flyweight chunk so
+// memory is a small fraction of the dense grid, pickups and edits copy only
+// the chunks they touch, and resetMapState() puts back tiles and counts while
+// keeping the working copies for reuse. setStorage() only takes effect on the
+// next load, and GameSession refuses a Chunked level.
+//
+// Usage: ChunkedStorage_test
+
+#include "map/MapSystem.h"
+#include "map/MazeGenerator.h"
+#include "core/GameSession.hpp"
+#include <iostream>
+#include <string>
+
+using namespace game;
+
+namespace {
+
+    int failed = 0;
+
+    void expect(bool ok, const std::string& what) {
+        if (!ok) {
+            ++failed;
+            std::cerr << "FAIL " << what << std::endl;
+        }
+    }
+
+    // Every tile of `maps` equals `grid`; returns the number that differ
+    int differences(const MapSystem& maps, const MapGrid& grid) {
+        int wrong = 0;
+        for (int y = 0; y < grid.height(); ++y) {
+            for (int x = 0; x < grid.width(); ++x) {
+                wrong += maps.getTileAt(x, y) != grid.at(x, y);
+            }
+        }
+        return wrong;
+    }
+
+    // A generated 95x63 maze in the top-left corner of a 1024x1024 wall
+    LevelData cornerLevel() {
+        MazeConfig config;
+        config.width = 95;
+        config.height = 63;
+        config.seed = 7;
+        LevelData maze;
+        MazeGenerator::generate(config, maze);
+
+        LevelData level = maze;
+        level.name = "corner";
+        level.tiles.assign(1024, 1024, tile::Wall);
+        for (int y = 0; y < maze.tiles.height(); ++y) {
+            for (int x = 0; x < maze.tiles.width(); ++x) {
+                level.tiles.at(x, y) = maze.tiles.at(x, y);
+            }
+        }
+        return level;
+    }
+
+}
+
+int main() {
+    const LevelData level = cornerLevel();
+    const int chunkBytes = ChunkedTileStore::CHUNK_CELLS;
+
+    MapSystem maps;
+    maps.setVerbose(false);
+    maps.setStorage(MapStorage::Chunked);
+    expect(maps.getStorage() == MapStorage::Dense, "setStorage() changed the storage before a load");
+    expect(maps.loadLevel(level), "load the corner level");
+    expect(maps.getStorage() == MapStorage::Chunked && !maps.hasMapGrid(), "loaded in Chunked storage");
+
+    // Tiles and counts
+    expect(differences(maps, level.tiles) == 0, "tiles read back");
+    expect(maps.getTileAt(-1, 5) == WALL && maps.getTileAt(1024, 0) == WALL && !maps.isWalkable(2000, 2000),
+           "outside the map reads as wall");
+    expect(maps.getRemainingDots() == level.energyDots && maps.getRemainingPellets() == level.powerPellets,
+           "item counts");
+
+    // Sharing: the maze covers 3x2 chunks; everything else is the wall flyweight
+    const ChunkedTileStore& chunks = maps.getChunkedTiles();
+    expect(chunks.chunksX() == 32 && chunks.chunksY() == 32, "32x32 chunks");
+    expect(chunks.uniqueChunkCount() <= 2 + 6, std::to_string(chunks.uniqueChunkCount()) + " distinct chunks");
+    expect(chunks.memoryBytes() < level.tiles.size() / 8,
+           std::to_string(chunks.memoryBytes()) + " bytes for a " + std::to_string(level.tiles.size()) + " byte level");
+    expect(chunks.dirtyChunkCount() == 0 && chunks.workingChunkCount() == 0, "no copies after loading");
+
+    // Pickups in two chunks, an edit in the wall far away: three copies
+    Tile dots[2] = { Tile{ -1, -1 }, Tile{ -1, -1 } };
+    for (int y = 0; y < 32; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            Tile& dot = dots[x >> 5];
+            if (dot.x < 0 && level.tiles.at(x, y) == tile::Dot) dot = Tile{ x, y };
+        }
+    }
+    expect(dots[0].x >= 0 && dots[1].x >= 0, "dots in the first two chunks");
+    const std::size_t sharedBytes = chunks.memoryBytes();
+    maps.removeCollectible(dots[0].x, dots[0].y);
+    maps.removeCollectible(dots[1].x, dots[1].y);
+    maps.setTile(600, 600, EMPTY);
+    expect(maps.getTileAt(dots[0].x, dots[0].y) == EMPTY && maps.isCollected(dots[0].x, dots[0].y) &&
+           maps.getTileAt(600, 600) == EMPTY, "pickups and edit applied");
+    expect(maps.getTileAt(601, 600) == WALL && maps.getTileAt(600, 700) == WALL,
+           "the shared wall chunk is untouched");
+    expect(chunks.dirtyChunkCount() == 3 && chunks.isChunkDirty(600, 600) && !chunks.isChunkDirty(700, 600),
+           "copy-on-write: " + std::to_string(chunks.dirtyChunkCount()) + " dirty chunks, not three");
+    // (the working store grows like a vector: room for four after three copies)
+    expect(chunks.memoryBytes() <= sharedBytes + 4 * chunkBytes + 256, "only the touched chunks were copied");
+    expect(maps.getRemainingDots() == level.energyDots - 2, "dot count after pickups");
+    expect(maps.countItemsInRect(dots[0].x, dots[0].y, dots[0].x, dots[0].y) == 0, "rectangle query sees the pickup");
+
+    // Reset: tiles and counts back, copies kept for the next run
+    int journalled = 0;
+    const int listener = maps.getJournal().subscribe([&](const TileChange&) { ++journalled; });
+    maps.resetMapState();
+    maps.getJournal().unsubscribe(listener);
+    expect(differences(maps, level.tiles) == 0, "tiles after reset");
+    expect(maps.getRemainingDots() == level.energyDots && !maps.isCollected(dots[0].x, dots[0].y), "counts after reset");
+    expect(chunks.dirtyChunkCount() == 0 && journalled == 3, "reset visits the three changed tiles");
+    expect(chunks.workingChunkCount() == 3, std::to_string(chunks.workingChunkCount()) + " working copies kept, not three");
+    const std::size_t afterReset = chunks.memoryBytes();
+    for (int round = 0; round < 5; ++round) {
+        maps.removeCollectible(dots[0].x, dots[0].y);
+        maps.setTile(600, 600, EMPTY);
+        maps.resetMapState();
+    }
+    expect(chunks.memoryBytes() == afterReset, "repeated runs reuse the copies");
+
+    // setStorage() waits for the next load in both directions
+    maps.setStorage(MapStorage::Dense);
+    expect(maps.getStorage() == MapStorage::Chunked && differences(maps, level.tiles) == 0,
+           "switching to Dense kept the Chunked level readable");
+    maps.loadLevel(1);
+    expect(maps.getStorage() == MapStorage::Dense && maps.hasMapGrid() && maps.getWidth() == 19, "next load is Dense");
+    expect(maps.getChunkedTiles().empty(), "the chunks were dropped");
+    const MapGrid level1 = maps.getMapGrid();
+    maps.setStorage(MapStorage::Chunked);
+    expect(maps.hasMapGrid() && differences(maps, level1) == 0 && maps.isWalkable(1, 1),
+           "switching to Chunked kept the Dense level readable");
+    maps.removeCollectible(1, 1);
+    expect(maps.getTileAt(1, 1) == EMPTY && maps.isCollected(1, 1), "Dense pickups after setStorage(Chunked)");
+
+    // GameSession needs a dense grid
+    maps.loadLevel(1);
+    expect(maps.getStorage() == MapStorage::Chunked, "level 1 in Chunked storage");
+    {
+        GameSession session(maps, 1);
+        session.setVerbose(false);
+        expect(session.status() == GameSession::Status::GameOver, "GameSession played a Chunked level");
+        expect(session.step(1.0 / 60.0, PlayerInput{}) == GameSession::Status::GameOver, "step() on a refused session");
+    }
+
+    std::cout << "ChunkedStorage_test: " << (failed == 0 ? "passed" : std::to_string(failed) + " failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+// LevelLoader_test.cpp
+// The .lvl text format: a hand-written level parses to the expected tiles,
+// spawns and counts (CRLF rows and comments included); each malformed input
+// is rejected with an error; toLevelText() / saveLevelFile() round-trip
+// through the mmap loader; a directory loads in file-name order and skips
+// broken files; MapSystem installs a level that is not 19x21.
+//
+// Usage: LevelLoader_test
+
+#include "map/LevelLoader.h"
+#include "map/MapSystem.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace game;
+namespace fs = std::filesystem;
+
+namespace {
+
+    int failed = 0;
+
+    void expect(bool ok, const std::string& what) {
+        if (!ok) {
+            ++failed;
+            std::cerr << "FAIL " << what << std::endl;
+        }
+    }
+
+    bool parse(const std::string& text, LevelData& out, std::string* error = nullptr) {
+        return LevelLoader::parseLevelText(text.data(), text.size(), out, error);
+    }
+
+    const char* const SMALL =
+        "; a comment before the header\n"
+        "\n"
+        "7 5\r\n"
+        "#######\r\n"
+        "#.O D #\r\n"
+        "#MGGG.#\r\n"
+        "#P   M#\r\n"
+        "#######\r\n"
+        "\n";
+
+    void parsesSmallLevel() {
+        LevelData level;
+        std::string error;
+        expect(parse(SMALL, level, &error), "small level: " + error);
+        expect(level.tiles.width() == 7 && level.tiles.height() == 5, "small level: size");
+        expect(level.tiles.at(1, 1) == tile::Dot && level.tiles.at(2, 1) == tile::Pellet &&
+               level.tiles.at(3, 1) == tile::Path && level.tiles.at(4, 1) == tile::Door &&
+               level.tiles.at(2, 2) == tile::House && level.tiles.at(0, 0) == tile::Wall,
+               "small level: tile codes");
+        expect(level.playerStart == Tile{ 1, 3 } && level.tiles.at(1, 3) == tile::Path,
+               "small level: player start on a path tile");
+        expect(level.monsterStarts.size() == 2 && level.monsterStarts[0] == Tile{ 1, 2 } &&
+               level.monsterStarts[1] == Tile{ 5, 3 }, "small level: monster starts in row-major order");
+        expect(level.ghostHouse.size() == 3 && level.ghostDoors.size() == 1 &&
+               level.ghostDoors[0] == Tile{ 4, 1 }, "small level: house and door lists");
+        expect(level.energyDots == 2 && level.powerPellets == 1, "small level: item counts");
+    }
+
+    void rejectsMalformedLevels() {
+        const struct {
+            const char* text;
+            const char* problem;
+        } bad[] = {
+            { "",                               "empty file" },
+            { "3\n###\n",                       "one number in the header" },
+            { "0 1\n\n",                        "zero width" },
+            { "99999 1\n#\n",                   "side over MAX_LEVEL_SIDE" },
+            { "3 2\n#P#\n##\n",                 "short row" },
+            { "3 2\n#P#\n####\n",               "long row" },
+            { "3 2\n#P#\n",                     "missing row" },
+            { "3 2\n#P#\n#X#\n",                "unknown character" },
+            { "3 2\n#P#\n#P#\n",                "two player starts" },
+            { "3 2\n#.#\n###\n",                "no player start" },
+            { "3 2\n#P#\n###\nextra\n",         "data after the last row" },
+        };
+        for (const auto& b : bad) {
+            LevelData level;
+            std::string error;
+            expect(!parse(b.text, level, &error), std::string(b.problem) + ": accepted");
+            expect(!error.empty(), std::string(b.problem) + ": no error message");
+        }
+    }
+
+    void roundTripsThroughFiles(const fs::path& dir) {
+        LevelData level;
+        parse(SMALL, level);
+        level.name = "small";
+
+        // Text round trip
+        LevelData again;
+        expect(parse(LevelLoader::toLevelText(level), again), "toLevelText: reparse");
+        expect(std::memcmp(again.tiles.data(), level.tiles.data(), level.tiles.size()) == 0 &&
+               again.playerStart == level.playerStart && again.monsterStarts.size() == level.monsterStarts.size(),
+               "toLevelText: same level");
+
+        // Files, loaded through the memory mapping; b_broken sorts between the two good ones
+        expect(LevelLoader::saveLevelFile((dir / "c_second.lvl").string(), level), "save c_second.lvl");
+        expect(LevelLoader::saveLevelFile((dir / "a_first.lvl").string(), level), "save a_first.lvl");
+        std::ofstream((dir / "b_broken.lvl").string()) << "3 1\n#?#\n";
+        std::ofstream((dir / "notes.txt").string()) << "not a level\n";
+
+        LevelData loaded;
+        std::string error;
+        expect(LevelLoader::loadLevelFile((dir / "a_first.lvl").string(), loaded, &error), "loadLevelFile: " + error);
+        expect(loaded.name == "a_first" && loaded.energyDots == 2, "loadLevelFile: name from the file stem");
+        expect(!LevelLoader::loadLevelFile((dir / "missing.lvl").string(), loaded, &error), "loadLevelFile: missing file");
+
+        std::vector<std::string> errors;
+        std::vector<LevelData> levels = LevelLoader::loadLevelDirectory(dir.string(), &errors);
+        expect(levels.size() == 2 && levels[0].name == "a_first" && levels[1].name == "c_second",
+               "loadLevelDirectory: two good levels in name order");
+        expect(errors.size() == 1 && errors[0].find("b_broken") != std::string::npos,
+               "loadLevelDirectory: the broken file is reported");
+    }
+
+    void mapSystemTakesAnySize(const fs::path& dir) {
+        // 40x3: wider than the built-in maps and far shorter
+        std::string text = "40 3\n" + std::string(40, '#') + "\n#P" + std::string(37, '.') + "#\n" +
+                           std::string(40, '#') + "\n";
+        std::ofstream((dir / "wide.lvl").string()) << text;
+
+        MapSystem maps;
+        maps.setVerbose(false);
+        expect(maps.loadLevelFile((dir / "wide.lvl").string()), "MapSystem: load 40x3");
+        expect(maps.getWidth() == 40 && maps.getHeight() == 3, "MapSystem: 40x3 size");
+        expect(maps.getRemainingDots() == 37 && maps.getTileAt(39, 1) == WALL && maps.getTileAt(38, 1) == ENERGY,
+               "MapSystem: 40x3 tiles and dots");
+        expect(maps.loadLevelDirectory(dir.string()) == 3 && maps.getLevelCount() == 3,
+               "MapSystem: directory levels replace the built-in ones");
+    }
+
+}
+
+int main() {
+    const fs::path dir = fs::temp_directory_path() / "LevelLoader_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    parsesSmallLevel();
+    rejectsMalformedLevels();
+    roundTripsThroughFiles(dir);
+    mapSystemTakesAnySize(dir);
+
+    fs::remove_all(dir);
+    std::cout << "LevelLoader_test: " << (failed == 0 ? "passed" : std::to_string(failed) + " failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+// LevelPack_test.cpp
+// Binary level packs: levels written by LevelPack::write() come back with the
+// same tiles, spawns and baked counts, through the view, extract() and
+// MapSystem. Damaged packs are refused: bad header fields, every truncation,
+// out-of-range records and counts at open(); unknown tile codes and counts
+// that disagree with the tiles at verify(), before MapSystem installs them.
+//
+// Usage: LevelPack_test
+
+#include "map/LevelPack.h"
+#include "map/MapSystem.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace game;
+using namespace levelpack;
+namespace fs = std::filesystem;
+
+namespace {
+
+    int failed = 0;
+
+    void expect(bool ok, const std::string& what) {
+        if (!ok) {
+            ++failed;
+            std::cerr << "FAIL " << what << std::endl;
+        }
+    }
+
+    LevelData parse(const char* name, const std::string& text) {
+        LevelData level;
+        std::string error;
+        expect(LevelLoader::parseLevelText(text.data(), text.size(), level, &error), std::string(name) + ": " + error);
+        level.name = name;
+        return level;
+    }
+
+    std::vector<char> readBytes(const fs::path& path) {
+        std::ifstream in(path.string(), std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void writeBytes(const fs::path& path, const std::vector<char>& bytes, std::size_t count) {
+        std::ofstream out(path.string(), std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(count));
+    }
+
+    bool sameTiles(const std::vector<Tile>& tiles, const PackedTile* packed, int count) {
+        if (static_cast<int>(tiles.size()) != count) return false;
+        for (int i = 0; i < count; ++i) {
+            if (tiles[i].x != packed[i].x || tiles[i].y != packed[i].y) return false;
+        }
+        return true;
+    }
+
+    // Byte offset of level `index`'s LevelRecord inside the pack
+    std::size_t recordOffset(const std::vector<char>& bytes, int index) {
+        PackIndexEntry entry;
+        std::memcpy(&entry, bytes.data() + sizeof(PackHeader) + index * sizeof(PackIndexEntry), sizeof(entry));
+        return static_cast<std::size_t>(entry.offset);
+    }
+
+    LevelRecord readRecord(const std::vector<char>& bytes, int index) {
+        LevelRecord record;
+        std::memcpy(&record, bytes.data() + recordOffset(bytes, index), sizeof(record));
+        return record;
+    }
+
+    void writeRecord(std::vector<char>& bytes, int index, const LevelRecord& record) {
+        std::memcpy(bytes.data() + recordOffset(bytes, index), &record, sizeof(record));
+    }
+
+}
+
+int main() {
+    const fs::path dir = fs::temp_directory_path() / "LevelPack_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const fs::path good = dir / "good.pack";
+    const fs::path bad = dir / "bad.pack";
+
+    std::vector<LevelData> levels;
+    levels.push_back(parse("corridor", "9 3\n#########\n#P..O..M#\n#########\n"));
+    levels.push_back(parse("house",
+        "7 6\n"
+        "#######\n"
+        "#O...O#\n"
+        "##DD###\n"
+        "#GMMG.#\n"
+        "#.P...#\n"
+        "#######\n"));
+    levels[1].energyDots = 99;  // write() bakes what the tiles hold, not this
+    std::string error;
+    expect(LevelPack::write(good.string(), levels, &error), "write: " + error);
+
+    // Round trip through the mapped views
+    {
+        LevelPack pack;
+        expect(pack.open(good.string(), &error), "open: " + error);
+        expect(pack.levelCount() == 2, "open: two levels");
+        for (int i = 0; i < pack.levelCount(); ++i) {
+            const LevelData& src = levels[i];
+            const LevelPackView& view = pack.level(i);
+            const std::string name = src.name;
+            expect(view.name == name && view.width == src.tiles.width() && view.height == src.tiles.height(),
+                   name + ": name and size");
+            expect(std::memcmp(view.tiles, src.tiles.data(), src.tiles.size()) == 0, name + ": tiles");
+            expect(view.playerStart == src.playerStart &&
+                   sameTiles(src.monsterStarts, view.monsterStarts, view.monsterCount) &&
+                   sameTiles(src.ghostHouse, view.ghostHouse, view.houseCount) &&
+                   sameTiles(src.ghostDoors, view.ghostDoors, view.doorCount),
+                   name + ": spawn, house and door lists");
+            expect(pack.verify(i, &error) && pack.verify(i, &error), name + ": verify: " + error);
+
+            LevelData copy;
+            expect(pack.extract(i, copy, &error), name + ": extract: " + error);
+            expect(copy.tiles.size() == src.tiles.size() &&
+                   std::memcmp(copy.tiles.data(), src.tiles.data(), src.tiles.size()) == 0 &&
+                   copy.monsterStarts.size() == src.monsterStarts.size(), name + ": extract copies the level");
+        }
+        expect(pack.level(0).energyDots == 4 && pack.level(0).powerPellets == 1, "corridor: baked counts");
+        expect(pack.level(1).energyDots == 8 && pack.level(1).powerPellets == 2,
+               "house: baked counts come from the tiles");
+    }
+
+    // MapSystem installs pack levels with the baked counts
+    {
+        MapSystem maps;
+        maps.setVerbose(false);
+        expect(maps.loadLevelPack(good.string()) == 2 && maps.loadLevel(2), "MapSystem: load pack level 2");
+        expect(maps.getWidth() == 7 && maps.getRemainingDots() == 8 && maps.getRemainingPellets() == 2 &&
+               maps.getTileAt(2, 2) == GHOST_DOOR && maps.getGhostHouseTiles().size() == 2 &&
+               maps.getMonsterStarts().size() == 2, "MapSystem: pack level 2 contents");
+    }
+
+    const std::vector<char> bytes = readBytes(good);
+
+    // Every truncation is refused at open()
+    int accepted = 0;
+    for (std::size_t size = 0; size < bytes.size(); ++size) {
+        writeBytes(bad, bytes, size);
+        LevelPack pack;
+        accepted += pack.open(bad.string());
+    }
+    expect(accepted == 0, std::to_string(accepted) + " truncated packs opened");
+
+    // Header and record damage, refused at open()
+    struct Damage {
+        const char* what;
+        void (*apply)(std::vector<char>&);
+    };
+    const Damage structural[] = {
+        { "bad magic", [](std::vector<char>& b) { b[0] = 'X'; } },
+        { "other version", [](std::vector<char>& b) {
+            const std::uint32_t v = VERSION + 1; std::memcpy(&b[4], &v, sizeof(v)); } },
+        { "other byte order", [](std::vector<char>& b) {
+            const std::uint32_t tag = 0x04030201u; std::memcpy(&b[8], &tag, sizeof(tag)); } },
+        { "level count past the index", [](std::vector<char>& b) {
+            const std::uint32_t n = 1000000; std::memcpy(&b[12], &n, sizeof(n)); } },
+        { "tile section past the record", [](std::vector<char>& b) {
+            LevelRecord r = readRecord(b, 1); r.tilesOffset += 4096; writeRecord(b, 1, r); } },
+        { "oversized level", [](std::vector<char>& b) {
+            LevelRecord r = readRecord(b, 0); r.width = 100000; writeRecord(b, 0, r); } },
+        { "player outside the map", [](std::vector<char>& b) {
+            LevelRecord r = readRecord(b, 0); r.playerY = 3; writeRecord(b, 0, r); } },
+        { "monster outside the map", [](std::vector<char>& b) {
+            LevelRecord r = readRecord(b, 1);
+            PackedTile far{ -1, 2 };
+            std::memcpy(&b[recordOffset(b, 1) + r.monstersOffset], &far, sizeof(far)); } },
+        { "counts larger than the level", [](std::vector<char>& b) {
+            LevelRecord r = readRecord(b, 0); r.energyDots = 20; r.powerPellets = 20; writeRecord(b, 0, r); } },
+    };
+    for (const Damage& d : structural) {
+        std::vector<char> copy = bytes;
+        d.apply(copy);
+        writeBytes(bad, copy, copy.size());
+        LevelPack pack;
+        error.clear();
+        expect(!pack.open(bad.string(), &error), std::string(d.what) + ": opened");
+        expect(!error.empty() && !pack.isOpen(), std::string(d.what) + ": no error, or left open");
+    }
+
+    // Tile damage: open() does not read tiles, verify() and MapSystem refuse
+    const Damage tileLevel[] = {
+        { "unknown tile code", [](std::vector<char>& b) {
+            LevelRecord r = readRecord(b, 1); b[recordOffset(b, 1) + r.tilesOffset + 8] = 9; } },
+        { "counts that disagree with the tiles", [](std::vector<char>& b) {
+            LevelRecord r = readRecord(b, 1); r.energyDots = 7; writeRecord(b, 1, r); } },
+    };
+    for (const Damage& d : tileLevel) {
+        std::vector<char> copy = bytes;
+        d.apply(copy);
+        writeBytes(bad, copy, copy.size());
+        LevelPack pack;
+        expect(pack.open(bad.string(), &error), std::string(d.what) + ": open: " + error);
+        expect(pack.verify(0), std::string(d.what) + ": level 0 is intact");
+        error.clear();
+        expect(!pack.verify(1, &error) && !error.empty(), std::string(d.what) + ": verified");
+        LevelData copied;
+        expect(!pack.extract(1, copied), std::string(d.what) + ": extracted");
+
+        MapSystem maps;
+        maps.setVerbose(false);
+        expect(maps.loadLevelPack(bad.string()) == 2, std::string(d.what) + ": MapSystem open");
+        expect(maps.loadLevel(1) && !maps.loadLevel(2) && maps.getWidth() == 9,
+               std::string(d.what) + ": MapSystem loaded the damaged level");
+    }
+
+    fs::remove_all(dir);
+    std::cout << "LevelPack_test: " << (failed == 0 ? "passed" : std::to_string(failed) + " failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+}
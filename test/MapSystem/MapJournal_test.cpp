@@ -0,0 +1,232 @@
+// MapJournal_test.cpp
+// The live-map journal as consumers use it. A subscriber that mirrors
+// MonsterSystem's reaction (exit masks updated around the tile, all-pairs
+// table rebuilt when stale, D* Lite told through tileChanged()) follows
+// setTile() edits, pickups, resets and level loads, and its masks, table and
+// planner answer like a fresh build / search after each one. Draining with
+// a cursor yields the same changes in order; stale cursors are refused.
+// Through GameSession, opening a wall lets the player walk into it.
+//
+// Usage: MapJournal_test
+
+#include "map/MapSystem.h"
+#include "core/GameSession.hpp"
+#include "entities/DStarLite.hpp"
+#include "entities/DistanceTable.hpp"
+#include "entities/PathEngine.hpp"
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace game;
+
+namespace {
+
+    int failed = 0;
+
+    void expect(bool ok, const std::string& what) {
+        if (!ok) {
+            ++failed;
+            std::cerr << "FAIL " << what << std::endl;
+        }
+    }
+
+    // Two corridors joined at the right end; (1, 2) and (5, 2) are the walls
+    // the test opens. (1, 1) to (1, 3) is 18 steps the long way round.
+    const char* const corridors =
+        "11 5\n"
+        "###########\n"
+        "#P.......O#\n"
+        "#########.#\n"
+        "#........M#\n"
+        "###########\n";
+
+    // Caches kept current from the journal alone
+    struct Subscriber {
+        const MapSystem& maps;
+        TraversalMasks masks;
+        DistanceTable table;
+        bool tableStale = true;
+        SearchWorkspace work;
+        DStarLite planner;
+        int layoutChanges = 0;
+        int levelChanges = 0;
+
+        explicit Subscriber(const MapSystem& m) : maps(m) {
+            masks.build(maps.getMapGrid());
+            planner.reset(masks, Traversal::Ghost);
+        }
+
+        void onChange(const TileChange& change) {
+            if (change.wholeMap()) {
+                ++levelChanges;
+                masks.build(maps.getMapGrid());
+                planner.reset(masks, Traversal::Ghost);
+                tableStale = true;
+                return;
+            }
+            if (TraversalMasks::sameRules(change.before, change.after)) return;
+            ++layoutChanges;
+            masks.update(maps.getMapGrid(), change.x, change.y);
+            tableStale = true;
+            planner.tileChanged(change.x, change.y);
+        }
+
+        const DistanceTable& currentTable() {
+            if (tableStale) table.build(masks, Traversal::Ghost, work);
+            tableStale = false;
+            return table;
+        }
+    };
+
+    bool sameMasks(const TraversalMasks& a, const MapGrid& grid) {
+        TraversalMasks fresh;
+        fresh.build(grid);
+        const Traversal all[] = { Traversal::Player, Traversal::GhostOutside, Traversal::GhostInside, Traversal::Ghost };
+        for (Traversal who : all) {
+            if (a.width() != fresh.width() || a.height() != fresh.height() ||
+                std::memcmp(a.data(who), fresh.data(who), grid.size()) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The subscriber's masks, table and planner against a fresh BFS over the live grid
+    void checkAgainstFresh(Subscriber& sub, const std::string& when) {
+        const MapGrid& grid = sub.maps.getMapGrid();
+        expect(sameMasks(sub.masks, grid), when + ": masks differ from a fresh build");
+
+        TraversalMasks fresh;
+        fresh.build(grid);
+        std::unique_ptr<PathEngine> bfs = makePathEngine(PathAlgorithm::BFS);
+        const DistanceTable& table = sub.currentTable();
+        std::vector<Tile> path;
+        int tableWrong = 0;
+        int plannerWrong = 0;
+        for (int y = 0; y < grid.height(); ++y) {
+            for (int x = 0; x < grid.width(); ++x) {
+                const Tile to{ x, y };
+                if (fresh.exits(Traversal::Ghost, x, y) == 0) continue;
+                const Tile from{ 1, 1 };
+                const int want = bfs->search(fresh, Traversal::Ghost, from, to, 1 << 20, nullptr);
+                tableWrong += table.distance(from, to) != want;
+                plannerWrong += sub.planner.plan(from, to, path) != want;
+            }
+        }
+        expect(tableWrong == 0, when + ": " + std::to_string(tableWrong) + " table distances from (1, 1) wrong");
+        expect(plannerWrong == 0, when + ": " + std::to_string(plannerWrong) + " D* Lite plans from (1, 1) wrong");
+    }
+
+    int planLength(Subscriber& sub, const Tile& from, const Tile& to) {
+        std::vector<Tile> path;
+        return sub.planner.plan(from, to, path);
+    }
+
+}
+
+int main() {
+    LevelData level;
+    std::string error;
+    expect(LevelLoader::parseLevelText(corridors, std::strlen(corridors), level, &error), "parse: " + error);
+    level.name = "corridors";
+
+    MapSystem maps;
+    maps.setVerbose(false);
+    maps.loadLevel(level);
+
+    Subscriber sub(maps);
+    const int listener = maps.getJournal().subscribe([&](const TileChange& change) { sub.onChange(change); });
+    MapJournal::Cursor cursor = maps.getJournal().cursor();
+    const Tile top{ 1, 1 };
+    const Tile bottom{ 1, 3 };
+
+    // Planner warm on the long way round, then the wall below (1, 1) opens
+    expect(planLength(sub, top, bottom) == 18 && sub.currentTable().distance(top, bottom) == 18, "long way round");
+    checkAgainstFresh(sub, "as loaded");
+    expect(maps.setTile(1, 2, EMPTY), "open (1, 2)");
+    expect(sub.layoutChanges == 1, "one layout change");
+    expect(planLength(sub, top, bottom) == 2, "D* Lite repaired through (1, 2)");
+    expect(sub.currentTable().distance(top, bottom) == 2 && sub.currentTable().firstStep(top, bottom) == Direction::Down,
+           "table rebuilt through (1, 2)");
+    checkAgainstFresh(sub, "after opening (1, 2)");
+
+    // Pickups are journalled but change no rule
+    maps.removeCollectible(2, 1);
+    maps.removeCollectible(9, 1);
+    expect(sub.layoutChanges == 1 && !sub.tableStale, "pickups left the caches alone");
+
+    // A second opening, then the first closes again
+    maps.setTile(5, 2, EMPTY);
+    maps.setTile(1, 2, WALL);
+    expect(sub.layoutChanges == 3, "three layout changes");
+    expect(planLength(sub, top, bottom) == 10, "D* Lite repaired through (5, 2) only");
+    checkAgainstFresh(sub, "after moving the opening");
+
+    // Drained changes: the same edits, oldest first, with before and after
+    std::vector<TileChange> changes;
+    expect(maps.getJournal().drain(cursor, changes), "drain");
+    const TileChange expected[] = {
+        { 1, 2, WALL, EMPTY }, { 2, 1, ENERGY, EMPTY }, { 9, 1, POWER_PELLET, EMPTY },
+        { 5, 2, WALL, EMPTY }, { 1, 2, EMPTY, WALL },
+    };
+    bool sameChanges = changes.size() == 5;
+    for (std::size_t i = 0; sameChanges && i < changes.size(); ++i) {
+        sameChanges = changes[i].x == expected[i].x && changes[i].y == expected[i].y &&
+                      changes[i].before == expected[i].before && changes[i].after == expected[i].after;
+    }
+    expect(sameChanges, "drained " + std::to_string(changes.size()) + " changes, not the five made");
+    expect(maps.getJournal().drain(cursor, changes) && changes.empty(), "a drained cursor is empty");
+
+    // Reset: each changed tile is journalled back, the caches follow
+    maps.resetMapState();
+    // ((1, 2) is a wall again, so three tiles differ from the level)
+    expect(maps.getJournal().drain(cursor, changes) && changes.size() == 3, "reset journals the three changed tiles");
+    expect(sub.layoutChanges == 4, "reset closed (5, 2)");
+    expect(planLength(sub, top, bottom) == 18, "D* Lite back to the long way round");
+    checkAgainstFresh(sub, "after reset");
+
+    // A new level: one whole-map notice, old cursors refused
+    maps.loadLevel(level);
+    expect(sub.levelChanges == 1, "whole-map notice on load");
+    expect(!maps.getJournal().drain(cursor, changes) && changes.empty(), "a cursor from the last level drained");
+    expect(maps.getJournal().drain(cursor, changes), "the cursor moved to the new level");
+    checkAgainstFresh(sub, "after reload");
+    maps.getJournal().unsubscribe(listener);
+    maps.setTile(1, 2, EMPTY);
+    expect(sub.layoutChanges == 4, "an unsubscribed listener was called");
+    maps.resetMapState();
+
+    // Retention: a cursor that fell further behind than `retain` is refused
+    {
+        MapJournal journal(4);
+        MapJournal::Cursor old = journal.cursor();
+        for (int i = 0; i < 10; ++i) journal.record(i, 0, tile::Dot, tile::Path);
+        MapJournal::Cursor recent = journal.cursor();
+        journal.record(20, 0, tile::Dot, tile::Path);
+        journal.record(21, 0, tile::Dot, tile::Dot);  // no change, not recorded
+        expect(!journal.drain(old, changes), "drained past the retained changes");
+        expect(journal.drain(recent, changes) && changes.size() == 1 && changes[0].x == 20, "recent cursor");
+    }
+
+    // GameSession forwards layout edits to the player: (1, 2) opens under them
+    maps.loadLevel(level);
+    {
+        GameSession session(maps, 1);
+        session.setVerbose(false);
+        PlayerInput down;
+        down.downPressed = true;
+        for (int frame = 0; frame < 60; ++frame) session.step(1.0 / 60.0, down);
+        expect(session.player().getPosition() == top, "the player walked into a wall");
+        maps.setTile(1, 2, EMPTY);
+        for (int frame = 0; frame < 60 && session.player().getPosition() == top; ++frame) {
+            session.step(1.0 / 60.0, down);
+        }
+        expect(session.player().getPosition() == Tile{ 1, 2 }, "the player did not take the opened tile");
+    }
+
+    std::cout << "MapJournal_test: " << (failed == 0 ? "passed" : std::to_string(failed) + " failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+// MapReset_test.cpp
+// MapSystem::resetMapState() after pickups and setTile() edits on built-in
+// level 1: the live grid, bitboards, item counts, pickup flags and ghost
+// house list all return to the level as loaded. Re-collecting the same tile
+// over and over, and the reset itself, allocate nothing (global operator new
+// is counted).
+//
+// Usage: MapReset_test
+
+#include "map/MapSystem.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+
+using namespace game;
+
+namespace {
+    std::size_t allocations = 0;
+}
+
+void* operator new(std::size_t bytes) {
+    ++allocations;
+    if (void* p = std::malloc(bytes ? bytes : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+    int failed = 0;
+
+    void expect(bool ok, const std::string& what) {
+        if (!ok) {
+            ++failed;
+            std::cerr << "FAIL " << what << std::endl;
+        }
+    }
+
+    bool sameGrid(const MapGrid& a, const MapGrid& b) {
+        return a.width() == b.width() && a.height() == b.height() &&
+               std::memcmp(a.data(), b.data(), a.size()) == 0;
+    }
+
+    // The bitboards agree with the live grid tile for tile
+    bool layersMatchGrid(const MapSystem& maps) {
+        const MapGrid& grid = maps.getMapGrid();
+        const TileLayers& layers = maps.getTileLayers();
+        for (int y = 0; y < grid.height(); ++y) {
+            for (int x = 0; x < grid.width(); ++x) {
+                const std::uint8_t t = grid.at(x, y);
+                if (layers.walls.test(x, y) != (t == tile::Wall) || layers.dots.test(x, y) != (t == tile::Dot) ||
+                    layers.pellets.test(x, y) != (t == tile::Pellet) || layers.house.test(x, y) != (t == tile::House) ||
+                    layers.doors.test(x, y) != (t == tile::Door)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+}
+
+int main() {
+    MapSystem maps;
+    maps.setVerbose(false);
+    if (!maps.loadLevel(1)) {
+        std::cerr << "FAIL cannot load level 1" << std::endl;
+        return 1;
+    }
+    const MapGrid loaded = maps.getMapGrid();
+    const int dots = maps.getRemainingDots();
+    const int pellets = maps.getRemainingPellets();
+    const std::size_t houseTiles = maps.getGhostHouseTiles().size();
+
+    // Level 1: dots along row 1, a pellet at (1, 3), walls at (2, 2) and
+    // (3, 2), ghost house row 10 from x = 7
+    for (int x = 1; x <= 5; ++x) maps.removeCollectible(x, 1);
+    maps.removeCollectible(1, 3);
+    maps.removeCollectible(1, 3);                 // already eaten: no change
+    expect(maps.setTile(2, 2, EMPTY), "open a wall");
+    expect(maps.setTile(3, 2, POWER_PELLET), "add a pellet");
+    expect(maps.setTile(7, 10, EMPTY), "open a ghost house tile");
+    expect(maps.getRemainingDots() == dots - 5 && maps.getRemainingPellets() == pellets,
+           "counts after pickups and edits");
+    expect(maps.isCollected(1, 1) && maps.isCollected(1, 3) && !maps.isCollected(6, 1), "pickup flags");
+    expect(maps.getGhostHouseTiles().size() == houseTiles - 1, "house list follows setTile()");
+
+    // Collect, put back, collect again: one tile, listed once
+    std::size_t before = allocations;
+    for (int round = 0; round < 1000; ++round) {
+        maps.removeCollectible(6, 1);
+        maps.setTile(6, 1, ENERGY);
+    }
+    maps.removeCollectible(6, 1);
+    std::size_t allocated = allocations - before;
+    expect(allocated == 0, std::to_string(allocated) + " allocations re-collecting one tile");
+    expect(maps.getRemainingDots() == dots - 6 && layersMatchGrid(maps), "counts and bitboards after re-collecting");
+
+    before = allocations;
+    maps.resetMapState();
+    allocated = allocations - before;
+    expect(allocated == 0, std::to_string(allocated) + " allocations in resetMapState()");
+
+    expect(sameGrid(maps.getMapGrid(), loaded), "grid restored");
+    expect(sameGrid(maps.getMapGrid(), maps.getPristineMap()), "grid equals the pristine copy");
+    expect(layersMatchGrid(maps), "bitboards restored");
+    expect(maps.getRemainingDots() == dots && maps.getRemainingPellets() == pellets &&
+           maps.getTileLayers().dots.count() == dots, "counts restored");
+    expect(!maps.isCollected(1, 1) && !maps.isCollected(1, 3) && !maps.isCollected(6, 1), "pickup flags cleared");
+    expect(maps.getGhostHouseTiles().size() == houseTiles, "house list restored");
+    expect(maps.countItemsInRect(1, 1, 17, 1) == 17, "row 1 full of dots again");
+
+    // A second round of the same edits resets just as cleanly
+    for (int x = 1; x <= 17; ++x) maps.removeCollectible(x, 1);
+    maps.setTile(2, 2, EMPTY);
+    maps.resetMapState();
+    maps.resetMapState();
+    expect(sameGrid(maps.getMapGrid(), loaded) && maps.getRemainingDots() == dots, "second reset");
+
+    std::cout << "MapReset_test: " << (failed == 0 ? "passed" : std::to_string(failed) + " failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+}
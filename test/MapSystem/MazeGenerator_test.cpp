@@ -0,0 +1,196 @@
+// MazeGenerator_test.cpp
+// MazeGenerator::generate(): the same config gives the same level byte for
+// byte (and a pinned tile hash, so a change of output is noticed), another
+// seed gives another maze, and every generated level is playable: all
+// player tiles (outside the houses) form one region under the Player exit
+// masks, and a ghost leaving any monster start or house tile can reach all
+// of them under the Ghost masks. Counts, spawns and the .lvl text form are
+// checked too.
+//
+// Usage: MazeGenerator_test
+
+#include "map/MazeGenerator.h"
+#include "common/Traversal.hpp"
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace game;
+
+namespace {
+
+    int failed = 0;
+
+    void expect(bool ok, const std::string& what) {
+        if (!ok) {
+            ++failed;
+            std::cerr << "FAIL " << what << std::endl;
+        }
+    }
+
+    bool playerWalks(std::uint8_t t) {
+        return t == tile::Path || t == tile::Dot || t == tile::Pellet;
+    }
+
+    // Tiles reachable from `from` under `who`'s exit masks
+    std::vector<bool> reach(const TraversalMasks& masks, Traversal who, const Tile& from) {
+        const int w = masks.width();
+        std::vector<bool> seen(static_cast<std::size_t>(w) * masks.height(), false);
+        std::vector<Tile> frontier{ from };
+        seen[from.y * w + from.x] = true;
+        const int dx[4] = { 1, 0, -1, 0 };
+        const int dy[4] = { 0, -1, 0, 1 };
+        while (!frontier.empty()) {
+            const Tile t = frontier.back();
+            frontier.pop_back();
+            for (int d = 0; d < 4; ++d) {
+                const Tile n{ t.x + dx[d], t.y + dy[d] };
+                if (masks.canStep(who, t.x, t.y, static_cast<Direction>(d)) && !seen[n.y * w + n.x]) {
+                    seen[n.y * w + n.x] = true;
+                    frontier.push_back(n);
+                }
+            }
+        }
+        return seen;
+    }
+
+    // FNV-1a over the tile bytes
+    std::uint64_t tileHash(const MapGrid& grid) {
+        std::uint64_t h = 1469598103934665603ull;
+        for (std::size_t i = 0; i < grid.size(); ++i) {
+            h = (h ^ grid.data()[i]) * 1099511628211ull;
+        }
+        return h;
+    }
+
+    bool sameLevel(const LevelData& a, const LevelData& b) {
+        return a.tiles.width() == b.tiles.width() && a.tiles.height() == b.tiles.height() &&
+               std::memcmp(a.tiles.data(), b.tiles.data(), a.tiles.size()) == 0 &&
+               a.playerStart == b.playerStart && a.monsterStarts == b.monsterStarts &&
+               a.ghostHouse == b.ghostHouse && a.ghostDoors == b.ghostDoors;
+    }
+
+    void checkPlayable(const MazeConfig& config, const LevelData& level) {
+        const std::string name = level.name;
+        const MapGrid& grid = level.tiles;
+        TraversalMasks masks;
+        masks.build(grid);
+
+        int dots = 0;
+        int pellets = 0;
+        for (std::size_t i = 0; i < grid.size(); ++i) {
+            dots += grid.data()[i] == tile::Dot;
+            pellets += grid.data()[i] == tile::Pellet;
+        }
+        expect(dots == level.energyDots && pellets == level.powerPellets, name + ": counts match the tiles");
+        expect(pellets == config.powerPellets, name + ": pellet count");
+        expect(static_cast<int>(level.monsterStarts.size()) == config.ghostHouses * config.monstersPerHouse,
+               name + ": monster starts");
+        expect(static_cast<int>(level.ghostDoors.size()) >= config.ghostHouses, name + ": doors");
+        expect(playerWalks(grid.get(level.playerStart.x, level.playerStart.y, tile::Wall)), name + ": player start");
+
+        // Player tiles: path, dot and pellet tiles outside the houses (monster
+        // starts are path tiles inside them)
+        std::vector<bool> playerTile(grid.size(), false);
+        for (std::size_t i = 0; i < grid.size(); ++i) {
+            playerTile[i] = playerWalks(grid.data()[i]);
+        }
+        for (const Tile& m : level.monsterStarts) {
+            playerTile[grid.index(m.x, m.y)] = false;
+        }
+
+        // Player: one region holding every player tile
+        const std::vector<bool> player = reach(masks, Traversal::Player, level.playerStart);
+        int unreachable = 0;
+        for (std::size_t i = 0; i < grid.size(); ++i) {
+            unreachable += playerTile[i] && !player[i];
+        }
+        expect(unreachable == 0, name + ": " + std::to_string(unreachable) + " player tiles cut off from the start");
+
+        // Ghosts: out of the house from every start and house tile, to every player tile
+        std::vector<Tile> ghostStarts = level.monsterStarts;
+        ghostStarts.insert(ghostStarts.end(), level.ghostHouse.begin(), level.ghostHouse.end());
+        int stuck = 0;
+        for (const Tile& start : ghostStarts) {
+            const std::vector<bool> ghost = reach(masks, Traversal::Ghost, start);
+            for (std::size_t i = 0; i < grid.size(); ++i) {
+                if (playerTile[i] && !ghost[i]) {
+                    ++stuck;
+                    break;
+                }
+            }
+        }
+        expect(stuck == 0, name + ": " + std::to_string(stuck) + " ghost tiles cannot reach the whole maze");
+
+        // The level is valid .lvl text
+        LevelData reparsed;
+        std::string error;
+        const std::string text = LevelLoader::toLevelText(level);
+        expect(LevelLoader::parseLevelText(text.data(), text.size(), reparsed, &error) && sameLevel(reparsed, level),
+               name + ": .lvl round trip " + error);
+    }
+
+}
+
+int main() {
+    // Same config twice, then another seed
+    MazeConfig base;
+    base.width = 64;
+    base.height = 64;
+    base.seed = 42;
+    LevelData first, second, other;
+    std::string error;
+    expect(MazeGenerator::generate(base, first, &error) && MazeGenerator::generate(base, second, &error),
+           "generate 64x64: " + error);
+    expect(sameLevel(first, second), "same seed, different level");
+    expect(tileHash(first.tiles) == 9617143672384622028ull,
+           "64x64 seed 42 tile hash changed: " + std::to_string(tileHash(first.tiles)));
+    MazeConfig reseeded = base;
+    reseeded.seed = 43;
+    MazeGenerator::generate(reseeded, other);
+    expect(!sameLevel(first, other), "seeds 42 and 43 gave the same level");
+
+    // Playable across sizes and settings
+    struct Variant {
+        int width, height;
+        std::uint64_t seed;
+        double loops;
+        bool braid;
+        int houses;
+        int pellets;
+    };
+    const Variant variants[] = {
+        {  15,  15,  1, 0.15, true,  1, 4 },   // smallest allowed
+        {  19,  21,  2, 0.00, false, 1, 4 },   // no loops, dead ends kept: a tree
+        {  64,  48,  3, 0.30, true,  2, 8 },   // even sides: double outer wall
+        { 101,  77,  4, 0.05, false, 3, 6 },
+        { 257, 129,  5, 0.15, true,  6, 12 },
+    };
+    for (const Variant& v : variants) {
+        MazeConfig config;
+        config.width = v.width;
+        config.height = v.height;
+        config.seed = v.seed;
+        config.loopDensity = v.loops;
+        config.removeDeadEnds = v.braid;
+        config.ghostHouses = v.houses;
+        config.powerPellets = v.pellets;
+        LevelData level;
+        if (!MazeGenerator::generate(config, level, &error)) {
+            expect(false, "generate " + std::to_string(v.width) + "x" + std::to_string(v.height) + ": " + error);
+            continue;
+        }
+        checkPlayable(config, level);
+    }
+    checkPlayable(base, first);
+
+    // Sizes out of range are refused
+    MazeConfig tiny = base;
+    tiny.width = 14;
+    LevelData none;
+    expect(!MazeGenerator::generate(tiny, none, &error) && !error.empty(), "14 wide accepted");
+
+    std::cout << "MazeGenerator_test: " << (failed == 0 ? "passed" : std::to_string(failed) + " failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -12,19 +12,19 @@ using namespace game;
 
 // Simple map
 static MapGrid makeTestMap(int W, int H) {
-    MapGrid g(H, std::vector<int>(W, 1)); // wall
+    MapGrid g(W, H, tile::Wall); // wall
     // inside
     for (int y = 1; y < H - 1; ++y)
         for (int x = 1; x < W - 1; ++x)
-            g[y][x] = 0;
+            g.at(x, y) = tile::Path;
 
     // addition wall
-    for (int y = 2; y < H - 2; ++y) g[y][W/3] = 1;
-    for (int y = 2; y < H - 2; ++y) g[y][2*W/3] = 1;
+    for (int y = 2; y < H - 2; ++y) g.at(W/3, y) = tile::Wall;
+    for (int y = 2; y < H - 2; ++y) g.at(2*W/3, y) = tile::Wall;
 
     // intersection
-    for (int x = 2; x < W - 2; ++x) g[H/2][x] = 1;
-    g[H/2][W/6] = 0; g[H/2][W/2] = 0; g[H/2][5*W/6] = 0;
+    for (int x = 2; x < W - 2; ++x) g.at(x, H/2) = tile::Wall;
+    g.at(W/6, H/2) = tile::Path; g.at(W/2, H/2) = tile::Path; g.at(5*W/6, H/2) = tile::Path;
 
     return g;
 }
@@ -62,7 +62,7 @@ static const char* toStateName(GhostState s) {
 
 // Walking close to the wall
 static bool walkable(const MapGrid& m, int x, int y){
-    return y>=0 && y<(int)m.size() && x>=0 && x<(int)m[0].size() && m[y][x]==0;
+    return m.inBounds(x,y) && m.at(x,y)==tile::Path;
 }
 static int manhattan(const Tile& a, const Tile& b){
     return std::abs(a.x-b.x)+std::abs(a.y-b.y);
@@ -118,8 +118,8 @@ static Tile snapToNearestWalkable(const MapGrid& m, Tile start, int R=8){
 }
 
 static Tile pickSafeStart(const MapGrid& m, const std::vector<Tile>& spawns, int minDist){
-    const int H=(int)m.size();
-    const int W=H? (int)m[0].size():0;
+    const int H=m.height();
+    const int W=m.width();
     Tile best{W/2,H/2};
     int bestScore=-1;
     for(int y=1;y<H-1;++y){
@@ -168,18 +168,18 @@ static inline const char* C_PURPLE = "\x1b[35m";
 
 // draw
 static void renderASCII(const MapGrid& map,
-                        const PlayerState& ps,
+                        const MonsterPlayerState& ps,
                         const std::vector<GhostRenderInfo>& infos)
 {
-    const int H = (int)map.size();
-    const int W = H ? (int)map[0].size() : 0;
+    const int H = map.height();
+    const int W = map.width();
     if (H == 0 || W == 0) return;
 
     // map
     std::vector<std::string> canvas(H, std::string(W, ' '));
     for (int y = 0; y < H; ++y) {
         for (int x = 0; x < W; ++x) {
-            canvas[y][x] = (map[y][x] == 1 ? '#' : ' ');
+            canvas[y][x] = (map.at(x, y) == tile::Wall ? '#' : ' ');
         }
     }
 
@@ -262,14 +262,14 @@ int main() {
 
     // No passing through walls
     auto isWalkable = [&](int x, int y) {
-        if (y < 0 || y >= (int)map.size() || x < 0 || x >= (int)map[0].size()) return false;
-        return map[y][x] == 0; 
+        if (!map.inBounds(x, y)) return false;
+        return map.at(x, y) == tile::Path; 
     };
 
     const int totalFrames = 240;
     for (int f = 0; f < totalFrames; ++f) {
         advancePlayerWalker(map, playerPos, playerDir);
-        PlayerState ps;
+        MonsterPlayerState ps;
         ps.gridX = playerPos.x;
         ps.gridY = playerPos.y;
         ps.dir   = playerDir;
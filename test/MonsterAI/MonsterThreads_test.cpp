@@ -0,0 +1,170 @@
+// MonsterThreads_test.cpp
+// MonsterSystem with 1 worker thread and with 4, fed the same player moves
+// and wall edits: every frame's getRenderInfo() and events must match.
+//
+// Usage: MonsterThreads_test [seed]
+
+#include "entities/MonsterSystem.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace game;
+
+namespace {
+
+    struct Case {
+        const char* name;
+        int size;           // square map side
+        int ghosts;
+        int ticks;
+        void (*configure)(MonsterSystem&);
+    };
+
+    void defaults(MonsterSystem&) {}
+    void noDistanceTable(MonsterSystem& ms) { ms.setDistanceTableBudget(0); }
+    void jumpPoint(MonsterSystem& ms) {
+        ms.setDistanceTableBudget(0);
+        ms.setPathAlgorithm(PathAlgorithm::JumpPoint);
+    }
+    void incremental(MonsterSystem& ms) { ms.setIncrementalChase(true); }
+
+    // The planning budget is left at 0: budgeted runs depend on timing
+    const Case cases[] = {
+        { "default",           41,  40, 1200, defaults },
+        { "no distance table", 81, 200,  900, noDistanceTable },
+        { "jump point",        81, 200,  900, jumpPoint },
+        { "incremental chase", 61, 120,  900, incremental },
+    };
+
+    // Walls all round and at random inside, a ghost house with a door in
+    // the middle
+    MapGrid makeMap(std::mt19937_64& rng, int size) {
+        MapGrid grid(size, size, tile::Wall);
+        for (int y = 1; y < size - 1; ++y) {
+            for (int x = 1; x < size - 1; ++x) {
+                grid.at(x, y) = rng() % 100 < 28 ? tile::Wall : tile::Dot;
+            }
+        }
+        const int c = size / 2;
+        for (int y = c - 3; y <= c + 3; ++y) {
+            for (int x = c - 4; x <= c + 4; ++x) {
+                const bool edge = y == c - 3 || y == c + 3 || x == c - 4 || x == c + 4;
+                grid.at(x, y) = edge ? tile::Wall : tile::House;
+            }
+        }
+        grid.at(c, c - 3) = tile::Door;
+        grid.at(c, c - 4) = tile::Path;
+        return grid;
+    }
+
+    bool playerCanStand(const MapGrid& grid, int x, int y) {
+        const std::uint8_t t = grid.get(x, y);
+        return t == tile::Path || t == tile::Dot || t == tile::Pellet;
+    }
+
+    bool sameFrame(const std::vector<GhostRenderInfo>& a, const std::vector<GhostRenderInfo>& b) {
+        if (a.size() != b.size()) return false;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            if (a[i].gridX != b[i].gridX || a[i].gridY != b[i].gridY || a[i].dir != b[i].dir ||
+                a[i].state != b[i].state || a[i].animFrame != b[i].animFrame || a[i].type != b[i].type) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Returns the number of mismatching frames
+    int runCase(const Case& c, std::uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        MapGrid grid = makeMap(rng, c.size);
+
+        // Half the ghosts in the house, the rest on random open tiles
+        std::vector<Tile> spawns;
+        const int mid = c.size / 2;
+        while (static_cast<int>(spawns.size()) < c.ghosts) {
+            if (spawns.size() % 2 == 0) {
+                spawns.push_back(Tile{ mid - 3 + static_cast<int>(rng() % 7), mid - 2 + static_cast<int>(rng() % 5) });
+                continue;
+            }
+            const int x = static_cast<int>(rng() % static_cast<std::uint64_t>(c.size));
+            const int y = static_cast<int>(rng() % static_cast<std::uint64_t>(c.size));
+            if (playerCanStand(grid, x, y)) spawns.push_back(Tile{ x, y });
+        }
+
+        MonsterSystem single(grid, spawns);
+        MonsterSystem pooled(grid, spawns);
+        c.configure(single);
+        c.configure(pooled);
+        single.setWorkerThreads(1);
+        pooled.setWorkerThreads(4);
+
+        MonsterPlayerState player;
+        player.gridX = mid;
+        player.gridY = mid - 4;
+        player.dir = Direction::Up;
+        const double dt = 1.0 / 60.0;
+        const int dx[4] = { 1, 0, -1, 0 };   // Right, Up, Left, Down
+        const int dy[4] = { 0, -1, 0, 1 };
+        int mismatches = 0;
+
+        for (int tick = 0; tick < c.ticks; ++tick) {
+            // Player: a step every 8 ticks, powered now and then
+            if (tick % 8 == 0) {
+                const int d = static_cast<int>(rng() % 4);
+                if (playerCanStand(grid, player.gridX + dx[d], player.gridY + dy[d])) {
+                    player.gridX += dx[d];
+                    player.gridY += dy[d];
+                    player.dir = static_cast<Direction>(d);
+                }
+            }
+            player.isPowered = (tick / 240) % 3 == 2;
+            single.setPlayerState(player);
+            pooled.setPlayerState(player);
+
+            // A wall edit every 50 ticks, never on the player
+            if (tick % 50 == 25) {
+                const int x = 1 + static_cast<int>(rng() % static_cast<std::uint64_t>(c.size - 2));
+                const int y = 1 + static_cast<int>(rng() % static_cast<std::uint64_t>(c.size - 2));
+                const std::uint8_t t = grid.at(x, y);
+                if ((t == tile::Wall || t == tile::Dot) && !(x == player.gridX && y == player.gridY)) {
+                    grid.set(x, y, t == tile::Wall ? tile::Path : tile::Wall);
+                    single.onTileChanged(x, y);
+                    pooled.onTileChanged(x, y);
+                }
+            }
+
+            single.update(dt);
+            pooled.update(dt);
+
+            const bool hitSingle = single.pollEvents().playerHit;
+            const bool hitPooled = pooled.pollEvents().playerHit;
+            if (!sameFrame(single.getRenderInfo(), pooled.getRenderInfo()) || hitSingle != hitPooled) {
+                if (++mismatches <= 5) {
+                    std::cerr << "FAIL " << c.name << " seed " << seed << ": frame " << tick
+                              << " differs between 1 and 4 threads" << std::endl;
+                }
+            }
+        }
+        return mismatches;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    const std::uint64_t seed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1;
+
+    int frames = 0;
+    int failed = 0;
+    for (const Case& c : cases) {
+        for (std::uint64_t s = seed; s < seed + 2; ++s) {
+            failed += runCase(c, s);
+            frames += c.ticks;
+        }
+    }
+    std::cout << "MonsterThreads_test: " << frames << " frames, " << failed << " differ" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,188 @@
+// Occupancy_test.cpp
+// OccupancyIndex, the ghosts-by-tile lists MonsterSystem keeps: after every
+// place() / remove() of a seeded random sequence (several actors crowding
+// one tile, moves within and off the grid) countOn(), forEachOn() and
+// forEachAround() list exactly the actors a plain per-actor position table
+// has there, each once; an actor may move itself from inside forEachOn().
+// Then MonsterSystem's one collision site: three ghosts standing on the
+// player's tile are three hits in one update, none in the update they sit
+// out, three again after, three ghosts eaten when the player is powered,
+// and nothing once the player stands elsewhere.
+//
+// Usage: Occupancy_test [seed]
+
+#include "entities/MonsterSystem.hpp"
+#include "entities/OccupancyIndex.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace game;
+
+namespace {
+
+    int failed = 0;
+
+    void expect(bool ok, const std::string& what) {
+        if (!ok && ++failed <= 10) {
+            std::cerr << "FAIL " << what << std::endl;
+        }
+    }
+
+    const Tile Off{ -1, -1 };
+
+    std::vector<int> actorsOn(const OccupancyIndex& index, const Tile& t) {
+        std::vector<int> out;
+        index.forEachOn(t, [&](int a) { out.push_back(a); });
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    // Every tile against the model: who is there, how many, and who is
+    // around it (tagged with the tile they stand on)
+    void checkAgainst(const OccupancyIndex& index, const std::vector<Tile>& model, int w, int h,
+                      const std::string& name) {
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                const Tile t{ x, y };
+                std::vector<int> want;
+                std::vector<int> wantAround;
+                for (int a = 0; a < static_cast<int>(model.size()); ++a) {
+                    if (model[a] == t) want.push_back(a);
+                    if (model[a] == t || (std::abs(model[a].x - x) + std::abs(model[a].y - y) == 1 && model[a].x >= 0)) {
+                        wantAround.push_back(a);
+                    }
+                }
+                const std::vector<int> got = actorsOn(index, t);
+                std::vector<int> around;
+                bool tagged = true;
+                index.forEachAround(t, [&](int a, const Tile& on) {
+                    around.push_back(a);
+                    tagged = tagged && model[a] == on;
+                });
+                std::sort(around.begin(), around.end());
+                const std::string where = name + " (" + std::to_string(x) + "," + std::to_string(y) + ")";
+                expect(got == want && index.countOn(t) == want.size() && index.occupied(t) == !want.empty(),
+                       where + ": " + std::to_string(got.size()) + " actors listed, " + std::to_string(want.size()) + " there");
+                expect(around == wantAround && tagged, where + ": forEachAround()");
+            }
+        }
+    }
+
+    void checkIndex(std::mt19937_64& rng) {
+        const int w = 6;
+        const int h = 5;
+        const int actors = 7;
+        OccupancyIndex index;
+        index.reset(w, h, actors);
+        std::vector<Tile> model(actors, Off);
+        expect(index.actorCount() == actors, "actorCount()");
+        checkAgainst(index, model, w, h, "empty");
+
+        // Everyone on one tile, then off it one by one from each end of its list
+        const Tile crowd{ 2, 2 };
+        for (int a = 0; a < actors; ++a) {
+            index.place(a, crowd);
+            index.place(a, crowd);      // a second place() on the same tile changes nothing
+            model[a] = crowd;
+        }
+        checkAgainst(index, model, w, h, "crowded");
+        const int head = index.firstOn(crowd);
+        index.place(head, Tile{ 3, 2 });
+        model[head] = Tile{ 3, 2 };
+        checkAgainst(index, model, w, h, "head moved");
+        int last = index.firstOn(crowd);
+        while (index.nextOn(last) != OccupancyIndex::None) last = index.nextOn(last);
+        index.remove(last);
+        model[last] = Off;
+        checkAgainst(index, model, w, h, "tail removed");
+
+        // Moving each actor from inside forEachOn() visits each once
+        int visits = 0;
+        index.forEachOn(crowd, [&](int a) {
+            ++visits;
+            index.place(a, Tile{ 2, 1 });
+            model[a] = Tile{ 2, 1 };
+        });
+        expect(visits == 5 && index.countOn(crowd) == 0, "moving actors inside forEachOn(): " + std::to_string(visits) + " visits");
+        checkAgainst(index, model, w, h, "moved inside forEachOn()");
+
+        // Random moves on a small grid, so tiles often hold several actors
+        for (int step = 0; step < 3000; ++step) {
+            const int a = static_cast<int>(rng() % actors);
+            const int op = static_cast<int>(rng() % 10);
+            if (op == 0) {
+                index.remove(a);
+                model[a] = Off;
+            } else {
+                // Some placements fall just off the grid, which removes the actor
+                const Tile t{ static_cast<int>(rng() % (w + 1)) - (op == 1 ? 1 : 0), static_cast<int>(rng() % h) };
+                index.place(a, t);
+                const bool inside = t.x >= 0 && t.x < w;
+                model[a] = inside ? t : Off;
+            }
+            if (step % 25 == 0 || step > 2950) {
+                checkAgainst(index, model, w, h, "step " + std::to_string(step));
+            }
+        }
+
+        index.reset(w, h, actors);
+        std::fill(model.begin(), model.end(), Off);
+        checkAgainst(index, model, w, h, "after reset()");
+    }
+
+    // Three ghosts spawned on one corridor tile, too short an update for
+    // any of them to step off it
+    void checkCollisions() {
+        MapGrid grid(9, 3, tile::Wall);
+        for (int x = 1; x < 8; ++x) grid.at(x, 1) = tile::Dot;
+        const Tile spawn{ 4, 1 };
+        MonsterSystem monsters(grid, { spawn, spawn, spawn });
+        expect(monsters.getOccupancy().countOn(spawn) == 3, "three ghosts on the spawn tile");
+
+        MonsterPlayerState player;
+        player.gridX = spawn.x;
+        player.gridY = spawn.y;
+        monsters.setPlayerState(player);
+        monsters.setPlayerState(player);     // standing still: no back-stab
+        const double dt = 0.001;
+        const int wantHits[] = { 3, 0, 3, 0 };
+        for (int round = 0; round < 4; ++round) {
+            monsters.update(dt);
+            const MonsterEvents ev = monsters.pollEvents();
+            expect(ev.hits == wantHits[round] && ev.playerHit == (wantHits[round] > 0) && ev.ghostsEaten == 0,
+                   "update " + std::to_string(round) + ": " + std::to_string(ev.hits) + " hits, want " +
+                   std::to_string(wantHits[round]));
+        }
+
+        player.isPowered = true;
+        monsters.setPlayerState(player);
+        monsters.update(dt);
+        MonsterEvents ev = monsters.pollEvents();
+        expect(ev.ghostsEaten == 3 && ev.hits == 0 && !ev.playerHit,
+               "powered: " + std::to_string(ev.ghostsEaten) + " ghosts eaten");
+
+        player.isPowered = false;
+        player.gridX = 1;
+        monsters.setPlayerState(player);
+        monsters.setPlayerState(player);
+        monsters.update(dt);
+        ev = monsters.pollEvents();
+        expect(ev.hits == 0 && ev.ghostsEaten == 0 && !ev.playerHit, "player on another tile");
+    }
+
+}
+
+int main(int argc, char** argv) {
+    const std::uint64_t seed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1;
+    std::mt19937_64 rng(seed);
+
+    checkIndex(rng);
+    checkCollisions();
+
+    std::cout << "Occupancy_test: " << (failed == 0 ? "passed" : std::to_string(failed) + " failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+// PlanningBudget_test.cpp
+// Budgeted chase planning against a stub clock that moves one microsecond
+// each time the planner reads it, so a budget of n is n clock checks and
+// every run is repeatable. With the distance table, plans are instant and
+// one check is spent after each: a budget of 1 serves one request per
+// update, nearest target first and the lower ghost index on ties, with
+// requests that waited longer moving up; a budget of 3 serves three; a clock that never moves
+// serves them all. Ghosts waiting in the queue with nothing left to follow
+// step towards their target instead of carrying on along their heading.
+// Without the table, a plan to a far target fills a distance field one
+// 256-tile slice per clock check: the request stays queued across updates,
+// the field resumes where the deadline stopped it, and a larger budget
+// serves it sooner.
+//
+// Usage: PlanningBudget_test
+
+#include "entities/MonsterSystem.hpp"
+#include <cstdlib>
+#include <memory>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace game;
+
+namespace {
+
+    int failed = 0;
+
+    void expect(bool ok, const std::string& what) {
+        if (!ok && ++failed <= 10) {
+            std::cerr << "FAIL " << what << std::endl;
+        }
+    }
+
+    template <std::size_t H>
+    MapGrid mazeGrid(const char* const (&maze)[H]) {
+        const int w = static_cast<int>(std::string(maze[0]).size());
+        MapGrid grid(w, static_cast<int>(H));
+        for (int y = 0; y < static_cast<int>(H); ++y) {
+            for (int x = 0; x < w; ++x) {
+                grid.at(x, y) = maze[y][x] == '#' ? tile::Wall : tile::Dot;
+            }
+        }
+        return grid;
+    }
+
+    // One microsecond per read; `step` 0 stops it
+    MonsterSystem::PlanningClock stubClock(long long step) {
+        auto now = std::make_shared<long long>(0);
+        return [now, step]() { return *now += step; };
+    }
+
+    // A corridor with the player at (10, 1) and Red walled in at (1, 3), so
+    // it never chases and Yellow aims at the player too
+    const char* const corridor[] = {
+        "########################################",
+        "#......................................#",
+        "########################################",
+        "#.######################################",
+        "########################################",
+    };
+    const Tile corridorPlayer{ 10, 1 };
+    const std::vector<Tile> corridorSpawns = {
+        { 1, 3 }, { 13, 1 }, { 15, 1 }, { 14, 1 }, { 12, 1 }, { 16, 1 }, { 8, 1 },
+    };
+    // Nearest first, ties by index: 4 and 6 at 2 steps, then 1, 3, 2, 5
+    const std::size_t servedOrder[] = { 4, 6, 1, 3, 2, 5 };
+
+    void standStill(MonsterSystem& monsters, const Tile& at, Direction facing) {
+        MonsterPlayerState player;
+        player.gridX = at.x;
+        player.gridY = at.y;
+        player.dir = facing;
+        monsters.setPlayerState(player);
+        monsters.setPlayerState(player);
+    }
+
+    std::vector<std::size_t> pendingGhosts(const MonsterSystem& monsters) {
+        std::vector<std::size_t> out;
+        for (std::size_t i = 0; i < monsters.getRenderInfo().size(); ++i) {
+            if (monsters.isPlanPending(i)) out.push_back(i);
+        }
+        return out;
+    }
+
+    // Ghosts in servedOrder from position `from` on, in index order
+    std::vector<std::size_t> stillQueued(std::size_t from) {
+        std::vector<std::size_t> out;
+        for (std::size_t i = 1; i < corridorSpawns.size(); ++i) {
+            for (std::size_t k = from; k < sizeof(servedOrder) / sizeof(servedOrder[0]); ++k) {
+                if (servedOrder[k] == i) out.push_back(i);
+            }
+        }
+        return out;
+    }
+
+    void checkOrder() {
+        const MapGrid grid = mazeGrid(corridor);
+        MonsterSystem monsters(grid, corridorSpawns);
+        expect(monsters.hasDistanceTable(), "corridor: distance table");
+        monsters.setPlanningClock(stubClock(1));
+        monsters.setPlanningBudget(1);
+        standStill(monsters, corridorPlayer, Direction::Left);
+
+        // Long enough for every spawn delay; then one step per update
+        monsters.update(15.0);
+        const std::vector<GhostRenderInfo> first = monsters.getRenderInfo();
+        for (std::size_t i = 1; i < first.size(); ++i) {
+            const int before = std::abs(corridorSpawns[i].x - corridorPlayer.x);
+            const int after = std::abs(first[i].gridX - corridorPlayer.x);
+            expect(first[i].state == GhostState::Chase && after == before - 1,
+                   "ghost " + std::to_string(i) + " from " + std::to_string(before) + " to " +
+                   std::to_string(after) + " steps off the player");
+        }
+        expect(first[0].gridX == 1 && first[0].gridY == 3 && first[0].state == GhostState::Patrol, "Red walled in");
+
+        // Ghosts that reach the player's tile lose it and ask again later,
+        // so only the first requests are followed
+        const std::size_t rounds = sizeof(servedOrder) / sizeof(servedOrder[0]);
+        for (std::size_t k = 0; k < rounds; ++k) {
+            if (k > 0) monsters.update(0.001);
+            const std::vector<std::size_t> pending = pendingGhosts(monsters);
+            const std::vector<std::size_t> waiting = stillQueued(k + 1);
+            bool ok = !monsters.isPlanPending(servedOrder[k]);
+            for (std::size_t i : waiting) ok = ok && monsters.isPlanPending(i);
+            expect(ok && monsters.getPendingPlans() == pending.size(),
+                   "budget 1, update " + std::to_string(k) + ": ghost " + std::to_string(servedOrder[k]) +
+                   " should be the one served");
+            if (k + 1 == rounds) {
+                // 4 and 6 asked again from the player's tile, three updates
+                // after 5 asked from six steps away: 5 goes first
+                expect(monsters.isPlanPending(4) && monsters.isPlanPending(6),
+                       "budget 1: older request served before nearer newer ones");
+            }
+        }
+
+        // Three checks, three plans
+        MonsterSystem three(grid, corridorSpawns);
+        three.setPlanningClock(stubClock(1));
+        three.setPlanningBudget(3);
+        standStill(three, corridorPlayer, Direction::Left);
+        three.update(15.0);
+        expect(pendingGhosts(three) == stillQueued(3), "budget 3: first update serves 4, 6 and 1");
+        three.update(0.001);
+        expect(three.getPendingPlans() == 0, "budget 3: second update serves the rest");
+
+        // A clock that never moves never runs out
+        MonsterSystem frozen(grid, corridorSpawns);
+        frozen.setPlanningClock(stubClock(0));
+        frozen.setPlanningBudget(1);
+        standStill(frozen, corridorPlayer, Direction::Left);
+        frozen.update(15.0);
+        expect(frozen.getPendingPlans() == 0, "stopped clock: everything served at once");
+    }
+
+    // An open room, Red walled in below it at (1, 32). With the player at
+    // (30, 25) facing up, Yellow aims at (59, 14), far from its spawn.
+    std::vector<std::string> roomRows() {
+        std::vector<std::string> rows;
+        rows.push_back(std::string(61, '#'));
+        for (int y = 1; y < 30; ++y) rows.push_back("#" + std::string(59, '.') + "#");
+        rows.push_back(std::string(61, '#'));
+        rows.push_back(std::string(61, '#'));
+        rows.push_back("#." + std::string(59, '#'));
+        rows.push_back(std::string(61, '#'));
+        return rows;
+    }
+
+    // Updates until Yellow's plan is served under `budget`, 0 if it never is
+    int updatesToServe(int budget) {
+        const std::vector<std::string> rows = roomRows();
+        MapGrid grid(static_cast<int>(rows[0].size()), static_cast<int>(rows.size()));
+        for (int y = 0; y < grid.height(); ++y) {
+            for (int x = 0; x < grid.width(); ++x) {
+                grid.at(x, y) = rows[y][x] == '#' ? tile::Wall : tile::Dot;
+            }
+        }
+        MonsterSystem monsters(grid, { Tile{ 1, 32 }, Tile{ 26, 22 } });
+        monsters.setDistanceTableBudget(0);
+        monsters.setPlanningClock(stubClock(1));
+        monsters.setPlanningBudget(budget);
+        standStill(monsters, Tile{ 30, 25 }, Direction::Up);
+
+        for (int u = 1; u <= 12; ++u) {
+            monsters.update(u == 1 ? 5.0 : 0.001);
+            const GhostRenderInfo yellow = monsters.getRenderInfo()[1];
+            if (yellow.state != GhostState::Chase) return 0;
+            if (!monsters.isPlanPending(1)) return u;
+        }
+        return 0;
+    }
+
+    void checkSlices() {
+        const int oneSlice = updatesToServe(1);
+        const int twoSlices = updatesToServe(2);
+        expect(oneSlice >= 3, "one slice an update: served after " + std::to_string(oneSlice) + " updates");
+        expect(twoSlices > 0 && twoSlices < oneSlice,
+               "two slices an update: served after " + std::to_string(twoSlices) + " updates");
+        expect(updatesToServe(1000) == 1, "room: a large budget serves at once");
+    }
+
+}
+
+int main() {
+    checkOrder();
+    checkSlices();
+
+    std::cout << "PlanningBudget_test: " << (failed == 0 ? "passed" : std::to_string(failed) + " failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+}
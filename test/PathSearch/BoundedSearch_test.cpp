@@ -0,0 +1,169 @@
+// BoundedSearch_test.cpp
+// Range-limited PathEngine::search(), as used by the ghosts' perception
+// checks. For every engine the answer is the unbounded length when that is
+// within maxLength and -1 otherwise; BFS returns the very path an unbounded
+// search would. The work is bounded by the range, not the map: a goal
+// farther than maxLength in Manhattan distance is refused with nothing
+// expanded, and BFS and A* only expand tiles t with
+// dist(start, t) + Manhattan(t, goal) <= maxLength, at most the
+// 2r^2 + 2r + 1 tiles of the diamond round start. Checked against a plain
+// BFS on seeded random grids and on a 1001x1001 open map.
+//
+// Usage: BoundedSearch_test [seed]
+
+#include "entities/PathEngine.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace game;
+
+namespace {
+
+    int failed = 0;
+
+    void expect(bool ok, const std::string& what) {
+        if (!ok && ++failed <= 10) {
+            std::cerr << "FAIL " << what << std::endl;
+        }
+    }
+
+    int manhattan(const Tile& a, const Tile& b) { return std::abs(a.x - b.x) + std::abs(a.y - b.y); }
+
+    // Steps from `start` to every tile under `who`, -1 where unreachable
+    std::vector<int> distancesFrom(const TraversalMasks& masks, Traversal who, const Tile& start) {
+        const int w = masks.width();
+        std::vector<int> dist(static_cast<std::size_t>(w) * masks.height(), -1);
+        std::vector<Tile> queue{ start };
+        dist[start.y * w + start.x] = 0;
+        const int dx[4] = { 1, 0, -1, 0 };
+        const int dy[4] = { 0, -1, 0, 1 };
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            const Tile t = queue[head];
+            for (int d = 0; d < 4; ++d) {
+                const Tile n{ t.x + dx[d], t.y + dy[d] };
+                if (masks.canStep(who, t.x, t.y, static_cast<Direction>(d)) && dist[n.y * w + n.x] < 0) {
+                    dist[n.y * w + n.x] = dist[t.y * w + t.x] + 1;
+                    queue.push_back(n);
+                }
+            }
+        }
+        return dist;
+    }
+
+    // Tiles a bounded BFS or A* may expand: closer than maxLength, and still
+    // able to make the goal in time
+    int expandable(const std::vector<int>& dist, int w, const Tile& goal, int maxLength) {
+        int count = 0;
+        for (std::size_t i = 0; i < dist.size(); ++i) {
+            const Tile t{ static_cast<int>(i) % w, static_cast<int>(i) / w };
+            count += dist[i] >= 0 && dist[i] < maxLength && dist[i] + manhattan(t, goal) <= maxLength;
+        }
+        return count;
+    }
+
+    MapGrid randomMap(std::mt19937_64& rng, int w, int h, int wallPercent) {
+        MapGrid grid(w, h, tile::Wall);
+        for (int y = 1; y < h - 1; ++y) {
+            for (int x = 1; x < w - 1; ++x) {
+                grid.at(x, y) = static_cast<int>(rng() % 100) < wallPercent ? tile::Wall : tile::Dot;
+            }
+        }
+        return grid;
+    }
+
+    Tile randomFloor(std::mt19937_64& rng, const MapGrid& grid) {
+        for (;;) {
+            const Tile t{ static_cast<int>(rng() % static_cast<std::uint64_t>(grid.width())),
+                          static_cast<int>(rng() % static_cast<std::uint64_t>(grid.height())) };
+            if (grid.at(t.x, t.y) != tile::Wall) return t;
+        }
+    }
+
+    void checkMap(std::mt19937_64& rng, const MapGrid& grid, const std::string& name) {
+        TraversalMasks masks;
+        masks.build(grid);
+        const PathAlgorithm algorithms[] = { PathAlgorithm::BFS, PathAlgorithm::AStar, PathAlgorithm::JumpPoint };
+        const int ranges[] = { 0, 1, 4, 8, 16, 40 };
+        std::vector<Tile> path, unboundedPath;
+
+        for (int q = 0; q < 150; ++q) {
+            const Tile start = randomFloor(rng, grid);
+            // Half the goals near start, so most ranges matter
+            Tile goal = randomFloor(rng, grid);
+            for (int tries = 0; q % 2 == 0 && manhattan(start, goal) > 12 && tries < 1000; ++tries) {
+                goal = randomFloor(rng, grid);
+            }
+            const std::vector<int> dist = distancesFrom(masks, Traversal::Ghost, start);
+            const int truth = dist[goal.y * grid.width() + goal.x];
+
+            for (PathAlgorithm algorithm : algorithms) {
+                std::unique_ptr<PathEngine> engine = makePathEngine(algorithm);
+                const int unbounded = engine->search(masks, Traversal::Ghost, start, goal, 1 << 30, &unboundedPath);
+                for (int range : ranges) {
+                    const std::string what = name + " " + pathAlgorithmName(algorithm) + " query " + std::to_string(q) +
+                                             " range " + std::to_string(range);
+                    const int want = truth >= 0 && truth <= range ? truth : -1;
+                    const int length = engine->search(masks, Traversal::Ghost, start, goal, range, &path);
+                    const int expanded = engine->stats().lastExpanded;
+                    expect(length == want, what + ": length " + std::to_string(length) + ", want " + std::to_string(want));
+                    expect(static_cast<int>(path.size()) == (want > 0 ? want : 0), what + ": path size");
+                    if (algorithm == PathAlgorithm::BFS && want > 0) {
+                        expect(path == unboundedPath, what + ": path differs from the unbounded search");
+                    }
+                    if (manhattan(start, goal) > range) {
+                        expect(expanded == 0, what + ": searched although the goal is out of range");
+                    }
+                    if (algorithm != PathAlgorithm::JumpPoint) {
+                        const int limit = expandable(dist, grid.width(), goal, range);
+                        expect(expanded <= limit && expanded <= 2 * range * range + 2 * range + 1,
+                               what + ": expanded " + std::to_string(expanded) + ", at most " + std::to_string(limit));
+                    }
+                }
+                expect(unbounded == truth, name + " " + pathAlgorithmName(algorithm) + ": unbounded length");
+            }
+        }
+    }
+
+}
+
+int main(int argc, char** argv) {
+    const std::uint64_t seed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1;
+    std::mt19937_64 rng(seed);
+
+    checkMap(rng, randomMap(rng, 41, 31, 25), "41x31 25% walls");
+    checkMap(rng, randomMap(rng, 64, 64, 35), "64x64 35% walls");
+
+    // 1001x1001 open map: a perception check costs the same wherever the goal is
+    MapGrid open = randomMap(rng, 1001, 1001, 0);
+    for (int y = 480; y <= 520; ++y) open.at(505, y) = tile::Wall;   // a wall just right of centre
+    TraversalMasks masks;
+    masks.build(open);
+    const Tile centre{ 500, 500 };
+    std::unique_ptr<PathEngine> bfs = makePathEngine(PathAlgorithm::BFS);
+    struct Probe {
+        const char* what;
+        Tile goal;
+        int range;
+        int length;
+        int maxExpanded;
+    };
+    const Probe probes[] = {
+        { "far corner, range 8",           Tile{ 999, 999 }, 8, -1, 0 },
+        { "behind the wall, range 8",      Tile{ 508, 500 }, 8, -1, 145 },
+        { "in range, range 8",             Tile{ 504, 496 }, 8,  8, 145 },
+        { "round the wall, range 50",      Tile{ 508, 500 }, 50, 50, 2 * 50 * 50 + 2 * 50 + 1 },
+    };
+    for (const Probe& p : probes) {
+        const int length = bfs->search(masks, Traversal::Ghost, centre, p.goal, p.range, nullptr);
+        const int expanded = bfs->stats().lastExpanded;
+        expect(length == p.length && expanded <= p.maxExpanded,
+               std::string(p.what) + ": length " + std::to_string(length) + ", expanded " + std::to_string(expanded));
+    }
+
+    std::cout << "BoundedSearch_test: " << (failed == 0 ? "passed" : std::to_string(failed) + " failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+}
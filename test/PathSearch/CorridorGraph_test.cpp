@@ -0,0 +1,117 @@
+// CorridorGraph_test.cpp
+// CorridorGraph::search() against the BFS engine on seeded random grids:
+// same length for every query and cut-off, and every returned path a legal
+// walk of that length. Covers flat graphs and graphs above
+// HierarchyThreshold nodes (the clustered search).
+//
+// Usage: CorridorGraph_test [seed]
+
+#include "PathFixtures.hpp"
+#include "entities/CorridorGraph.hpp"
+#include "entities/PathEngine.hpp"
+#include <cstdlib>
+#include <limits>
+
+using namespace game;
+using namespace pathtest;
+
+namespace {
+
+    struct Case {
+        const char* name;
+        int width;
+        int height;
+        double walls;
+        int houses;
+        int clusterSize;
+        bool hierarchical;  // expect the clustered search
+        int queries;
+    };
+
+    const Case cases[] = {
+        { "small mixed",    40,  30, 0.30, 1, CorridorGraph::DefaultClusterSize, false, 400 },
+        { "corridors",      64,  64, 0.34, 2, CorridorGraph::DefaultClusterSize, false, 400 },
+        { "open rooms",     48,  48, 0.05, 2, CorridorGraph::DefaultClusterSize, false, 300 },
+        { "large",         256, 256, 0.30, 8, CorridorGraph::DefaultClusterSize, true,  50 },
+        { "large, small clusters", 200, 200, 0.35, 6, 12, true, 50 },
+    };
+
+    void runCase(const Case& c, Traversal who, std::uint64_t seed, Failures& failures) {
+        std::mt19937_64 rng(seed);
+        const MapGrid grid = randomGrid(rng, c.width, c.height, c.walls, c.houses);
+        TraversalMasks masks;
+        masks.build(grid);
+
+        CorridorGraph graph;
+        graph.build(masks, who, c.clusterSize);
+        const std::string where = std::string(c.name) + " seed " + std::to_string(seed) +
+                                  (who == Traversal::Player ? " player" : " ghost");
+        failures.check(graph.ready(), where + ": graph not built");
+        failures.check(graph.hierarchical() == c.hierarchical,
+                       where + ": " + std::to_string(graph.nodeCount()) + " nodes, hierarchical " +
+                       std::to_string(graph.hierarchical()));
+        if (c.hierarchical) {
+            failures.check(graph.nodeCount() > CorridorGraph::HierarchyThreshold,
+                           where + ": only " + std::to_string(graph.nodeCount()) + " nodes");
+        }
+
+        auto bfs = makePathEngine(PathAlgorithm::BFS);
+        CorridorGraph::Workspace ws;
+        std::vector<Tile> path;
+        const int unlimited = std::numeric_limits<int>::max();
+        int routed = 0;
+
+        for (int q = 0; q < c.queries; ++q) {
+            const Tile start = randomOpenTile(rng, masks, who);
+            const Tile goal = (q % 10 == 0) ? start : randomOpenTile(rng, masks, who);
+            if (!graph.covers(start) || !graph.covers(goal)) continue;
+
+            const int expected = bfs->search(masks, who, start, goal, unlimited, nullptr);
+            if (expected >= 0) ++routed;
+
+            // Unbounded, exactly long enough, one short, and a random cut-off
+            std::vector<int> limits = { unlimited };
+            if (expected >= 0) {
+                limits.push_back(expected);
+                limits.push_back(expected - 1);
+                limits.push_back(static_cast<int>(rng() % static_cast<std::uint64_t>(2 * expected + 2)));
+            } else {
+                limits.push_back(static_cast<int>(rng() % 64));
+            }
+
+            for (int maxLength : limits) {
+                if (maxLength < 0) continue;
+                const int want = bfs->search(masks, who, start, goal, maxLength, nullptr);
+                const int got = graph.search(start, goal, maxLength, &path, ws);
+                const std::string query = where + ": " + tileText(start) + " -> " + tileText(goal) +
+                                          " max " + std::to_string(maxLength);
+                failures.check(got == want, query + ": graph " + std::to_string(got) +
+                                            ", bfs " + std::to_string(want));
+                if (got >= 0) {
+                    failures.check(validPath(masks, who, start, goal, path, got), query + ": invalid path");
+                } else {
+                    failures.check(path.empty(), query + ": path not cleared");
+                }
+                // Length-only queries agree with path queries
+                failures.check(graph.search(start, goal, maxLength, nullptr, ws) == got,
+                               query + ": length-only search differs");
+            }
+        }
+        // These grids are open enough that many random pairs are connected
+        failures.check(routed > c.queries / 8, where + ": only " + std::to_string(routed) + " routed queries");
+    }
+
+}
+
+int main(int argc, char** argv) {
+    const std::uint64_t seed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1;
+
+    Failures failures;
+    for (const Case& c : cases) {
+        for (std::uint64_t s = seed; s < seed + 3; ++s) {
+            runCase(c, Traversal::Player, s, failures);
+            runCase(c, Traversal::Ghost, s, failures);
+        }
+    }
+    return failures.finish("CorridorGraph_test");
+}
@@ -0,0 +1,251 @@
+// CorridorStructure_test.cpp
+// What CorridorGraph builds, rather than what it answers. On a hand-drawn
+// maze the nodes are exactly the junction, the dead ends and the one-way
+// ghost door, and the seven edges (two of them the loop walked both ways)
+// have the expected ends, lengths and tile runs. On generated mazes, for
+// the Player and Ghost rules: a tile is a node iff it can be entered and
+// does not have exactly two exits mirrored by its enterable neighbours
+// (walls step out onto corridors, never in, and do not count); every node
+// has one out edge per exit; each edge run is a legal walk through
+// corridor tiles ending at a node; every corridor tile lies on some run;
+// and the graph is much smaller than the maze.
+//
+// Usage: CorridorStructure_test
+
+#include "entities/CorridorGraph.hpp"
+#include "map/MazeGenerator.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace game;
+
+namespace {
+
+    int failed = 0;
+
+    void expect(bool ok, const std::string& what) {
+        if (!ok && ++failed <= 10) {
+            std::cerr << "FAIL " << what << std::endl;
+        }
+    }
+
+    std::string at(const Tile& t) { return "(" + std::to_string(t.x) + "," + std::to_string(t.y) + ")"; }
+
+    struct EdgeInfo {
+        Tile from;
+        Tile to;
+        std::vector<Tile> run;
+    };
+
+    std::vector<EdgeInfo> edgesOf(const CorridorGraph& graph) {
+        std::vector<EdgeInfo> out;
+        graph.forEachEdge([&](const Tile& from, const Tile& to, const std::vector<Tile>& run) {
+            out.push_back(EdgeInfo{ from, to, run });
+        });
+        return out;
+    }
+
+    // A loop (4, 1) -> left round -> (4, 1), a corridor from (4, 1) to the
+    // dead end (6, 4), the ghost door (6, 5) under it and a two-tile house
+    const char* const maze[] = {
+        "##########",
+        "#........#",
+        "#.##.###.#",
+        "#.##.#...#",
+        "#....#.###",
+        "######D###",
+        "#####GG###",
+        "##########",
+    };
+
+    MapGrid mazeGrid() {
+        const int h = static_cast<int>(sizeof(maze) / sizeof(maze[0]));
+        const int w = static_cast<int>(std::string(maze[0]).size());
+        MapGrid grid(w, h);
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                const char c = maze[y][x];
+                grid.at(x, y) = c == '#' ? tile::Wall : c == 'G' ? tile::House : c == 'D' ? tile::Door : tile::Dot;
+            }
+        }
+        return grid;
+    }
+
+    std::vector<Tile> tiles(std::initializer_list<Tile> list) { return std::vector<Tile>(list); }
+
+    void checkHandDrawn() {
+        const MapGrid grid = mazeGrid();
+        TraversalMasks masks;
+        masks.build(grid);
+        CorridorGraph graph;
+        graph.build(masks, Traversal::Ghost);
+
+        // Nodes: the junction, the dead end outside the door (ghosts cannot
+        // step onto a door from outside), the one-way door, the house's
+        // inner dead end. The other house tile is a two-way corridor.
+        const Tile nodes[] = { Tile{ 4, 1 }, Tile{ 6, 4 }, Tile{ 6, 5 }, Tile{ 5, 6 } };
+        int nodeTiles = 0;
+        for (int y = 0; y < grid.height(); ++y) {
+            for (int x = 0; x < grid.width(); ++x) {
+                nodeTiles += graph.isNode(Tile{ x, y });
+            }
+        }
+        expect(graph.nodeCount() == 4 && nodeTiles == 4, "hand-drawn: " + std::to_string(graph.nodeCount()) + " nodes");
+        for (const Tile& n : nodes) {
+            expect(graph.isNode(n), "hand-drawn: " + at(n) + " is not a node");
+        }
+
+        const std::vector<Tile> loopLeft = tiles({
+            { 3, 1 }, { 2, 1 }, { 1, 1 }, { 1, 2 }, { 1, 3 }, { 1, 4 }, { 2, 4 }, { 3, 4 },
+            { 4, 4 }, { 4, 3 }, { 4, 2 }, { 4, 1 } });
+        std::vector<Tile> loopDown(loopLeft.rbegin() + 1, loopLeft.rend());
+        loopDown.push_back(Tile{ 4, 1 });
+        const std::vector<Tile> toDeadEnd = tiles({
+            { 5, 1 }, { 6, 1 }, { 7, 1 }, { 8, 1 }, { 8, 2 }, { 8, 3 }, { 7, 3 }, { 6, 3 }, { 6, 4 } });
+        std::vector<Tile> fromDeadEnd(toDeadEnd.rbegin() + 1, toDeadEnd.rend());
+        fromDeadEnd.push_back(Tile{ 4, 1 });
+        const EdgeInfo expected[] = {
+            { { 4, 1 }, { 4, 1 }, loopLeft },
+            { { 4, 1 }, { 4, 1 }, loopDown },
+            { { 4, 1 }, { 6, 4 }, toDeadEnd },
+            { { 6, 4 }, { 4, 1 }, fromDeadEnd },
+            { { 6, 5 }, { 6, 4 }, tiles({ { 6, 4 } }) },                 // out of the door
+            { { 6, 5 }, { 5, 6 }, tiles({ { 6, 6 }, { 5, 6 } }) },       // back into the house
+            { { 5, 6 }, { 6, 5 }, tiles({ { 6, 6 }, { 6, 5 } }) },
+        };
+        const std::vector<EdgeInfo> edges = edgesOf(graph);
+        expect(graph.edgeCount() == 7 && edges.size() == 7, "hand-drawn: " + std::to_string(edges.size()) + " edges");
+        for (const EdgeInfo& e : expected) {
+            const bool found = std::any_of(edges.begin(), edges.end(), [&](const EdgeInfo& got) {
+                return got.from == e.from && got.to == e.to && got.run == e.run;
+            });
+            expect(found, "hand-drawn: no edge " + at(e.from) + " -> " + at(e.to) + " of length " +
+                   std::to_string(e.run.size()));
+        }
+        // A wall beside the corridors can be left but not entered
+        expect(!graph.covers(Tile{ 2, 2 }) && graph.covers(Tile{ 7, 3 }) && graph.covers(Tile{ 6, 6 }),
+               "hand-drawn: covers()");
+    }
+
+    // Directions from which a neighbour steps into (x, y); with
+    // `enterableOnly`, neighbours that nothing steps into (walls) are ignored
+    std::uint8_t stepsIn(const TraversalMasks& masks, Traversal who, int x, int y, bool enterableOnly) {
+        const Direction dirs[4] = { Direction::Right, Direction::Up, Direction::Left, Direction::Down };
+        const int dx[4] = { 1, 0, -1, 0 };
+        const int dy[4] = { 0, -1, 0, 1 };
+        const Direction back[4] = { Direction::Left, Direction::Down, Direction::Right, Direction::Up };
+        std::uint8_t in = 0;
+        for (int d = 0; d < 4; ++d) {
+            if (masks.canStep(who, x + dx[d], y + dy[d], back[d]) &&
+                (!enterableOnly || stepsIn(masks, who, x + dx[d], y + dy[d], false) != 0)) {
+                in |= exitBit(dirs[d]);
+            }
+        }
+        return in;
+    }
+
+    // The documented node rule, from the masks alone
+    bool nodeByRule(const TraversalMasks& masks, Traversal who, int x, int y, bool* enterable) {
+        *enterable = stepsIn(masks, who, x, y, false) != 0;
+        const std::uint8_t in = stepsIn(masks, who, x, y, true);
+        const std::uint8_t out = masks.exits(who, x, y);
+        return *enterable && (exitCount(out) != 2 || in != out);
+    }
+
+    bool adjacent(const Tile& a, const Tile& b, Direction* d) {
+        const int dx = b.x - a.x;
+        const int dy = b.y - a.y;
+        *d = dx == 1 && dy == 0 ? Direction::Right : dx == -1 && dy == 0 ? Direction::Left
+           : dx == 0 && dy == 1 ? Direction::Down : dx == 0 && dy == -1 ? Direction::Up : Direction::None;
+        return *d != Direction::None;
+    }
+
+    void checkGenerated(const MazeConfig& config, Traversal who) {
+        LevelData level;
+        std::string error;
+        expect(MazeGenerator::generate(config, level, &error), "generate: " + error);
+        const MapGrid& grid = level.tiles;
+        const std::string name = level.name + (who == Traversal::Player ? " player" : " ghost");
+        TraversalMasks masks;
+        masks.build(grid);
+        CorridorGraph graph;
+        graph.build(masks, who);
+
+        int nodes = 0;
+        int enterableTiles = 0;
+        int wrongNodes = 0;
+        std::vector<int> outEdges(grid.size(), 0);
+        for (int y = 0; y < grid.height(); ++y) {
+            for (int x = 0; x < grid.width(); ++x) {
+                bool enterable = false;
+                const bool node = nodeByRule(masks, who, x, y, &enterable);
+                nodes += node;
+                enterableTiles += enterable;
+                wrongNodes += node != graph.isNode(Tile{ x, y });
+            }
+        }
+        expect(wrongNodes == 0, name + ": " + std::to_string(wrongNodes) + " tiles break the node rule");
+        expect(graph.nodeCount() == nodes, name + ": node count");
+        expect(graph.nodeCount() * 2 < enterableTiles, name + ": " + std::to_string(graph.nodeCount()) +
+               " nodes for " + std::to_string(enterableTiles) + " tiles");
+
+        // Runs: legal steps, corridor tiles inside, a node at the end
+        std::vector<bool> onRun(grid.size(), false);
+        int badRuns = 0;
+        int edges = 0;
+        graph.forEachEdge([&](const Tile& from, const Tile& to, const std::vector<Tile>& run) {
+            ++edges;
+            ++outEdges[grid.index(from.x, from.y)];
+            bool ok = graph.isNode(from) && graph.isNode(to) && !run.empty() && run.back() == to;
+            Tile cur = from;
+            for (std::size_t k = 0; ok && k < run.size(); ++k) {
+                Direction d;
+                ok = adjacent(cur, run[k], &d) && masks.canStep(who, cur.x, cur.y, d) &&
+                     (k + 1 == run.size() || !graph.isNode(run[k]));
+                onRun[grid.index(run[k].x, run[k].y)] = true;
+                cur = run[k];
+            }
+            badRuns += !ok;
+        });
+        expect(badRuns == 0, name + ": " + std::to_string(badRuns) + " edge runs are not corridor walks");
+        expect(edges == graph.edgeCount(), name + ": forEachEdge() count");
+
+        int wrongDegree = 0;
+        int stranded = 0;
+        for (int y = 0; y < grid.height(); ++y) {
+            for (int x = 0; x < grid.width(); ++x) {
+                const int i = grid.index(x, y);
+                if (graph.isNode(Tile{ x, y })) {
+                    wrongDegree += outEdges[i] != exitCount(masks.exits(who, x, y));
+                } else {
+                    bool enterable = false;
+                    nodeByRule(masks, who, x, y, &enterable);
+                    stranded += enterable && !onRun[i];
+                }
+            }
+        }
+        expect(wrongDegree == 0, name + ": " + std::to_string(wrongDegree) + " nodes without one edge per exit");
+        expect(stranded == 0, name + ": " + std::to_string(stranded) + " corridor tiles on no run");
+    }
+
+}
+
+int main() {
+    checkHandDrawn();
+
+    const std::uint64_t seeds[] = { 3, 11 };
+    for (std::uint64_t seed : seeds) {
+        MazeConfig config;
+        config.width = 63;
+        config.height = 41;
+        config.seed = seed;
+        config.ghostHouses = 2;
+        checkGenerated(config, Traversal::Ghost);
+        checkGenerated(config, Traversal::Player);
+    }
+
+    std::cout << "CorridorStructure_test: " << (failed == 0 ? "passed" : std::to_string(failed) + " failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+// DStarLite_test.cpp
+// DStarLite::plan() against the BFS engine on seeded random grids while the
+// chaser walks, the goal moves (by a step or a jump) and tiles are edited
+// through tileChanged(): every plan must have the BFS length and be a legal
+// walk of that length.
+//
+// Usage: DStarLite_test [seed]
+
+#include "PathFixtures.hpp"
+#include "entities/DStarLite.hpp"
+#include "entities/PathEngine.hpp"
+#include <cstdlib>
+#include <limits>
+
+using namespace game;
+using namespace pathtest;
+
+namespace {
+
+    struct Case {
+        const char* name;
+        int width;
+        int height;
+        double walls;
+        int houses;
+        int steps;
+    };
+
+    const Case cases[] = {
+        { "small",     24, 20, 0.25, 1, 400 },
+        { "mixed",     48, 40, 0.30, 2, 600 },
+        { "open",      40, 40, 0.08, 2, 400 },
+        { "corridors", 64, 48, 0.33, 3, 600 },
+    };
+
+    // A random legal step from `at` for `who`, or `at` if it has none
+    Tile randomStep(std::mt19937_64& rng, const TraversalMasks& masks, Traversal who, const Tile& at) {
+        static constexpr int dx[4] = { 1, 0, -1, 0 };   // Right, Up, Left, Down
+        static constexpr int dy[4] = { 0, -1, 0, 1 };
+        const int first = static_cast<int>(rng() % 4);
+        for (int k = 0; k < 4; ++k) {
+            const int d = (first + k) % 4;
+            if (masks.canStep(who, at.x, at.y, static_cast<Direction>(d))) {
+                return Tile{ at.x + dx[d], at.y + dy[d] };
+            }
+        }
+        return at;
+    }
+
+    void runCase(const Case& c, Traversal who, std::uint64_t seed, Failures& failures) {
+        std::mt19937_64 rng(seed);
+        MapGrid grid = randomGrid(rng, c.width, c.height, c.walls, c.houses);
+        TraversalMasks masks;
+        masks.build(grid);
+
+        DStarLite planner;
+        planner.reset(masks, who);
+        auto bfs = makePathEngine(PathAlgorithm::BFS);
+        const int unlimited = std::numeric_limits<int>::max();
+        const std::string where = std::string(c.name) + " seed " + std::to_string(seed) +
+                                  (who == Traversal::Player ? " player" : " ghost");
+
+        Tile start = randomOpenTile(rng, masks, who);
+        Tile goal = randomOpenTile(rng, masks, who);
+        std::vector<Tile> path;
+        int routed = 0;
+        int edits = 0;
+
+        for (int step = 0; step < c.steps; ++step) {
+            const int got = planner.plan(start, goal, path);
+            const int want = bfs->search(masks, who, start, goal, unlimited, nullptr);
+            const std::string query = where + " step " + std::to_string(step) + ": " +
+                                      tileText(start) + " -> " + tileText(goal);
+            failures.check(got == want, query + ": plan " + std::to_string(got) +
+                                        ", bfs " + std::to_string(want));
+            if (got >= 0) {
+                ++routed;
+                failures.check(validPath(masks, who, start, goal, path, got), query + ": invalid path");
+            } else {
+                failures.check(path.empty(), query + ": path not cleared");
+            }
+
+            // Chaser: follow the plan, else wander
+            start = !path.empty() ? path.front() : randomStep(rng, masks, who, start);
+
+            // Goal: usually a step, sometimes a jump, or stays put
+            const std::uint64_t roll = rng() % 100;
+            if (roll < 40) {
+                goal = randomStep(rng, masks, who, goal);
+            } else if (roll < 45 || start == goal) {
+                goal = randomOpenTile(rng, masks, who);
+            }
+
+            // Edits: wall a tile on the current route, so the repair has
+            // work to do, and open a random wall so the grid does not fill
+            // up; never the chaser's or the goal's tile
+            auto edit = [&](const Tile& t, std::uint8_t after) {
+                if (t == start || t == goal || grid.at(t.x, t.y) == after) return;
+                grid.set(t.x, t.y, after);
+                masks.update(grid, t.x, t.y);
+                planner.tileChanged(t.x, t.y);
+                ++edits;
+            };
+            if (!path.empty() && rng() % 2 == 0) {
+                edit(path[rng() % path.size()], tile::Wall);
+            }
+            for (int attempt = 0; attempt < 20; ++attempt) {
+                const Tile t{ 1 + static_cast<int>(rng() % static_cast<std::uint64_t>(c.width - 2)),
+                              1 + static_cast<int>(rng() % static_cast<std::uint64_t>(c.height - 2)) };
+                if (grid.at(t.x, t.y) == tile::Wall) {
+                    edit(t, rng() % 8 == 0 ? tile::Door : tile::Path);
+                    break;
+                }
+            }
+            // A chaser or goal walled in by edits around it gets a fresh tile
+            if (masks.exits(who, start.x, start.y) == 0) start = randomOpenTile(rng, masks, who);
+            if (masks.exits(who, goal.x, goal.y) == 0) goal = randomOpenTile(rng, masks, who);
+        }
+        failures.check(routed > c.steps / 4, where + ": only " + std::to_string(routed) + " routed plans");
+        failures.check(edits > c.steps / 2, where + ": only " + std::to_string(edits) + " edits");
+    }
+
+}
+
+int main(int argc, char** argv) {
+    const std::uint64_t seed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1;
+
+    Failures failures;
+    for (const Case& c : cases) {
+        for (std::uint64_t s = seed; s < seed + 4; ++s) {
+            runCase(c, Traversal::Player, s, failures);
+            runCase(c, Traversal::Ghost, s, failures);
+        }
+    }
+    return failures.finish("DStarLite_test");
+}
@@ -0,0 +1,187 @@
+// DistanceField_test.cpp
+// DistanceField, the reverse BFS all ghosts share when they chase the
+// player: on a hand-drawn maze with an open room, a dead-end spur and a
+// ghost house, distance() from every tile equals the BFS engine's forward
+// search to the target, and nextStep() is a legal step one closer, preferring
+// right, left, down, up. One-way doors hold: tiles outside cannot reach a
+// target in the house. Filled in slices, every reached tile is already
+// final and settledRange() never over-promises; the finished field equals a
+// single build(). Rebuilding the same object for many targets (stamp reuse),
+// invalidate() and a target off the map are covered too.
+//
+// Usage: DistanceField_test
+
+#include "entities/DistanceField.hpp"
+#include "entities/PathEngine.hpp"
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace game;
+
+namespace {
+
+    int failed = 0;
+
+    void expect(bool ok, const std::string& what) {
+        if (!ok && ++failed <= 10) {
+            std::cerr << "FAIL " << what << std::endl;
+        }
+    }
+
+    // Open room top left, a loop round the right-hand block, a spur down
+    // to (12, 7), ghost house x 8..10 on row 6 under its door at (9, 5)
+    const char* const maze[] = {
+        "###############",
+        "#.....#.......#",
+        "#.....#.#####.#",
+        "#.....#.#####.#",
+        "#.............#",
+        "#.##.####D##.##",
+        "#.#..###GGG#.##",
+        "#.#.########.##",
+        "#...###########",
+        "###############",
+    };
+
+    MapGrid mazeGrid() {
+        const int h = static_cast<int>(sizeof(maze) / sizeof(maze[0]));
+        const int w = static_cast<int>(std::string(maze[0]).size());
+        MapGrid grid(w, h);
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                const char c = maze[y][x];
+                grid.at(x, y) = c == '#' ? tile::Wall : c == 'G' ? tile::House : c == 'D' ? tile::Door : tile::Path;
+            }
+        }
+        return grid;
+    }
+
+    Tile stepFrom(const Tile& t, Direction d) {
+        switch (d) {
+            case Direction::Right: return Tile{ t.x + 1, t.y };
+            case Direction::Left:  return Tile{ t.x - 1, t.y };
+            case Direction::Down:  return Tile{ t.x, t.y + 1 };
+            case Direction::Up:    return Tile{ t.x, t.y - 1 };
+            default:               return t;
+        }
+    }
+
+    std::string at(const Tile& t) { return "(" + std::to_string(t.x) + "," + std::to_string(t.y) + ")"; }
+
+    // The first direction in right, left, down, up order that is legal and
+    // one step closer, per the BFS engine
+    Direction preferredStep(PathEngine& bfs, const TraversalMasks& masks, const Tile& from, const Tile& target, int d) {
+        const Direction order[4] = { Direction::Right, Direction::Left, Direction::Down, Direction::Up };
+        for (Direction dir : order) {
+            if (masks.canStep(Traversal::Ghost, from.x, from.y, dir) &&
+                bfs.search(masks, Traversal::Ghost, stepFrom(from, dir), target, 1 << 20, nullptr) == d - 1) {
+                return dir;
+            }
+        }
+        return Direction::None;
+    }
+
+    // A complete field for `target` against the BFS engine, every tile an
+    // actor can stand on (exit masks, and so the field, say nothing useful
+    // about walls)
+    void checkField(const DistanceField& field, const MapGrid& grid, const TraversalMasks& masks,
+                    PathEngine& bfs, const Tile& target, const std::string& name) {
+        expect(field.valid() && field.complete() && field.target() == target, name + ": not a complete field");
+        for (int y = 0; y < grid.height(); ++y) {
+            for (int x = 0; x < grid.width(); ++x) {
+                const Tile from{ x, y };
+                if (grid.at(x, y) == tile::Wall) continue;
+                const std::string where = name + " from " + at(from);
+                const int want = bfs.search(masks, Traversal::Ghost, from, target, 1 << 20, nullptr);
+                const int d = field.distance(from);
+                expect(d == want, where + ": distance " + std::to_string(d) + ", BFS " + std::to_string(want));
+                const Direction step = field.nextStep(from);
+                if (want > 0) {
+                    expect(step == preferredStep(bfs, masks, from, target, want),
+                           where + ": next step is not the preferred closer step");
+                } else {
+                    expect(step == Direction::None, where + ": step at the target or with no path");
+                }
+            }
+        }
+    }
+
+}
+
+int main() {
+    const MapGrid grid = mazeGrid();
+    TraversalMasks masks;
+    masks.build(grid);
+    std::unique_ptr<PathEngine> bfs = makePathEngine(PathAlgorithm::BFS);
+
+    // Targets: room corner, spur end, in front of the door, inside the house, bottom loop
+    const Tile targets[] = { Tile{ 1, 1 }, Tile{ 12, 7 }, Tile{ 9, 4 }, Tile{ 10, 6 }, Tile{ 2, 8 } };
+    DistanceField field;
+    for (const Tile& target : targets) {
+        field.build(masks, Traversal::Ghost, target);
+        checkField(field, grid, masks, *bfs, target, "target " + at(target));
+    }
+
+    // Known answers
+    field.build(masks, Traversal::Ghost, Tile{ 10, 6 });
+    expect(field.distance(Tile{ 8, 6 }) == 2 && field.distance(Tile{ 9, 4 }) == -1 &&
+           field.nextStep(Tile{ 9, 4 }) == Direction::None, "house target: reachable from inside only");
+    field.build(masks, Traversal::Ghost, Tile{ 9, 4 });
+    expect(field.distance(Tile{ 10, 6 }) == 3 && field.nextStep(Tile{ 9, 6 }) == Direction::Up,
+           "door target: out of the house");
+    expect(field.distance(Tile{ 12, 7 }) == 6 && field.nextStep(Tile{ 12, 7 }) == Direction::Up, "spur end");
+
+    // Slices: whatever is reached is final; nothing within settledRange() is missing
+    const Tile target{ 2, 8 };
+    DistanceField full;
+    full.build(masks, Traversal::Ghost, target);
+    const std::size_t slices[] = { 1, 3, 7 };
+    for (std::size_t slice : slices) {
+        DistanceField sliced;
+        sliced.begin(masks, Traversal::Ghost, target);
+        const std::string name = "slices of " + std::to_string(slice);
+        int rounds = 0;
+        bool done = false;
+        while (!done && rounds < 1000) {
+            done = sliced.advance(slice);
+            ++rounds;
+            const int settled = sliced.settledRange();
+            int wrong = 0;
+            int missing = 0;
+            for (int y = 0; y < grid.height(); ++y) {
+                for (int x = 0; x < grid.width(); ++x) {
+                    const int d = sliced.distance(Tile{ x, y });
+                    const int want = full.distance(Tile{ x, y });
+                    wrong += d >= 0 && d != want;
+                    missing += d < 0 && want >= 0 && want <= settled;
+                }
+            }
+            expect(wrong == 0, name + ", round " + std::to_string(rounds) + ": reached tile with another distance");
+            expect(missing == 0, name + ", round " + std::to_string(rounds) + ": tile within settledRange() missing");
+        }
+        expect(done && sliced.complete() && sliced.settledRange() == std::numeric_limits<int>::max(), name + ": never finished");
+        expect(rounds > 1, name + ": finished in one round");
+        checkField(sliced, grid, masks, *bfs, target, name);
+    }
+
+    // The same object over many fills (stamps, not clears), then invalidated
+    DistanceField reused;
+    for (int round = 0; round < 300; ++round) {
+        reused.build(masks, Traversal::Ghost, targets[round % 5]);
+    }
+    checkField(reused, grid, masks, *bfs, targets[299 % 5], "after 300 fills");
+    reused.invalidate();
+    expect(!reused.valid() && reused.distance(targets[4]) == -1 && reused.nextStep(Tile{ 3, 8 }) == Direction::None,
+           "invalidated field answered");
+
+    // A target off the map reaches nothing
+    field.build(masks, Traversal::Ghost, Tile{ -1, 3 });
+    expect(field.complete() && field.distance(Tile{ 1, 1 }) == -1 && field.distance(Tile{ 0, 3 }) == -1,
+           "target off the map");
+
+    std::cout << "DistanceField_test: " << (failed == 0 ? "passed" : std::to_string(failed) + " failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+}
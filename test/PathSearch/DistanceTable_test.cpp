@@ -0,0 +1,214 @@
+// DistanceTable_test.cpp
+// DistanceTable on a hand-drawn 13x12 maze with a ghost house: for every
+// ordered pair of tiles, distance() equals the BFS engine's length and
+// firstStep() is the first tile of the BFS engine's path (same right, left,
+// down, up tie-break), under the Player and the one-way Ghost rule. Walls,
+// tiles outside the map and from == to give -1 / None / 0 as documented.
+// A budget one byte short of the table disables it. Without one,
+// MonsterSystem falls back to its corridor graph and, on a loop-free maze
+// where every shortest path is unique, moves the ghosts exactly as it does
+// with the table.
+//
+// Usage: DistanceTable_test
+
+#include "entities/DistanceTable.hpp"
+#include "entities/MonsterSystem.hpp"
+#include "entities/PathEngine.hpp"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace game;
+
+namespace {
+
+    int failed = 0;
+
+    void expect(bool ok, const std::string& what) {
+        if (!ok && ++failed <= 10) {
+            std::cerr << "FAIL " << what << std::endl;
+        }
+    }
+
+    // Door at (6, 4), house tiles x 5..7, y 5..6; loops around both sides
+    const char* const maze[] = {
+        "#############",
+        "#...........#",
+        "#.###.#.###.#",
+        "#.#.......#.#",
+        "#.#.##D##.#.#",
+        "#...#GGG#...#",
+        "###.#GGG#.###",
+        "#...#####...#",
+        "#.#.......#.#",
+        "#.###.#.###.#",
+        "#...........#",
+        "#############",
+    };
+
+    // No loops and a one-tile-wide house: one shortest path between any
+    // two tiles, so any exact search picks the same route
+    const char* const tree[] = {
+        "#############",
+        "#.....#.....#",
+        "#.###.#.###.#",
+        "#.#.......#.#",
+        "#.#.##D##.#.#",
+        "#.#.##G##.#.#",
+        "#.#.##G##.#.#",
+        "#.#.##G##.#.#",
+        "#.#.#####.#.#",
+        "#############",
+    };
+
+    template <std::size_t H>
+    MapGrid mazeGrid(const char* const (&maze)[H]) {
+        const int h = static_cast<int>(H);
+        const int w = static_cast<int>(std::string(maze[0]).size());
+        MapGrid grid(w, h, tile::Wall);
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                const char c = maze[y][x];
+                grid.at(x, y) = c == '#' ? tile::Wall : c == 'G' ? tile::House : c == 'D' ? tile::Door : tile::Dot;
+            }
+        }
+        return grid;
+    }
+
+    Tile stepFrom(const Tile& t, Direction d) {
+        switch (d) {
+            case Direction::Right: return Tile{ t.x + 1, t.y };
+            case Direction::Left:  return Tile{ t.x - 1, t.y };
+            case Direction::Down:  return Tile{ t.x, t.y + 1 };
+            case Direction::Up:    return Tile{ t.x, t.y - 1 };
+            default:               return t;
+        }
+    }
+
+    // Tiles the table covers: those `who` can leave or enter
+    std::vector<bool> coveredTiles(const MapGrid& grid, const TraversalMasks& masks, Traversal who) {
+        const Direction dirs[4] = { Direction::Right, Direction::Left, Direction::Down, Direction::Up };
+        std::vector<bool> covered(grid.size(), false);
+        for (int y = 0; y < grid.height(); ++y) {
+            for (int x = 0; x < grid.width(); ++x) {
+                for (Direction d : dirs) {
+                    if (!masks.canStep(who, x, y, d)) continue;
+                    const Tile n = stepFrom(Tile{ x, y }, d);
+                    covered[grid.index(x, y)] = true;
+                    covered[grid.index(n.x, n.y)] = true;
+                }
+            }
+        }
+        return covered;
+    }
+
+    // Every ordered pair against the BFS engine
+    void checkAllPairs(const MapGrid& grid, const TraversalMasks& masks, Traversal who, const char* name) {
+        SearchWorkspace work;
+        DistanceTable table;
+        expect(table.build(masks, who, work) && table.ready(), std::string(name) + ": build");
+        const std::vector<bool> covered = coveredTiles(grid, masks, who);
+        std::unique_ptr<PathEngine> bfs = makePathEngine(PathAlgorithm::BFS);
+        std::vector<Tile> path;
+        int nodes = 0;
+        for (int i = 0; i < static_cast<int>(grid.size()); ++i) {
+            const Tile from{ i % grid.width(), i / grid.width() };
+            nodes += covered[i];
+            for (int j = 0; j < static_cast<int>(grid.size()); ++j) {
+                const Tile to{ j % grid.width(), j / grid.width() };
+                const std::string pair = std::string(name) + " (" + std::to_string(from.x) + "," + std::to_string(from.y) +
+                                         ")->(" + std::to_string(to.x) + "," + std::to_string(to.y) + ")";
+                const int length = table.distance(from, to);
+                const Direction first = table.firstStep(from, to);
+                if (!covered[i] || !covered[j]) {
+                    expect(length == -1 && first == Direction::None, pair + ": tile outside the table answered");
+                    continue;
+                }
+                const int want = bfs->search(masks, who, from, to, 1 << 20, &path);
+                expect(length == want, pair + ": distance " + std::to_string(length) + ", BFS " + std::to_string(want));
+                if (want > 0) {
+                    expect(stepFrom(from, first) == path.front(), pair + ": first step differs from BFS");
+                    expect(masks.canStep(who, from.x, from.y, first) &&
+                           table.distance(stepFrom(from, first), to) == want - 1, pair + ": first step not on a shortest path");
+                } else {
+                    expect(first == Direction::None, pair + ": step without a path");
+                }
+            }
+        }
+        expect(table.nodeCount() == nodes, std::string(name) + ": " + std::to_string(table.nodeCount()) + " nodes, " +
+               std::to_string(nodes) + " covered tiles");
+    }
+
+}
+
+int main() {
+    const MapGrid grid = mazeGrid(maze);
+    TraversalMasks masks;
+    masks.build(grid);
+
+    checkAllPairs(grid, masks, Traversal::Player, "Player");
+    checkAllPairs(grid, masks, Traversal::Ghost, "Ghost");
+
+    // Known answers: the door is one-way, outside the map is no tile
+    SearchWorkspace work;
+    DistanceTable table;
+    table.build(masks, Traversal::Ghost, work);
+    const Tile house{ 6, 5 };
+    const Tile aboveDoor{ 6, 3 };
+    expect(table.distance(house, aboveDoor) == 2 && table.firstStep(house, aboveDoor) == Direction::Up, "out through the door");
+    expect(table.distance(aboveDoor, house) == -1 && table.firstStep(aboveDoor, house) == Direction::None,
+           "back in through the door");
+    expect(table.distance(Tile{ 1, 1 }, Tile{ 11, 10 }) == 19, "corner to corner");
+    expect(table.distance(aboveDoor, aboveDoor) == 0 && table.firstStep(aboveDoor, aboveDoor) == Direction::None, "from == to");
+    expect(table.distance(Tile{ -1, 1 }, aboveDoor) == -1 && table.distance(aboveDoor, Tile{ 13, 1 }) == -1 &&
+           table.firstStep(aboveDoor, Tile{ 1, 12 }) == Direction::None, "outside the map");
+
+    // Budget: n * n * 3 bytes fit, one byte less does not, 0 turns it off
+    const std::size_t n = static_cast<std::size_t>(table.nodeCount());
+    const std::size_t exact = n * n * 3;
+    table.setBudget(exact);
+    expect(table.build(masks, Traversal::Ghost, work) && table.ready(), "exact budget");
+    table.setBudget(exact - 1);
+    expect(!table.build(masks, Traversal::Ghost, work) && !table.ready() && table.nodeCount() == 0, "one byte short");
+    expect(table.distance(house, aboveDoor) == -1 && table.firstStep(house, aboveDoor) == Direction::None,
+           "a disabled table answered");
+    table.setBudget(0);
+    expect(!table.build(masks, Traversal::Ghost, work), "budget 0");
+
+    // MonsterSystem without a table: corridor graph, same ghost moves where
+    // shortest paths are unique
+    const MapGrid treeGrid = mazeGrid(tree);
+    const std::vector<Tile> spawns = { Tile{ 6, 5 }, Tile{ 6, 6 }, Tile{ 6, 7 } };
+    MonsterSystem withTable(treeGrid, spawns);
+    MonsterSystem fallback(treeGrid, spawns);
+    fallback.setDistanceTableBudget(0);
+    expect(withTable.hasDistanceTable() && !withTable.hasCorridorGraph(), "MonsterSystem: table within the default budget");
+    expect(!fallback.hasDistanceTable() && fallback.hasCorridorGraph(), "MonsterSystem: corridor graph over budget");
+    const Tile route[] = { Tile{ 1, 8 }, Tile{ 11, 1 }, Tile{ 11, 8 }, Tile{ 3, 8 } };
+    int mismatches = 0;
+    int outside = 0;
+    for (int frame = 0; frame < 1200; ++frame) {
+        MonsterPlayerState player;
+        const Tile at = route[(frame / 150) % 4];
+        player.gridX = at.x;
+        player.gridY = at.y;
+        withTable.setPlayerState(player);
+        fallback.setPlayerState(player);
+        withTable.update(1.0 / 60.0);
+        fallback.update(1.0 / 60.0);
+        const std::vector<GhostRenderInfo> a = withTable.getRenderInfo();
+        const std::vector<GhostRenderInfo> b = fallback.getRenderInfo();
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            mismatches += a[i].gridX != b[i].gridX || a[i].gridY != b[i].gridY || a[i].state != b[i].state;
+            outside += treeGrid.at(a[i].gridX, a[i].gridY) != tile::House;
+        }
+        withTable.pollEvents();
+        fallback.pollEvents();
+    }
+    expect(outside > 1200, "the ghosts stayed in the house");
+    expect(mismatches == 0, std::to_string(mismatches) + " ghost frames differ between table and corridor graph");
+
+    std::cout << "DistanceTable_test: " << (failed == 0 ? "passed" : std::to_string(failed) + " failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+// HouseRoutes_test.cpp
+// The ghost-house exits MonsterSystem stores per level. On a hand-drawn
+// maze with a house under a door, a house with a side opening and a sealed
+// house tile: every house tile with a way out has a route, nothing else
+// does; each route is a legal Ghost-rule walk through house and door tiles
+// that ends on the first tile that is neither, as short as a BFS to the
+// nearest such tile. Known routes (past the door, out of the side opening)
+// are checked tile by tile. The same holds with the distance table, with
+// the corridor graph and with every path engine.
+//
+// Usage: HouseRoutes_test
+
+#include "entities/MonsterSystem.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace game;
+
+namespace {
+
+    int failed = 0;
+
+    void expect(bool ok, const std::string& what) {
+        if (!ok && ++failed <= 10) {
+            std::cerr << "FAIL " << what << std::endl;
+        }
+    }
+
+    std::string at(const Tile& t) { return "(" + std::to_string(t.x) + "," + std::to_string(t.y) + ")"; }
+
+    // House x 6..8, y 3..4 under the door at (7, 2); house (11, 3)-(12, 3)
+    // opening right onto (13, 3); (3, 3) walled in
+    const char* const maze[] = {
+        "#################",
+        "#...............#",
+        "#.#####D#######.#",
+        "#.#G##GGG##GG...#",
+        "#.####GGG####.#.#",
+        "#.....###.......#",
+        "#################",
+    };
+
+    MapGrid mazeGrid() {
+        const int h = static_cast<int>(sizeof(maze) / sizeof(maze[0]));
+        const int w = static_cast<int>(std::string(maze[0]).size());
+        MapGrid grid(w, h);
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                const char c = maze[y][x];
+                grid.at(x, y) = c == '#' ? tile::Wall : c == 'G' ? tile::House : c == 'D' ? tile::Door : tile::Dot;
+            }
+        }
+        return grid;
+    }
+
+    bool houseOrDoor(const MapGrid& grid, const Tile& t) {
+        return grid.at(t.x, t.y) == tile::House || grid.at(t.x, t.y) == tile::Door;
+    }
+
+    // Steps from `from` to the nearest tile that is neither house nor door
+    // under the Ghost rule, -1 if there is none
+    int stepsOut(const MapGrid& grid, const TraversalMasks& masks, const Tile& from) {
+        const int w = grid.width();
+        std::vector<int> dist(grid.size(), -1);
+        std::vector<Tile> queue{ from };
+        dist[grid.index(from.x, from.y)] = 0;
+        const int dx[4] = { 1, 0, -1, 0 };
+        const int dy[4] = { 0, -1, 0, 1 };
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            const Tile t = queue[head];
+            if (!houseOrDoor(grid, t)) return dist[t.y * w + t.x];
+            for (int d = 0; d < 4; ++d) {
+                const Tile n{ t.x + dx[d], t.y + dy[d] };
+                if (masks.canStep(Traversal::Ghost, t.x, t.y, static_cast<Direction>(d)) && dist[n.y * w + n.x] < 0) {
+                    dist[n.y * w + n.x] = dist[t.y * w + t.x] + 1;
+                    queue.push_back(n);
+                }
+            }
+        }
+        return -1;
+    }
+
+    bool legalStep(const TraversalMasks& masks, const Tile& a, const Tile& b) {
+        const int dx = b.x - a.x;
+        const int dy = b.y - a.y;
+        const Direction d = dx == 1 && dy == 0 ? Direction::Right : dx == -1 && dy == 0 ? Direction::Left
+                          : dx == 0 && dy == 1 ? Direction::Down : dx == 0 && dy == -1 ? Direction::Up : Direction::None;
+        return d != Direction::None && masks.canStep(Traversal::Ghost, a.x, a.y, d);
+    }
+
+    void checkRoutes(const MonsterSystem& monsters, const MapGrid& grid, const TraversalMasks& masks,
+                     const std::string& name) {
+        const HouseRoutes& routes = monsters.getHouseRoutes();
+        std::vector<Tile> route;
+        std::size_t withRoute = 0;
+        for (int y = 0; y < grid.height(); ++y) {
+            for (int x = 0; x < grid.width(); ++x) {
+                const Tile from{ x, y };
+                const std::string where = name + " " + at(from);
+                if (grid.at(x, y) != tile::House) {
+                    expect(!routes.has(from) && !routes.route(from, route), where + ": route from outside the house");
+                    continue;
+                }
+                const int want = stepsOut(grid, masks, from);
+                route.clear();
+                const bool has = routes.route(from, route);
+                expect(has == (want > 0) && routes.has(from) == has, where + ": route " + (has ? "where none leads out" : "missing"));
+                if (!has) continue;
+                ++withRoute;
+                expect(static_cast<int>(route.size()) == want, where + ": " + std::to_string(route.size()) +
+                       " steps, " + std::to_string(want) + " to the nearest way out");
+                bool legal = true;
+                Tile cur = from;
+                for (std::size_t k = 0; k < route.size(); ++k) {
+                    legal = legal && legalStep(masks, cur, route[k]) &&
+                            (k + 1 == route.size() || houseOrDoor(grid, route[k]));
+                    cur = route[k];
+                }
+                expect(legal && !houseOrDoor(grid, route.back()), where + ": route is not a walk out of the house");
+            }
+        }
+        expect(withRoute == 8 && routes.routeCount() == 8, name + ": " + std::to_string(routes.routeCount()) + " routes");
+
+        // Known routes: through the door and one past it; the side opening
+        const Tile underDoor{ 7, 3 };
+        expect(routes.route(underDoor, route) && route == std::vector<Tile>{ Tile{ 7, 2 }, Tile{ 7, 1 } },
+               name + ": route under the door does not go past it");
+        expect(routes.route(Tile{ 6, 4 }, route) && route.size() == 4 && route[2] == Tile{ 7, 2 },
+               name + ": route from the house corner");
+        expect(routes.route(Tile{ 12, 3 }, route) && route == std::vector<Tile>{ Tile{ 13, 3 } },
+               name + ": side opening");
+        expect(routes.route(Tile{ 11, 3 }, route) && route == std::vector<Tile>{ Tile{ 12, 3 }, Tile{ 13, 3 } },
+               name + ": side opening, one tile in");
+        expect(!routes.has(Tile{ 3, 3 }), name + ": route out of the walled-in tile");
+    }
+
+}
+
+int main() {
+    const MapGrid grid = mazeGrid();
+    TraversalMasks masks;
+    masks.build(grid);
+    const std::vector<Tile> spawns = { Tile{ 7, 3 }, Tile{ 12, 3 }, Tile{ 6, 4 } };
+
+    MonsterSystem monsters(grid, spawns);
+    expect(monsters.hasDistanceTable(), "distance table within the default budget");
+    checkRoutes(monsters, grid, masks, "table");
+
+    monsters.setDistanceTableBudget(0);
+    expect(monsters.hasCorridorGraph(), "corridor graph without a table");
+    const PathAlgorithm algorithms[] = { PathAlgorithm::BFS, PathAlgorithm::AStar, PathAlgorithm::JumpPoint };
+    for (PathAlgorithm algorithm : algorithms) {
+        monsters.setPathAlgorithm(algorithm);
+        checkRoutes(monsters, grid, masks, std::string("graph ") + pathAlgorithmName(algorithm));
+    }
+
+    // A new level on the same map keeps them
+    monsters.startLevel(spawns);
+    checkRoutes(monsters, grid, masks, "after startLevel()");
+
+    std::cout << "HouseRoutes_test: " << (failed == 0 ? "passed" : std::to_string(failed) + " failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+}
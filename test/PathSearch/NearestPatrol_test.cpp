@@ -0,0 +1,181 @@
+// NearestPatrol_test.cpp
+// How a ghost finds its way back to its patrol loop. PatrolLookup maps each
+// loop tile to the index of its first visit and every other tile, inside
+// the loop's bounding box or not, to -1. PathEngine::searchNearest() with
+// that lookup as the rank gives, for every engine and every start tile, the
+// distance to the closest loop tile other than start (at most maxLength
+// steps) and, among the closest, the one earliest in the loop: the answer
+// MonsterSystem gets from one distance query per loop tile when it has a
+// distance table. Checked against per-tile BFS searches on a hand-drawn
+// maze with a ghost house, for several loops and ranges.
+//
+// Usage: NearestPatrol_test
+
+#include "entities/MonsterSystem.hpp"
+#include "entities/PathEngine.hpp"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace game;
+
+namespace {
+
+    int failed = 0;
+
+    void expect(bool ok, const std::string& what) {
+        if (!ok && ++failed <= 10) {
+            std::cerr << "FAIL " << what << std::endl;
+        }
+    }
+
+    std::string at(const Tile& t) { return "(" + std::to_string(t.x) + "," + std::to_string(t.y) + ")"; }
+
+    // A loop round an open block on the left, an open area on the right,
+    // a long corridor along the bottom, ghost house under the door at (10, 3)
+    const char* const maze[] = {
+        "################",
+        "#......#.......#",
+        "#.####.#.#.###.#",
+        "#.#..#...#D#...#",
+        "#.#..#.#.#G##..#",
+        "#......#.#GG#..#",
+        "#.##.#########.#",
+        "#..............#",
+        "################",
+    };
+
+    MapGrid mazeGrid() {
+        const int h = static_cast<int>(sizeof(maze) / sizeof(maze[0]));
+        const int w = static_cast<int>(std::string(maze[0]).size());
+        MapGrid grid(w, h);
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                const char c = maze[y][x];
+                grid.at(x, y) = c == '#' ? tile::Wall : c == 'G' ? tile::House : c == 'D' ? tile::Door : tile::Dot;
+            }
+        }
+        return grid;
+    }
+
+    // What the distance-table branch computes: one search per loop tile,
+    // the first strictly closer one kept
+    int nearestByLoop(PathEngine& bfs, const TraversalMasks& masks, const Tile& start,
+                      const std::vector<Tile>& loop, int maxLength, Tile* found) {
+        int best = -1;
+        for (const Tile& t : loop) {
+            if (t == start) continue;
+            const int d = bfs.search(masks, Traversal::Ghost, start, t, maxLength, nullptr);
+            if (d >= 0 && (best < 0 || d < best)) {
+                best = d;
+                *found = t;
+            }
+        }
+        return best;
+    }
+
+    void checkLookup() {
+        // A loop that passes (3, 1) twice, as patrol loops round a block do
+        const std::vector<Tile> loop = { Tile{ 1, 1 }, Tile{ 2, 1 }, Tile{ 3, 1 }, Tile{ 4, 1 }, Tile{ 3, 1 },
+                                         Tile{ 3, 2 }, Tile{ 3, 3 }, Tile{ 2, 3 } };
+        PatrolLookup lookup;
+        expect(!lookup.built && lookup.indexOf(Tile{ 0, 0 }) == -1, "lookup: fresh lookup answered");
+        lookup.assign(loop);
+        expect(lookup.built && lookup.w == 4 && lookup.h == 3, "lookup: bounding box");
+        const int want[] = { 0, 1, 2, 3, 2, 5, 6, 7 };
+        for (std::size_t k = 0; k < loop.size(); ++k) {
+            expect(lookup.indexOf(loop[k]) == want[k], "lookup: " + at(loop[k]) + " index " +
+                   std::to_string(lookup.indexOf(loop[k])));
+        }
+        const Tile off[] = { Tile{ 1, 2 }, Tile{ 4, 3 }, Tile{ 0, 1 }, Tile{ 5, 1 }, Tile{ 1, 0 }, Tile{ 1, 4 },
+                             Tile{ -1, -1 }, Tile{ 1000, 2 } };
+        for (const Tile& t : off) {
+            expect(lookup.indexOf(t) == -1, "lookup: " + at(t) + " is not on the loop");
+        }
+
+        // Stale until reassigned; a new loop forgets the old one
+        lookup.invalidate();
+        expect(!lookup.built, "lookup: invalidate()");
+        lookup.assign({ Tile{ 10, 7 }, Tile{ 11, 7 } });
+        expect(lookup.indexOf(Tile{ 11, 7 }) == 1 && lookup.indexOf(Tile{ 1, 1 }) == -1 && lookup.w == 2 && lookup.h == 1,
+               "lookup: reassigned");
+        lookup.assign({});
+        expect(lookup.built && lookup.indexOf(Tile{ 10, 7 }) == -1 && lookup.indexOf(Tile{ 0, 0 }) == -1,
+               "lookup: empty loop");
+    }
+
+}
+
+int main() {
+    checkLookup();
+
+    const MapGrid grid = mazeGrid();
+    TraversalMasks masks;
+    masks.build(grid);
+    std::unique_ptr<PathEngine> bfs = makePathEngine(PathAlgorithm::BFS);
+
+    // Loops: round the left-hand block, through the right-hand open area,
+    // along the bottom corridor, one tile in the house (only reachable from
+    // inside)
+    const std::vector<std::vector<Tile>> loops = {
+        { Tile{ 1, 1 }, Tile{ 2, 1 }, Tile{ 3, 1 }, Tile{ 4, 1 }, Tile{ 5, 1 }, Tile{ 6, 1 }, Tile{ 6, 2 }, Tile{ 6, 3 },
+          Tile{ 6, 4 }, Tile{ 6, 5 }, Tile{ 5, 5 }, Tile{ 4, 5 }, Tile{ 3, 5 }, Tile{ 2, 5 }, Tile{ 1, 5 }, Tile{ 1, 4 },
+          Tile{ 1, 3 }, Tile{ 1, 2 } },
+        { Tile{ 13, 3 }, Tile{ 14, 3 }, Tile{ 14, 4 }, Tile{ 14, 5 }, Tile{ 13, 5 }, Tile{ 13, 4 } },
+        { Tile{ 14, 7 }, Tile{ 1, 7 }, Tile{ 7, 7 }, Tile{ 7, 7 } },
+        { Tile{ 11, 5 } },
+    };
+    const PathAlgorithm algorithms[] = { PathAlgorithm::BFS, PathAlgorithm::AStar, PathAlgorithm::JumpPoint };
+    const int ranges[] = { 9999, 6, 1 };
+
+    for (std::size_t l = 0; l < loops.size(); ++l) {
+        PatrolLookup lookup;
+        lookup.assign(loops[l]);
+        auto rank = [&lookup](const Tile& t) { return lookup.indexOf(t); };
+        for (PathAlgorithm algorithm : algorithms) {
+            std::unique_ptr<PathEngine> engine = makePathEngine(algorithm);
+            for (int range : ranges) {
+                for (int y = 0; y < grid.height(); ++y) {
+                    for (int x = 0; x < grid.width(); ++x) {
+                        if (grid.at(x, y) == tile::Wall) continue;
+                        const Tile start{ x, y };
+                        const std::string what = std::string(pathAlgorithmName(algorithm)) + " loop " + std::to_string(l) +
+                                                 " range " + std::to_string(range) + " from " + at(start);
+                        Tile want = start;
+                        const int wantDist = nearestByLoop(*bfs, masks, start, loops[l], range, &want);
+                        Tile found = start;
+                        const int dist = engine->searchNearest(masks, Traversal::Ghost, start, range, rank, &found);
+                        expect(dist == wantDist, what + ": distance " + std::to_string(dist) + ", want " +
+                               std::to_string(wantDist));
+                        expect(found == want, what + ": found " + at(found) + ", want " + at(want));
+                    }
+                }
+            }
+        }
+    }
+
+    // Known answers: ties go to the earlier loop tile; the start itself
+    // never counts; the house is one-way
+    PatrolLookup bottom;
+    bottom.assign(loops[2]);
+    Tile found{ -1, -1 };
+    expect(bfs->searchNearest(masks, Traversal::Ghost, Tile{ 4, 7 }, 9999,
+                              [&bottom](const Tile& t) { return bottom.indexOf(t); }, &found) == 3 &&
+           found == Tile{ 1, 7 }, "tie between (1, 7) and (7, 7) goes to the earlier");
+    expect(bfs->searchNearest(masks, Traversal::Ghost, Tile{ 7, 7 }, 9999,
+                              [&bottom](const Tile& t) { return bottom.indexOf(t); }, &found) == 6 &&
+           found == Tile{ 1, 7 }, "start on the loop does not count");
+    PatrolLookup house;
+    house.assign(loops[3]);
+    found = Tile{ -1, -1 };
+    expect(bfs->searchNearest(masks, Traversal::Ghost, Tile{ 10, 2 }, 9999,
+                              [&house](const Tile& t) { return house.indexOf(t); }, &found) == -1 &&
+           found == Tile{ -1, -1 }, "house tile reached from outside");
+    expect(bfs->searchNearest(masks, Traversal::Ghost, Tile{ 10, 4 }, 9999,
+                              [&house](const Tile& t) { return house.indexOf(t); }, &found) == 2 &&
+           found == Tile{ 11, 5 }, "house tile from inside");
+
+    std::cout << "NearestPatrol_test: " << (failed == 0 ? "passed" : std::to_string(failed) + " failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+// PathEngine_test.cpp
+// The BFS, A* and Jump Point engines against each other on seeded random
+// grids: the same length for every query and cut-off, every returned path
+// a legal walk of that length, and sane PathStats (JumpPoint's scanned
+// tiles include its jumps).
+//
+// Usage: PathEngine_test [seed]
+
+#include "PathFixtures.hpp"
+#include "entities/PathEngine.hpp"
+#include <cstdlib>
+#include <limits>
+#include <memory>
+
+using namespace game;
+using namespace pathtest;
+
+namespace {
+
+    struct Case {
+        const char* name;
+        int width;
+        int height;
+        double walls;
+        int houses;
+        int queries;
+    };
+
+    const Case cases[] = {
+        { "small mixed", 40,  30, 0.30, 1, 150 },
+        { "corridors",   64,  64, 0.34, 2, 150 },
+        { "open rooms",  80,  60, 0.05, 3, 150 },
+        { "empty",       96,  96, 0.00, 0, 100 },
+        { "large",      160, 160, 0.25, 6,  50 },
+    };
+
+    const PathAlgorithm others[] = { PathAlgorithm::AStar, PathAlgorithm::JumpPoint };
+
+    void runCase(const Case& c, Traversal who, std::uint64_t seed, Failures& failures) {
+        std::mt19937_64 rng(seed);
+        const MapGrid grid = randomGrid(rng, c.width, c.height, c.walls, c.houses);
+        TraversalMasks masks;
+        masks.build(grid);
+        const std::string where = std::string(c.name) + " seed " + std::to_string(seed) +
+                                  (who == Traversal::Player ? " player" : " ghost");
+
+        auto bfs = makePathEngine(PathAlgorithm::BFS);
+        std::unique_ptr<PathEngine> engines[2] = { makePathEngine(others[0]), makePathEngine(others[1]) };
+        std::vector<Tile> path;
+        const int unlimited = std::numeric_limits<int>::max();
+        int routed = 0;
+
+        for (int q = 0; q < c.queries; ++q) {
+            const Tile start = randomOpenTile(rng, masks, who);
+            const Tile goal = (q % 10 == 0) ? start : randomOpenTile(rng, masks, who);
+
+            const int full = bfs->search(masks, who, start, goal, unlimited, &path);
+            const std::string pair = where + ": " + tileText(start) + " -> " + tileText(goal);
+            if (full >= 0) {
+                ++routed;
+                failures.check(validPath(masks, who, start, goal, path, full), pair + ": invalid bfs path");
+            }
+
+            // Unbounded, exactly long enough, one short, and a random cut-off
+            std::vector<int> limits = { unlimited };
+            if (full >= 0) {
+                limits.push_back(full);
+                limits.push_back(full - 1);
+                limits.push_back(static_cast<int>(rng() % static_cast<std::uint64_t>(2 * full + 2)));
+            }
+
+            for (int maxLength : limits) {
+                if (maxLength < 0) continue;
+                const int want = bfs->search(masks, who, start, goal, maxLength, nullptr);
+                for (auto& engine : engines) {
+                    const std::string query = pair + " max " + std::to_string(maxLength) + " " +
+                                              pathAlgorithmName(engine->algorithm());
+                    const int got = engine->search(masks, who, start, goal, maxLength, &path);
+                    failures.check(got == want, query + ": " + std::to_string(got) +
+                                                ", bfs " + std::to_string(want));
+                    if (got >= 0) {
+                        failures.check(validPath(masks, who, start, goal, path, got), query + ": invalid path");
+                    } else {
+                        failures.check(path.empty(), query + ": path not cleared");
+                    }
+                    const PathStats& stats = engine->stats();
+                    failures.check(stats.lastScanned >= stats.lastExpanded,
+                                   query + ": scanned " + std::to_string(stats.lastScanned) +
+                                   " < expanded " + std::to_string(stats.lastExpanded));
+                }
+            }
+        }
+        failures.check(routed > c.queries / 8, where + ": only " + std::to_string(routed) + " routed queries");
+
+        // Totals: BFS and A* read only the tiles they expand; JumpPoint's
+        // jumps read more tiles than it expands
+        failures.check(bfs->stats().scanned == bfs->stats().expanded, where + ": bfs scanned != expanded");
+        failures.check(engines[0]->stats().scanned == engines[0]->stats().expanded,
+                       where + ": astar scanned != expanded");
+        if (routed > 0) {
+            failures.check(engines[1]->stats().scanned > engines[1]->stats().expanded,
+                           where + ": jps scanned " + std::to_string(engines[1]->stats().scanned) +
+                           ", expanded " + std::to_string(engines[1]->stats().expanded));
+        }
+    }
+
+}
+
+int main(int argc, char** argv) {
+    const std::uint64_t seed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1;
+
+    Failures failures;
+    for (const Case& c : cases) {
+        for (std::uint64_t s = seed; s < seed + 3; ++s) {
+            runCase(c, Traversal::Player, s, failures);
+            runCase(c, Traversal::Ghost, s, failures);
+        }
+    }
+    return failures.finish("PathEngine_test");
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+// Shared pieces of the path search tests: seeded random grids, random open
+// tiles, a path checker and a failure counter.
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "common/CommonTypes.hpp"
+#include "common/Traversal.hpp"
+
+namespace pathtest {
+
+    using namespace game;
+
+    // Walls all round; inside, each tile is a wall with probability `walls`,
+    // else a path, dot or pellet. `houses` 4x3 ghost houses, each with a
+    // door in its top wall, are stamped in at random so the ghost rules
+    // (one-way doors, house tiles) get exercised too.
+    inline MapGrid randomGrid(std::mt19937_64& rng, int w, int h, double walls, int houses) {
+        MapGrid grid(w, h, tile::Wall);
+        std::uniform_real_distribution<double> roll(0.0, 1.0);
+        for (int y = 1; y < h - 1; ++y) {
+            for (int x = 1; x < w - 1; ++x) {
+                const double r = roll(rng);
+                grid.at(x, y) = r < walls ? tile::Wall
+                              : r < walls + 0.05 ? tile::Pellet
+                              : r < 0.6 ? tile::Path : tile::Dot;
+            }
+        }
+        for (int k = 0; k < houses && w > 8 && h > 7; ++k) {
+            const int hx = 1 + static_cast<int>(rng() % static_cast<std::uint64_t>(w - 7));
+            const int hy = 1 + static_cast<int>(rng() % static_cast<std::uint64_t>(h - 6));
+            for (int y = hy; y < hy + 5; ++y) {
+                for (int x = hx; x < hx + 6; ++x) {
+                    const bool edge = y == hy || y == hy + 4 || x == hx || x == hx + 5;
+                    grid.at(x, y) = edge ? tile::Wall : tile::House;
+                }
+            }
+            grid.at(hx + 2, hy) = tile::Door;
+        }
+        return grid;
+    }
+
+    // A uniformly random tile `who` can leave, or {-1, -1} after many misses
+    inline Tile randomOpenTile(std::mt19937_64& rng, const TraversalMasks& masks, Traversal who) {
+        const std::uint8_t* exits = masks.data(who);
+        for (int attempt = 0; attempt < 10000; ++attempt) {
+            const int x = static_cast<int>(rng() % static_cast<std::uint64_t>(masks.width()));
+            const int y = static_cast<int>(rng() % static_cast<std::uint64_t>(masks.height()));
+            if (exits[y * masks.width() + x] != 0) return Tile{ x, y };
+        }
+        return Tile{ -1, -1 };
+    }
+
+    // True if `path` (the tiles after start, up to and including goal) is
+    // `length` legal steps for `who`
+    inline bool validPath(const TraversalMasks& masks, Traversal who, const Tile& start,
+                          const Tile& goal, const std::vector<Tile>& path, int length) {
+        if (static_cast<int>(path.size()) != length) return false;
+        if (length == 0) return start == goal;
+        Tile at = start;
+        for (const Tile& next : path) {
+            const int dx = next.x - at.x;
+            const int dy = next.y - at.y;
+            const Direction dir = dx == 1 && dy == 0 ? Direction::Right
+                                : dx == -1 && dy == 0 ? Direction::Left
+                                : dx == 0 && dy == 1 ? Direction::Down
+                                : dx == 0 && dy == -1 ? Direction::Up
+                                : Direction::None;
+            if (!masks.canStep(who, at.x, at.y, dir)) return false;
+            at = next;
+        }
+        return at == goal;
+    }
+
+    inline std::string tileText(const Tile& t) {
+        return "(" + std::to_string(t.x) + "," + std::to_string(t.y) + ")";
+    }
+
+    // Counts failed checks and prints the first few
+    struct Failures {
+        int count = 0;
+        int checks = 0;
+
+        void check(bool ok, const std::string& what) {
+            ++checks;
+            if (ok) return;
+            if (++count <= 10) std::cerr << "FAIL " << what << std::endl;
+        }
+
+        // Summary line; the process exit code
+        int finish(const char* name) const {
+            std::cout << name << ": " << checks << " checks, " << count << " failed" << std::endl;
+            return count == 0 ? 0 : 1;
+        }
+    };
+
+}
@@ -14,30 +14,30 @@ static MapGrid createMap()
     const int H = 5;
     const int W = 12;
 
-    MapGrid m(H, std::vector<int>(W, 1)); // 1 = wall everywhere
+    MapGrid m(W, H, tile::Wall); // 1 = wall everywhere
 
     // Open a single horizontal corridor at y = 2
     for (int x = 1; x < W - 1; ++x)
     {
-        m[2][x] = 0; // 0 = path
+        m.at(x, 2) = tile::Path; // 0 = path
     }
 
     // Place items on the corridor:
     // 2 dots and 1 power pellet, all on the player's path.
-    m[2][3] = 3; // dot 1
-    m[2][5] = 3; // dot 2
-    m[2][7] = 4; // power pellet
+    m.at(3, 2) = tile::Dot;    // dot 1
+    m.at(5, 2) = tile::Dot;    // dot 2
+    m.at(7, 2) = tile::Pellet; // power pellet
 
     return m;
 }
 
 
 static void draw(const MapGrid &m,
-                 const PlayerRenderInfo &info,
+                 const PlayerControllerRenderInfo &info,
                  const Tile &monsterPos)
 {
-    int H = (int)m.size();
-    int W = (int)m[0].size();
+    int H = m.height();
+    int W = m.width();
 
     // Clear console
     std::cout << "\x1b[2J\x1b[H";
@@ -47,7 +47,7 @@ static void draw(const MapGrid &m,
         for (int x = 0; x < W; ++x)
         {
             char ch = ' ';
-            int cell = m[y][x];
+            int cell = m.at(x, y);
 
             if (cell == 1)      ch = '#'; // wall
             else if (cell == 3) ch = '.'; // dot
@@ -99,18 +99,14 @@ int main()
 
         player.update(DT, in);
         PlayerEvents ev = player.pollEvents();
-        PlayerRenderInfo info = player.getRenderInfo();
+        PlayerControllerRenderInfo info = player.getRenderInfo();
 
         // Remove collected items from the visual map
         if (ev.dotCollected || ev.powerPelletCollected)
         {
             int gx = info.gridX;
             int gy = info.gridY;
-            if (gy >= 0 && gy < (int)map.size() &&
-                gx >= 0 && gx < (int)map[0].size())
-            {
-                map[gy][gx] = 0;
-            }
+            map.set(gx, gy, tile::Path);
         }
 
         //Decide whether to force a collision this frame
@@ -142,7 +138,7 @@ int main()
         {
             // Simple horizontal wander between x=2 and x=W-3
             int nx = monsterPos.x + monsterDirX;
-            if (nx <= 2 || nx >= (int)map[0].size() - 3 || map[2][nx] == 1)
+            if (nx <= 2 || nx >= map.width() - 3 || map.at(nx, 2) == tile::Wall)
             {
                 monsterDirX = -monsterDirX;
                 nx = monsterPos.x + monsterDirX;
@@ -154,7 +150,7 @@ int main()
         bool hit = player.checkMonsterCollision(monsterPos);
         (void)hit;
         PlayerEvents ev2 = player.pollEvents();
-        PlayerRenderInfo info2 = player.getRenderInfo();
+        PlayerControllerRenderInfo info2 = player.getRenderInfo();
 
         draw(map, info2, monsterPos);
 
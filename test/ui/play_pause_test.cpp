@@ -32,20 +32,20 @@ int main()
     // rows x cols, border walls + some internal walls
     const int rows = 15;
     const int cols = 20;
-    MapGrid map(rows, std::vector<int>(cols, 0));
+    MapGrid map(cols, rows, tile::Path);
     for (int r = 0; r < rows; ++r) {
         for (int c = 0; c < cols; ++c) {
             if (r == 0 || r == rows - 1 || c == 0 || c == cols - 1)
-                map[r][c] = 1; // wall
+                map.at(c, r) = 1; // wall
             else
-                map[r][c] = 0; // path
+                map.at(c, r) = 0; // path
         }
     }
 
     for (int r = 2; r < rows - 2; r += 3) {
         for (int c = 2; c < cols - 2; c += 4) {
-            map[r][c] = 1;
-            if (c + 1 < cols - 1) map[r][c + 1] = 1;
+            map.at(c, r) = 1;
+            if (c + 1 < cols - 1) map.at(c + 1, r) = 1;
         }
     }
 
@@ -54,7 +54,7 @@ int main()
     for (int r = centerR - 1; r <= centerR + 1; ++r) {
         for (int c = centerC - 4; c <= centerC + 2; ++c) {
             if (r > 0 && r < rows - 1 && c > 0 && c < cols - 1) {
-                map[r][c] = 2; // monster room
+                map.at(c, r) = 2; // monster room
             }
         }
     }
@@ -62,15 +62,15 @@ int main()
     // 3 = dot, 4 = energy (power pellet)
     for (int r = 1; r < rows - 1; ++r) {
         for (int c = 1; c < cols - 1; ++c) {
-            if (map[r][c] == 0) {
-                map[r][c] = 3;
+            if (map.at(c, r) == 0) {
+                map.at(c, r) = 3;
             }
         }
     }
-    map[1][1] = 4;
-    map[1][cols - 2] = 4;
-    map[rows - 2][1] = 4;
-    map[rows - 2][cols - 2] = 4;
+    map.at(1, 1) = 4;
+    map.at(cols - 2, 1) = 4;
+    map.at(1, rows - 2) = 4;
+    map.at(cols - 2, rows - 2) = 4;
 
     auto state = GameScreenState::Play;
     // Main loop: render Play screen; ESC to exit
@@ -0,0 +1,287 @@
+// headless_sim.cpp
+// Play whole games with no window, as fast as possible: level loads, a
+// scripted player, ghosts, pickups, deaths and level changes, advanced
+// through the same GameSession::step() as the Play state of main.cpp.
+//
+// Usage:
+//     headless_sim [episodes] [seed] [maxTicks] [levels] [threads] [player]
+//
+// `levels` is a .pack file or a directory of .lvl files (default: the
+// game's own assets/levels/levels.pack, else assets/levels, else the
+// built-in maps). `player` is "greedy" (default: heads for the nearest
+// dot, steering clear of ghosts) or "random" (a seeded random walk).
+// Episode e uses seed + e, so a run is reproducible.
+#include "map/MapSystem.h"
+#include "core/GameSession.hpp"
+#include "common/SimulationClock.hpp"
+#include "common/Traversal.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace game;
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    enum class Outcome { Won, GameOver, TimedOut };
+    enum class PlayerKind { Greedy, Random };
+
+    struct EpisodeResult {
+        Outcome outcome = Outcome::TimedOut;
+        std::uint64_t ticks = 0;
+        int score = 0;
+        int levelsCleared = 0;
+        int deaths = 0;         // lives lost
+    };
+
+    double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    PlayerInput arrowFor(Direction dir) {
+        PlayerInput input;
+        input.rightPressed = dir == Direction::Right;
+        input.upPressed = dir == Direction::Up;
+        input.leftPressed = dir == Direction::Left;
+        input.downPressed = dir == Direction::Down;
+        return input;
+    }
+
+    // Random-walk input: a new arrow every `period` ticks, or as soon as the
+    // player has been stuck on one tile for a few ticks
+    class RandomWalker {
+    public:
+        RandomWalker(std::uint64_t seed, int period) : rng(seed), period(period) {}
+
+        PlayerInput next(const GameSession& session) {
+            const Tile position = session.player().getPosition();
+            stuck = (position == last) ? stuck + 1 : 0;
+            last = position;
+            if (--untilChange <= 0 || stuck > 8) {
+                held = static_cast<Direction>(rng() % 4);
+                untilChange = period;
+                stuck = 0;
+            }
+            return arrowFor(held);
+        }
+
+    private:
+        std::mt19937_64 rng;
+        int period;
+        int untilChange = 0;
+        Direction held = Direction::Right;
+        int stuck = 0;
+        Tile last{ -1, -1 };
+    };
+
+    // Goal-directed input: a BFS over the player's legal moves to the
+    // nearest dot or pellet that never enters a tile on or next to a ghost
+    // (unless powered). With no safe route to a dot it keeps moving through
+    // safe tiles, and with no safe step at all it holds its last arrow.
+    class GreedyPlayer {
+    public:
+        explicit GreedyPlayer(std::uint64_t seed) : rng(seed) {}
+
+        PlayerInput next(const GameSession& session, const MapGrid& grid) {
+            if (session.level() != maskLevel) {
+                // The layout only changes with the level here
+                masks.build(grid);
+                maskLevel = session.level();
+                stamp.assign(grid.size(), 0);
+                firstStep.assign(grid.size(), Direction::None);
+                queue.assign(grid.size(), 0);
+                current = 0;
+            }
+            ++current;
+
+            const int w = grid.width();
+            const Tile from = session.player().getPosition();
+            const bool powered = session.player().isPowered();
+            const OccupancyIndex& ghosts = session.monsters().getOccupancy();
+            auto unsafe = [&](const Tile& t) {
+                if (powered) return false;
+                bool near = false;
+                ghosts.forEachAround(t, [&](int, const Tile&) { near = true; });
+                return near;
+            };
+
+            const std::uint8_t* exits = masks.data(Traversal::Player);
+            std::size_t head = 0, tail = 0;
+            std::vector<Direction> safeSteps;
+            stamp[static_cast<std::size_t>(grid.index(from.x, from.y))] = current;
+            for (int d = 0; d < 4; ++d) {
+                const Direction dir = static_cast<Direction>(d);
+                if (!hasExit(exits[grid.index(from.x, from.y)], dir)) continue;
+                const Tile n{ from.x + dx[d], from.y + dy[d] };
+                if (unsafe(n)) continue;
+                const int cell = grid.index(n.x, n.y);
+                stamp[static_cast<std::size_t>(cell)] = current;
+                firstStep[static_cast<std::size_t>(cell)] = dir;
+                queue[tail++] = cell;
+                safeSteps.push_back(dir);
+            }
+
+            while (head < tail) {
+                const int cur = queue[head++];
+                const Tile t{ cur % w, cur / w };
+                const std::uint8_t code = grid.at(t.x, t.y);
+                if (code == tile::Dot || code == tile::Pellet) {
+                    held = firstStep[static_cast<std::size_t>(cur)];
+                    return arrowFor(held);
+                }
+                for (int d = 0; d < 4; ++d) {
+                    if (!hasExit(exits[cur], static_cast<Direction>(d))) continue;
+                    const Tile n{ t.x + dx[d], t.y + dy[d] };
+                    const int cell = grid.index(n.x, n.y);
+                    if (stamp[static_cast<std::size_t>(cell)] == current || unsafe(n)) continue;
+                    stamp[static_cast<std::size_t>(cell)] = current;
+                    firstStep[static_cast<std::size_t>(cell)] = firstStep[static_cast<std::size_t>(cur)];
+                    queue[tail++] = cell;
+                }
+            }
+
+            // Every dot is cut off by ghosts: keep going if that is still
+            // safe, else take any safe step and wait for the way to clear
+            bool heldSafe = false;
+            for (Direction dir : safeSteps) heldSafe = heldSafe || dir == held;
+            if (!heldSafe && !safeSteps.empty()) {
+                held = safeSteps[rng() % safeSteps.size()];
+            }
+            return arrowFor(held);
+        }
+
+    private:
+        static constexpr int dx[4] = { 1, 0, -1, 0 };   // Right, Up, Left, Down
+        static constexpr int dy[4] = { 0, -1, 0, 1 };
+
+        std::mt19937_64 rng;
+        TraversalMasks masks;
+        int maskLevel = -1;
+        std::vector<std::uint32_t> stamp;   // == current: tile queued in this search
+        std::uint32_t current = 0;
+        std::vector<Direction> firstStep;   // the player's first move towards the tile
+        std::vector<int> queue;
+        Direction held = Direction::None;
+    };
+
+    EpisodeResult runEpisode(MapSystem& mapSystem, std::uint64_t seed, std::uint64_t maxTicks,
+                             unsigned threads, PlayerKind kind, GameSession::PhaseTimes& times) {
+        EpisodeResult result;
+        const double dt = SimulationClock().tickSeconds();
+
+        auto start = Clock::now();
+        mapSystem.loadLevel(1);
+        GameSession session(mapSystem, 1);
+        session.setVerbose(false);
+        session.setProfile(&times);
+        session.monsters().setWorkerThreads(threads);
+        times.levelLoad += secondsSince(start);
+
+        RandomWalker walker(seed, 20);
+        GreedyPlayer greedy(seed);
+        GameSession::Status status = GameSession::Status::Playing;
+        while (status == GameSession::Status::Playing && result.ticks < maxTicks) {
+            ++result.ticks;
+            const int livesBefore = session.player().getLives();
+            const PlayerInput input = kind == PlayerKind::Greedy
+                ? greedy.next(session, mapSystem.getMapGrid())
+                : walker.next(session);
+            status = session.step(dt, input);
+            result.deaths += livesBefore - session.player().getLives();
+        }
+
+        if (status == GameSession::Status::Won) {
+            result.outcome = Outcome::Won;
+        } else if (status == GameSession::Status::GameOver) {
+            result.outcome = Outcome::GameOver;
+        }
+        // step() moves to the next level as soon as one is cleared, even on
+        // the tick the last life is lost
+        result.levelsCleared = session.level() - 1;
+        result.score = session.player().getScore();
+        return result;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    int episodes = 10;
+    std::uint64_t seed = 1;
+    std::uint64_t maxTicks = 60ull * 60 * 10;    // ten simulated minutes at 60 Hz
+    std::string levels;
+    unsigned threads = 1;
+    PlayerKind kind = PlayerKind::Greedy;
+    bool usage = false;
+    if (argc > 1) episodes = std::atoi(argv[1]);
+    if (argc > 2) seed = std::strtoull(argv[2], nullptr, 10);
+    if (argc > 3) maxTicks = std::strtoull(argv[3], nullptr, 10);
+    if (argc > 4) levels = argv[4];
+    if (argc > 5) threads = static_cast<unsigned>(std::atoi(argv[5]));
+    if (argc > 6) {
+        const std::string player = argv[6];
+        if (player == "random") kind = PlayerKind::Random;
+        else if (player != "greedy") usage = true;
+    }
+    if (usage || episodes <= 0 || maxTicks == 0) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [episodes] [seed] [maxTicks] [levels.pack|levelDir] [threads] [greedy|random]" << std::endl;
+        return 1;
+    }
+
+    MapSystem mapSystem;
+    mapSystem.setVerbose(false);
+    if (levels.empty()) {
+        if (mapSystem.loadLevelPack("assets/levels/levels.pack") == 0) {
+            mapSystem.loadLevelDirectory("assets/levels");
+        }
+    } else if (mapSystem.loadLevelPack(levels) == 0 && mapSystem.loadLevelDirectory(levels) == 0) {
+        std::cerr << "Error: no levels in " << levels << std::endl;
+        return 1;
+    }
+
+    GameSession::PhaseTimes times;
+    std::uint64_t totalTicks = 0;
+    int outcomes[3] = { 0, 0, 0 };
+    double scoreSum = 0.0;
+    double levelSum = 0.0;
+    double deathSum = 0.0;
+    const auto runStart = Clock::now();
+
+    for (int e = 0; e < episodes; ++e) {
+        EpisodeResult r = runEpisode(mapSystem, seed + static_cast<std::uint64_t>(e), maxTicks, threads, kind, times);
+        totalTicks += r.ticks;
+        ++outcomes[static_cast<int>(r.outcome)];
+        scoreSum += r.score;
+        levelSum += r.levelsCleared;
+        deathSum += r.deaths;
+
+        static const char* names[] = { "won", "game over", "timed out" };
+        std::cout << "episode " << e << ": " << names[static_cast<int>(r.outcome)]
+                  << ", score " << r.score << ", levels " << r.levelsCleared
+                  << ", deaths " << r.deaths << ", ticks " << r.ticks << std::endl;
+    }
+
+    const double wall = secondsSince(runStart);
+    const double n = static_cast<double>(episodes);
+    std::cout << std::fixed << std::setprecision(3)
+              << "\n" << episodes << " episodes, " << totalTicks << " ticks in " << wall << " s ("
+              << std::setprecision(0) << (wall > 0.0 ? totalTicks / wall : 0.0) << " ticks/s)\n"
+              << std::setprecision(3)
+              << "  player     " << times.player << " s\n"
+              << "  monsters   " << times.monsters << " s\n"
+              << "  rules      " << times.rules << " s\n"
+              << "  level load " << times.levelLoad << " s\n"
+              << "outcomes: " << outcomes[0] << " won, " << outcomes[1] << " game over, "
+              << outcomes[2] << " timed out\n"
+              << std::setprecision(1)
+              << "mean score " << scoreSum / n << ", mean levels " << levelSum / n
+              << ", mean deaths " << deathSum / n << std::endl;
+    return 0;
+}
@@ -0,0 +1,69 @@
+// levelpack_compiler.cpp
+// Offline compiler: .lvl text levels -> binary level pack (see map/LevelPack.h)
+//
+// Usage:
+//     levelpack_compiler <out.pack> <level.lvl | directory>...
+//
+// Directories contribute every *.lvl file they contain, ordered by file name.
+// Levels are packed in command-line order.
+#include "map/LevelLoader.h"
+#include "map/LevelPack.h"
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <out.pack> <level.lvl | directory>..." << std::endl;
+        return 1;
+    }
+
+    std::vector<LevelData> levels;
+    bool ok = true;
+    for (int i = 2; i < argc; ++i) {
+        const std::string input = argv[i];
+        if (std::filesystem::is_directory(input)) {
+            std::vector<std::string> errors;
+            std::vector<LevelData> dirLevels = LevelLoader::loadLevelDirectory(input, &errors);
+            for (const auto& error : errors) {
+                std::cerr << "Error: " << error << std::endl;
+                ok = false;
+            }
+            for (auto& level : dirLevels) {
+                levels.push_back(std::move(level));
+            }
+        } else {
+            LevelData level;
+            std::string error;
+            if (LevelLoader::loadLevelFile(input, level, &error)) {
+                levels.push_back(std::move(level));
+            } else {
+                std::cerr << "Error: " << error << std::endl;
+                ok = false;
+            }
+        }
+    }
+
+    if (!ok) {
+        return 1;
+    }
+    if (levels.empty()) {
+        std::cerr << "Error: no levels to pack" << std::endl;
+        return 1;
+    }
+
+    std::string error;
+    if (!LevelPack::write(argv[1], levels, &error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    for (const auto& level : levels) {
+        std::cout << level.name << ": " << level.tiles.width() << "x" << level.tiles.height()
+                  << ", " << level.energyDots << " dots, " << level.powerPellets << " pellets, "
+                  << level.monsterStarts.size() << " monsters" << std::endl;
+    }
+    std::cout << "Wrote " << levels.size() << " level(s) to " << argv[1] << std::endl;
+    return 0;
+}
@@ -0,0 +1,43 @@
+// maze_generator.cpp
+// Write a procedurally generated level as a .lvl file (see map/MazeGenerator.h)
+//
+// Usage:
+//     maze_generator <out.lvl> <width> <height> [seed] [loopDensity] [ghostHouses]
+//
+// The same arguments always produce the same file.
+#include "map/LevelLoader.h"
+#include "map/MazeGenerator.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <out.lvl> <width> <height> [seed] [loopDensity] [ghostHouses]" << std::endl;
+        return 1;
+    }
+
+    MazeConfig config;
+    config.width = std::atoi(argv[2]);
+    config.height = std::atoi(argv[3]);
+    if (argc > 4) config.seed = std::strtoull(argv[4], nullptr, 10);
+    if (argc > 5) config.loopDensity = std::atof(argv[5]);
+    if (argc > 6) config.ghostHouses = std::atoi(argv[6]);
+
+    LevelData level;
+    std::string error;
+    if (!MazeGenerator::generate(config, level, &error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+    if (!LevelLoader::saveLevelFile(argv[1], level)) {
+        std::cerr << "Error: cannot write " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::cout << level.name << ": " << level.tiles.width() << "x" << level.tiles.height()
+              << ", " << level.energyDots << " dots, " << level.powerPellets << " pellets, "
+              << level.monsterStarts.size() << " monsters" << std::endl;
+    return 0;
+}